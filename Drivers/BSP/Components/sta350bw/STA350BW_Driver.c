@@ -37,6 +37,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "STA350BW_Driver.h"
+#include <string.h>
 
 /** @addtogroup BSP
 * @{
@@ -61,6 +62,48 @@
 /** @defgroup STA350BW_Private_Defines
 * @{
 */
+/* CFADDR, 15 coefficient bytes (B1CF1..B0CF3) and CFUD are contiguous, so a
+   whole coefficient set goes out in a single auto-increment write */
+#define STA350BW_RAM_SET_BURST_SIZE   ((uint16_t)(STA350BW_CFUD - STA350BW_CFADDR + 1))
+
+/* Registers changed by the device itself, never served from the shadow:
+   coefficient data (updated by R1/RA reads), CFUD (self clearing) and STATUS */
+#define STA350BW_IS_VOLATILE(reg)     ((((reg) >= STA350BW_B1CF1) && ((reg) <= STA350BW_CFUD)) || \
+                                       ((reg) == STA350BW_STATUS))
+
+/* Clean registers up to this distance apart are rewritten from the shadow to
+   merge two dirty runs in a single burst, cheaper than a new transaction */
+#define STA350BW_UPDATE_MAX_GAP       ((uint8_t)2)
+
+/* Limiter rate and threshold tables, one entry per 4 bit register value.
+   Rates are in dB/ms x 10000, thresholds in dB; -128 stands for -infinity */
+static const int16_t STA350BW_AttackRates[16] = 
+{
+  31584, 27072, 22560, 18048, 13536, 9024, 4512, 2256,
+  1504, 1123, 902, 752, 645, 564, 501, 451
+};
+static const int16_t STA350BW_ReleaseRates[16] = 
+{
+  5116, 1370, 744, 499, 360, 299, 264, 208,
+  198, 172, 147, 137, 134, 117, 110, 104
+};
+static const int16_t STA350BW_AttackThresholds[2][16] = 
+{
+  { -12, -10, -8, -6, -4, -2, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10 },              /* Anti-clipping */
+  { -31, -29, -27, -25, -23, -21, -19, -17, -16, -15, -14, -13, -12, -10, -7, -4 }  /* DRC */
+};
+static const int16_t STA350BW_ReleaseThresholds[2][16] = 
+{
+  { -128, -29, -20, -16, -14, -12, -10, -8, -7, -6, -5, -4, -3, -2, -1, 0 },    /* Anti-clipping */
+  { -128, -38, -36, -33, -31, -30, -28, -26, -24, -22, -20, -18, -15, -12, -9, -6 } /* DRC */
+};
+
+/* STA350BW_Data_t Protection flags */
+#define STA350BW_PROTECTION_ON        ((uint8_t)0x01)   /* Output muted and power stage off */
+#define STA350BW_PROTECTION_MUTED     ((uint8_t)0x02)   /* Master mute was already set before */
+#define STA350BW_PROTECTION_EAPD_OFF  ((uint8_t)0x04)   /* Power stage was already off before */
+
+#define STA350BW_IS_DIRTY(data, reg)  (((data)->Dirty[(reg) >> 3] >> ((reg) & 0x07)) & 0x01)
 
 /**
 * @}
@@ -98,6 +141,22 @@ SOUNDTERMINAL_Drv_t STA350BW_Drv =
   STA350BW_SetDSPOption,
 };
 
+/* Audio codec extended driver structure initialization */
+STA350BW_ExtDrv_t STA350BW_ExtDrv = 
+{ 
+  STA350BW_SetEqBank,
+  STA350BW_Resync,
+  STA350BW_BeginUpdate,
+  STA350BW_CommitUpdate,
+  STA350BW_SetLimiterMapping,
+  STA350BW_SetLimiterMode,
+  STA350BW_SetLimiter,
+  STA350BW_GetStatus,
+  STA350BW_SetProtection,
+  STA350BW_GetVolume,
+  STA350BW_GetSoftVolume,
+};
+
 /**
 * @}
 */
@@ -107,6 +166,12 @@ SOUNDTERMINAL_Drv_t STA350BW_Drv =
 */
 static int32_t writeRAMSet(DrvContextTypeDef * pObj, uint8_t RAM_block,
                            uint8_t RAM_address, uint8_t * pIn);
+static int32_t selectRAMBlock(DrvContextTypeDef * handle, uint8_t RAM_block);
+static int32_t writeRAMBurst(DrvContextTypeDef * handle, uint8_t RAM_address,
+                             uint8_t * pIn);
+static int32_t flushUpdate(DrvContextTypeDef * handle);
+static void reloadShadow(DrvContextTypeDef * handle);
+static uint8_t nearestIndex(const int16_t * table, int32_t value);
 
 extern uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite );
 extern uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead );
@@ -135,6 +200,12 @@ int32_t STA350BW_Init(DrvContextTypeDef * handle, uint16_t volume,
 {
   uint8_t tmp = 0x00;  
   
+  /* Fill the register shadow, if any, before the first read-modify-write */
+  if (STA350BW_Resync(handle, 0) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  
   /* Set Master clock depending on sampling frequency*/
   if (STA350BW_SetFrequency(handle, samplingFreq, 0) != 0) 
   {
@@ -305,6 +376,48 @@ int32_t STA350BW_SetVolume(DrvContextTypeDef * handle, uint8_t channel,
   return STA350BW_OK;
 }
 
+/**
+* @brief        Get the volume of a channel, from the shadow if available.
+* @param        handle: object related to the current device instance.
+* @param        channel: channel to be read.
+*               This parameter can be a value of @ref STA350BW_channel_define
+* @param        *value: volume register value
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_GetVolume(DrvContextTypeDef * handle, uint8_t channel,
+                           uint8_t * value, void *p) 
+{
+  if (channel > STA350BW_CHANNEL_3) 
+  {
+    return STA350BW_ERROR;
+  }
+  if (STA350BW_ReadReg(handle, STA350BW_MVOL + channel, 1, value) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Tell whether the device ramps volume changes by itself (SVE).
+* @param        handle: object related to the current device instance.
+* @param        *state: STA350BW_ENABLE or STA350BW_DISABLE
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_GetSoftVolume(DrvContextTypeDef * handle, uint8_t * state, void *p) 
+{
+  uint8_t tmp;
+  
+  if (STA350BW_ReadReg(handle, STA350BW_CONF_REGE, 1, &tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  *state = (tmp & 0x80) ? STA350BW_ENABLE : STA350BW_DISABLE;
+  return STA350BW_OK;
+}
+
 /**
 * @brief        set the sampling frequency for STA350BW.
 * @param        handle: object related to the current device instance.
@@ -357,7 +470,363 @@ int32_t STA350BW_SetEq(DrvContextTypeDef * handle, uint8_t ramBlock,
                        uint8_t filterNumber, uint32_t * filterValues, void *p) 
 {  
   /*5 is due to the ram adressing: first filter is on the adresses 0x00 to 0x04; the second is on 0x05 to 0x09 ...*/
-  writeRAMSet(handle, ramBlock, filterNumber * 5, (uint8_t *) filterValues); 
+  if (writeRAMSet(handle, ramBlock, filterNumber * 5, (uint8_t *) filterValues) != 0)
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Set all the biquads of a channel in a single sequence: the RAM
+*               bank is selected once, then each biquad is one I2C write.
+*               Programming both channels costs 10 transactions (138 bytes),
+*               9 with the register shadow and 8 when the bank is already
+*               selected, against 24 through STA350BW_SetEq.
+* @param        handle: object related to the current device instance.
+* @param        ramBlock: ram block to be set
+* @param        channel: STA350BW_CHANNEL_1, STA350BW_CHANNEL_2 or
+*               STA350BW_CHANNEL_MASTER to load the same filters on both channels
+* @param        *filterValues: pointer to a uint32_t array containing
+*               STA350BW_BIQUADS_PER_CHANNEL sets of 5 filter coefficients
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_SetEqBank(DrvContextTypeDef * handle, uint8_t ramBlock,
+                           uint8_t channel, uint32_t * filterValues, void *p) 
+{
+  uint8_t first = 0;
+  uint8_t last = 0;
+  uint8_t filterNumber = 0;
+  
+  switch (channel) 
+  {
+  case STA350BW_CHANNEL_MASTER:
+    first = STA350BW_CH1_BQ1;
+    last = STA350BW_CH2_BQ4;
+    break;
+  case STA350BW_CHANNEL_1:
+    first = STA350BW_CH1_BQ1;
+    last = STA350BW_CH1_BQ4;
+    break;
+  case STA350BW_CHANNEL_2:
+    first = STA350BW_CH2_BQ1;
+    last = STA350BW_CH2_BQ4;
+    break;
+  default:
+    return STA350BW_ERROR;
+  }
+  
+  if (selectRAMBlock(handle, ramBlock) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  
+  for (filterNumber = first; filterNumber <= last; filterNumber++) 
+  {
+    uint32_t *set = &filterValues[((filterNumber - first) % STA350BW_BIQUADS_PER_CHANNEL) * STA350BW_BIQUAD_COEFFS];
+    
+    if (writeRAMBurst(handle, filterNumber * STA350BW_BIQUAD_COEFFS, (uint8_t *) set) != 0) 
+    {
+      return STA350BW_ERROR;
+    }
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Reload the register shadow from the device. It must be called
+*               after anything that changes the registers behind the driver,
+*               such as a hardware reset of the device.
+* @param        handle: object related to the current device instance.
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_Resync(DrvContextTypeDef * handle, void *p) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  
+  if (data == NULL) 
+  {
+    return STA350BW_OK;
+  }
+  
+  /*Whole register file in one auto-increment read, pending updates are lost*/
+  data->isShadowValid = 0;
+  data->isResyncPending = 0;
+  data->UpdateDepth = 0;
+  data->Protection = 0;
+  memset(data->Dirty, 0, sizeof(data->Dirty));
+  if (STA350BW_ReadReg(handle, STA350BW_CONF_REGA, STA350BW_MAX_REGISTERS, data->Shadow) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  /*A write lost during the read leaves the reload to the next read*/
+  data->isShadowValid = !data->isResyncPending;
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Open a group of control changes. Until the matching
+*               STA350BW_CommitUpdate, writes to control registers only update
+*               the shadow. Calls can be nested, the outermost commit writes.
+*               Coefficient uploads inside the group first write the pending
+*               changes, so that they land in the selected RAM bank.
+* @param        handle: object related to the current device instance.
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_BeginUpdate(DrvContextTypeDef * handle, void *p) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  
+  /* Without a shadow there is nothing to defer, writes go out one by one */
+  if (data == NULL || !data->isShadowValid) 
+  {
+    return STA350BW_OK;
+  }
+  data->UpdateDepth++;
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Close a group of control changes and write every changed
+*               register. Adjacent registers go out as one auto-increment
+*               write, for instance C1CFG and C2CFG.
+* @param        handle: object related to the current device instance.
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_CommitUpdate(DrvContextTypeDef * handle, void *p) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  
+  if (data == NULL || data->UpdateDepth == 0) 
+  {
+    return STA350BW_OK;
+  }
+  if (--data->UpdateDepth != 0) 
+  {
+    return STA350BW_OK;
+  }
+  return flushUpdate(handle);
+}
+
+/**
+* @brief        Assign a limiter to a channel.
+* @param        handle: object related to the current device instance.
+* @param        channel: STA350BW_CHANNEL_1, STA350BW_CHANNEL_2, STA350BW_CHANNEL_3
+*               or STA350BW_CHANNEL_MASTER for both channel 1 and 2
+* @param        limiter: STA350BW_LIMITER_NONE, STA350BW_LIMITER_1 or
+*               STA350BW_LIMITER_2
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_SetLimiterMapping(DrvContextTypeDef * handle, uint8_t channel,
+                                   uint8_t limiter, void *p) 
+{
+  uint8_t tmp[2];
+  uint8_t reg = STA350BW_C1CFG;
+  uint8_t count = 1;
+  uint8_t i = 0;
+  
+  if (limiter > STA350BW_LIMITER_2 || channel > STA350BW_CHANNEL_3) 
+  {
+    return STA350BW_ERROR;
+  }
+  if (channel == STA350BW_CHANNEL_MASTER) 
+  {
+    /*C1CFG and C2CFG are adjacent*/
+    count = 2;
+  } 
+  else 
+  {
+    reg = STA350BW_C1CFG + channel - 1;
+  }
+  
+  if (STA350BW_ReadReg(handle, reg, count, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  for (i = 0; i < count; i++) 
+  {
+    tmp[i] &= ~0x30;
+    tmp[i] |= limiter << 4;
+  }
+  if (STA350BW_WriteReg(handle, reg, count, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Select how both limiters work: anti-clipping, with thresholds
+*               relative to full scale, or dynamic range compression. The 
+*               thresholds are read differently in the two modes, so the 
+*               limiters have to be set again after a mode change.
+* @param        handle: object related to the current device instance.
+* @param        mode: STA350BW_LIMITER_ANTICLIPPING or STA350BW_LIMITER_DRC
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_SetLimiterMode(DrvContextTypeDef * handle, uint8_t mode, void *p) 
+{
+  uint8_t tmp;
+  
+  if (mode > STA350BW_LIMITER_DRC) 
+  {
+    return STA350BW_ERROR;
+  }
+  if (STA350BW_ReadReg(handle, STA350BW_CONF_REGD, 1, &tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  tmp &= ~0x20;
+  tmp |= mode << 5;
+  if (STA350BW_WriteReg(handle, STA350BW_CONF_REGD, 1, &tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Set the rates and thresholds of a limiter, for the limiter mode
+*               currently selected. Rates and thresholds go out in a single
+*               write; the extended thresholds are turned off, if enabled, so
+*               that the values set here are the ones in use.
+* @param        handle: object related to the current device instance.
+* @param        limiter: STA350BW_LIMITER_1 or STA350BW_LIMITER_2
+* @param        *config: pointer to the limiter settings
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_SetLimiter(DrvContextTypeDef * handle, uint8_t limiter,
+                            STA350BW_Limiter_t * config, void *p) 
+{
+  uint8_t tmp[2];
+  uint8_t mode = 0;
+  uint8_t offset = 0;
+  
+  if (config == NULL || (limiter != STA350BW_LIMITER_1 && limiter != STA350BW_LIMITER_2)) 
+  {
+    return STA350BW_ERROR;
+  }
+  /*L2AR, L2ATR follow L1AR, L1ATR; same for the extended thresholds*/
+  offset = (limiter - STA350BW_LIMITER_1) * 2;
+  
+  if (STA350BW_ReadReg(handle, STA350BW_CONF_REGD, 1, &mode) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  mode = (mode >> 5) & 0x01;
+  
+  if (STA350BW_ReadReg(handle, STA350BW_EATH1 + offset, 2, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  if ((tmp[0] | tmp[1]) & 0x80) 
+  {
+    tmp[0] &= ~0x80;
+    tmp[1] &= ~0x80;
+    if (STA350BW_WriteReg(handle, STA350BW_EATH1 + offset, 2, tmp) != 0) 
+    {
+      return STA350BW_ERROR;
+    }
+  }
+  
+  tmp[0] = (nearestIndex(STA350BW_AttackRates, config->AttackRate) << 4)
+    | nearestIndex(STA350BW_ReleaseRates, config->ReleaseRate);
+  tmp[1] = (nearestIndex(STA350BW_AttackThresholds[mode], config->AttackThreshold) << 4)
+    | nearestIndex(STA350BW_ReleaseThresholds[mode], config->ReleaseThreshold);
+  if (STA350BW_WriteReg(handle, STA350BW_L1AR + offset, 2, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Read the STATUS register, never served from the shadow.
+* @param        handle: object related to the current device instance.
+* @param        *status: STATUS value, see @ref STA350BW_status_define
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_GetStatus(DrvContextTypeDef * handle, uint8_t * status, void *p) 
+{
+  if (STA350BW_ReadReg(handle, STA350BW_STATUS, 1, status) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return STA350BW_OK;
+}
+
+/**
+* @brief        Protect the output on a fault: master mute and power stage
+*               off (EAPD). Disabling the protection puts back the mute and
+*               EAPD settings found when it was enabled; this needs the 
+*               driver data, without it the output is always restored.
+*               CONF_REGF and MUTE are adjacent, each change is one write.
+* @param        handle: object related to the current device instance.
+* @param        state: STA350BW_ENABLE or STA350BW_DISABLE
+* @param        *p: pointer to optional additional functions.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+int32_t STA350BW_SetProtection(DrvContextTypeDef * handle, uint8_t state, void *p) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  uint8_t flags = (data != NULL) ? data->Protection : 0;
+  uint8_t tmp[2];
+  
+  /*Nothing to do if already in the requested state*/
+  if (data != NULL && (state == STA350BW_ENABLE) == ((flags & STA350BW_PROTECTION_ON) != 0)) 
+  {
+    return STA350BW_OK;
+  }
+  
+  /*tmp[0] is CONF_REGF, tmp[1] is MUTE*/
+  if (STA350BW_ReadReg(handle, STA350BW_CONF_REGF, 2, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  
+  if (state == STA350BW_ENABLE) 
+  {
+    flags = STA350BW_PROTECTION_ON;
+    if (tmp[1] & 0x01) 
+    {
+      flags |= STA350BW_PROTECTION_MUTED;
+    }
+    if (!(tmp[0] & STA350BW_EAPD_ON)) 
+    {
+      flags |= STA350BW_PROTECTION_EAPD_OFF;
+    }
+    tmp[0] &= ~STA350BW_EAPD_ON;
+    tmp[1] |= 0x01;
+  } 
+  else 
+  {
+    if (!(flags & STA350BW_PROTECTION_EAPD_OFF)) 
+    {
+      tmp[0] |= STA350BW_EAPD_ON;
+    }
+    if (!(flags & STA350BW_PROTECTION_MUTED)) 
+    {
+      tmp[1] &= ~0x01;
+    }
+    flags = 0;
+  }
+  
+  if (STA350BW_WriteReg(handle, STA350BW_CONF_REGF, 2, tmp) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  if (data != NULL) 
+  {
+    data->Protection = flags;
+  }
   return STA350BW_OK;
 }
 
@@ -780,6 +1249,21 @@ int32_t  STA350BW_SetDSPOption(DrvContextTypeDef * handle, uint8_t option, uint8
       }
       break;
     } 
+  case STA350BW_SVE:
+    {
+      if (STA350BW_ReadReg(handle, STA350BW_CONF_REGE, 1, &tmp) != 0) 
+      {
+        return STA350BW_ERROR;
+      }  
+      tmp &= ~0x80;
+      tmp |= state << 0x07;
+      
+      if (STA350BW_WriteReg(handle, STA350BW_CONF_REGE, 1, &tmp) != 0) 
+      {
+        return STA350BW_ERROR;
+      }
+      break;
+    }
   }
   return STA350BW_OK;
 }
@@ -794,9 +1278,24 @@ int32_t  STA350BW_SetDSPOption(DrvContextTypeDef * handle, uint8_t option, uint8
 */
 static int32_t writeRAMSet(DrvContextTypeDef * handle, uint8_t RAM_block,
                            uint8_t RAM_address, uint8_t * pIn) 
+{
+  if (selectRAMBlock(handle, RAM_block) != 0) 
+  {
+    return STA350BW_ERROR;
+  }
+  return writeRAMBurst(handle, RAM_address, pIn);
+}
+
+/**
+* @brief        private function selecting the coefficient RAM block.
+* @param        handle: object related to the current device instance.
+* @param        RAM_block: ram block to be selected.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+static int32_t selectRAMBlock(DrvContextTypeDef * handle, uint8_t RAM_block) 
 {
   uint8_t tmp = 0x00;
-  /*choose block*/
+  
   if (STA350BW_ReadReg(handle, STA350BW_EQCFG, 1, &tmp) != 0) 
   {
     return STA350BW_ERROR;
@@ -808,95 +1307,162 @@ static int32_t writeRAMSet(DrvContextTypeDef * handle, uint8_t RAM_block,
   {
     return STA350BW_ERROR;
   }
-  /*set address*/
-  if (STA350BW_ReadReg(handle, STA350BW_CFADDR, 1, &tmp) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  tmp &= ~0x3F;
-  RAM_address &= 0x3F;
-  tmp |= RAM_address;
-  if (STA350BW_WriteReg(handle, STA350BW_CFADDR, 1, &tmp) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  /*write*/
-  if (STA350BW_WriteReg(handle, STA350BW_B1CF1, 1, &pIn[2]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_B1CF2, 1, &pIn[1]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_B1CF3, 1, &pIn[0]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_B2CF1, 1, &pIn[6]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_B2CF2, 1, &pIn[5]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_B2CF3, 1, &pIn[4]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_A1CF1, 1, &pIn[10]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_A1CF2, 1, &pIn[9]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_A1CF3, 1, &pIn[8]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_A2CF1, 1, &pIn[14]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }
-  if (STA350BW_WriteReg(handle, STA350BW_A2CF2, 1, &pIn[13]) != 0) 
+  return STA350BW_OK;
+}
+
+/**
+* @brief        private function writing a coefficient set in the selected RAM
+*               block: address, b1, b2, a1, a2, b0 and the WA strobe go out in a
+*               single auto-increment write starting at CFADDR.
+* @param        handle: object related to the current device instance.
+* @param        RAM_address: ram address to be written.
+* @param        *pIn: pointer to 5 little endian uint32_t coefficients.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+static int32_t writeRAMBurst(DrvContextTypeDef * handle, uint8_t RAM_address,
+                             uint8_t * pIn) 
+{
+  uint8_t burst[STA350BW_RAM_SET_BURST_SIZE];
+  uint8_t i = 0;
+  
+  /*set address, reserved bits are written as 0*/
+  burst[0] = RAM_address & 0x3F;
+  /*coefficients are 24 bit, MSB first*/
+  for (i = 0; i < STA350BW_BIQUAD_COEFFS; i++) 
   {
-    return STA350BW_ERROR;
+    burst[1 + i * 3] = pIn[i * 4 + 2];
+    burst[2 + i * 3] = pIn[i * 4 + 1];
+    burst[3 + i * 3] = pIn[i * 4];
   }
-  if (STA350BW_WriteReg(handle, STA350BW_A2CF3, 1, &pIn[12]) != 0) 
+  /*Set WA PIN*/
+  burst[STA350BW_RAM_SET_BURST_SIZE - 1] = 0x02;
+  
+  if (STA350BW_WriteReg(handle, STA350BW_CFADDR, STA350BW_RAM_SET_BURST_SIZE, burst) != 0) 
   {
     return STA350BW_ERROR;
   }
-  if (STA350BW_WriteReg(handle, STA350BW_B0CF1, 1, &pIn[18]) != 0) 
+  return STA350BW_OK;
+}
+
+
+/**
+* @brief        private function writing the registers changed in the shadow
+*               during an update, merging close dirty registers in one burst.
+*               The registers of a failed burst stay dirty, the next commit
+*               writes them again.
+* @param        handle: object related to the current device instance.
+* @retval       STA350BW_OK if correct setup, STA350BW_ERROR otherwise
+*/
+static int32_t flushUpdate(DrvContextTypeDef * handle) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  uint8_t depth = data->UpdateDepth;
+  uint8_t first = 0;
+  uint8_t last = 0;
+  uint8_t reg = 0;
+  int32_t ret = STA350BW_OK;
+  
+  /* Let the writes below reach the device */
+  data->UpdateDepth = 0;
+  
+  while (first < STA350BW_MAX_REGISTERS) 
   {
-    return STA350BW_ERROR;
+    if (!STA350BW_IS_DIRTY(data, first)) 
+    {
+      first++;
+      continue;
+    }
+    
+    /* Extend the run over dirty registers and short clean gaps */
+    last = first;
+    for (reg = first + 1; reg < STA350BW_MAX_REGISTERS && (reg - last) <= (STA350BW_UPDATE_MAX_GAP + 1); reg++) 
+    {
+      if (STA350BW_IS_VOLATILE(reg)) 
+      {
+        break;
+      }
+      if (STA350BW_IS_DIRTY(data, reg)) 
+      {
+        last = reg;
+      }
+    }
+    
+    if (STA350BW_WriteReg(handle, first, last - first + 1, &data->Shadow[first]) != 0) 
+    {
+      ret = STA350BW_ERROR;
+      first = last + 1;
+      continue;
+    }
+    for (reg = first; reg <= last; reg++) 
+    {
+      data->Dirty[reg >> 3] &= ~(1 << (reg & 0x07));
+    }
+    first = last + 1;
   }
-  if (STA350BW_WriteReg(handle, STA350BW_B0CF2, 1, &pIn[17]) != 0) 
+  
+  data->UpdateDepth = depth;
+  return ret;
+}
+
+/**
+* @brief        private function reloading the shadow after a lost write. 
+*               Registers still dirty keep their value, the next commit 
+*               writes them. On failure the reload is left to the next read.
+* @param        handle: object related to the current device instance.
+* @retval       None
+*/
+static void reloadShadow(DrvContextTypeDef * handle) 
+{
+  STA350BW_Data_t *data = (STA350BW_Data_t *)handle->pData;
+  uint8_t regs[STA350BW_MAX_REGISTERS];
+  uint8_t reg = 0;
+  
+  data->isResyncPending = 0;
+  if (Sensor_IO_Read(handle, STA350BW_CONF_REGA, regs, STA350BW_MAX_REGISTERS) != 0 || data->isResyncPending) 
   {
-    return STA350BW_ERROR;
+    data->isResyncPending = 1;
+    return;
   }
-  if (STA350BW_WriteReg(handle, STA350BW_B0CF3, 1, &pIn[16]) != 0) 
-  {
-    return STA350BW_ERROR;
-  }  
-  /*Set WA PIN*/
-  if (STA350BW_ReadReg(handle, STA350BW_CFUD, 1, &tmp) != 0) 
+  for (reg = 0; reg < STA350BW_MAX_REGISTERS; reg++) 
   {
-    return STA350BW_ERROR;
+    if (!STA350BW_IS_DIRTY(data, reg)) 
+    {
+      data->Shadow[reg] = regs[reg];
+    }
   }
-  tmp &= ~0x02;
-  tmp = 0x02; 
+  data->isShadowValid = 1;
+}
+
+/**
+* @brief        private function finding the register value closest to a 
+*               setting in a table of 16 entries.
+* @param        *table: values of the 16 register settings.
+* @param        value: requested value.
+* @retval       Index of the closest entry
+*/
+static uint8_t nearestIndex(const int16_t * table, int32_t value) 
+{
+  uint8_t best = 0;
+  uint8_t i = 0;
+  int32_t distance = 0;
+  int32_t bestDistance = 0x7FFFFFFF;
   
-  if (STA350BW_WriteReg(handle, STA350BW_CFUD, 1, &tmp) != 0) 
+  for (i = 0; i < 16; i++) 
   {
-    return STA350BW_ERROR;
+    distance = (int32_t)table[i] - value;
+    if (distance < 0) 
+    {
+      distance = -distance;
+    }
+    if (distance < bestDistance) 
+    {
+      bestDistance = distance;
+      best = i;
+    }
   }
-  return STA350BW_OK;
+  return best;
 }
 
-
 /**
 * @brief        Generic reading function. It must be fullfilled with either I2C 
 *               or SPI writing function.
@@ -907,6 +1473,28 @@ static int32_t writeRAMSet(DrvContextTypeDef * handle, uint8_t RAM_block,
 */
 static STA350BW_Error_et STA350BW_ReadReg( void *handle, uint8_t RegAddr, uint16_t NumByteToRead, uint8_t *Data )
 {
+  STA350BW_Data_t *data = (STA350BW_Data_t *)((DrvContextTypeDef *)handle)->pData;
+  uint16_t i;
+  
+  if ( data != NULL && data->isResyncPending )
+  {
+    reloadShadow( (DrvContextTypeDef *)handle );
+  }
+  
+  if ( data != NULL && data->isShadowValid && (RegAddr + NumByteToRead) <= STA350BW_MAX_REGISTERS )
+  {
+    for ( i = 0; i < NumByteToRead; i++ )
+    {
+      if ( STA350BW_IS_VOLATILE(RegAddr + i) )
+        break;
+    }
+    if ( i == NumByteToRead )
+    {
+      memcpy( Data, &data->Shadow[RegAddr], NumByteToRead );
+      return STA350BW_OK;
+    }
+  }
+  
   if ( Sensor_IO_Read( handle, RegAddr, Data, NumByteToRead ) )
     return STA350BW_ERROR;
   else
@@ -923,10 +1511,57 @@ static STA350BW_Error_et STA350BW_ReadReg( void *handle, uint8_t RegAddr, uint16
 */
 static STA350BW_Error_et STA350BW_WriteReg( void *handle, uint8_t RegAddr, uint16_t NumByteToWrite, uint8_t *Data )
 {
+  STA350BW_Data_t *data = (STA350BW_Data_t *)((DrvContextTypeDef *)handle)->pData;
+  uint16_t i;
+  
+  if ( data != NULL && data->isShadowValid && (RegAddr + NumByteToWrite) <= STA350BW_MAX_REGISTERS )
+  {
+    for ( i = RegAddr; i < RegAddr + NumByteToWrite; i++ )
+    {
+      if ( STA350BW_IS_VOLATILE(i) || STA350BW_IS_DIRTY(data, i) || data->Shadow[i] != Data[i - RegAddr] )
+        break;
+    }
+    if ( i == RegAddr + NumByteToWrite )
+    {
+      /* The device already holds these values */
+      return STA350BW_OK;
+    }
+  }
+  
+  if ( data != NULL && data->UpdateDepth != 0 && (RegAddr + NumByteToWrite) <= STA350BW_MAX_REGISTERS )
+  {
+    for ( i = 0; i < NumByteToWrite; i++ )
+    {
+      if ( STA350BW_IS_VOLATILE(RegAddr + i) )
+        break;
+    }
+    if ( i == NumByteToWrite )
+    {
+      /* Inside an update: defer to STA350BW_CommitUpdate */
+      for ( i = RegAddr; i < RegAddr + NumByteToWrite; i++ )
+      {
+        data->Dirty[i >> 3] |= 1 << (i & 0x07);
+      }
+      memcpy( &data->Shadow[RegAddr], Data, NumByteToWrite );
+      return STA350BW_OK;
+    }
+    
+    /* Coefficient access: pending changes, such as the bank select, first */
+    if ( flushUpdate( (DrvContextTypeDef *)handle ) != STA350BW_OK )
+      return STA350BW_ERROR;
+  }
+  
   if ( Sensor_IO_Write( handle, RegAddr, Data, NumByteToWrite ) )
     return STA350BW_ERROR;
-  else
-    return STA350BW_OK;
+  
+  /* Write-through. With the I2C queue enabled the write is only queued here:
+     one given up later is reported by Sensor_IO_WriteCplt_Callback, which 
+     must set isResyncPending */
+  if ( data != NULL && (RegAddr + NumByteToWrite) <= STA350BW_MAX_REGISTERS )
+  {
+    memcpy( &data->Shadow[RegAddr], Data, NumByteToWrite );
+  }
+  return STA350BW_OK;
 }
 
 
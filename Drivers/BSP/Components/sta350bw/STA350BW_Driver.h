@@ -919,6 +919,7 @@ extern "C" {
 #define         STA350BW_EXT_RANGE_BQ6                 ((uint8_t)0x12)
 #define         STA350BW_EXT_RANGE_BQ7                 ((uint8_t)0x13)
 #define         STA350BW_RAM_BANK_SELECT               ((uint8_t)0x14)
+#define         STA350BW_SVE                           ((uint8_t)0x15)
   /**
   * @}
   */
@@ -964,7 +965,43 @@ extern "C" {
 #define       STA350BW_CH2_BQ2                                    ((uint8_t)0x05)
 #define       STA350BW_CH2_BQ3                                    ((uint8_t)0x06)
 #define       STA350BW_CH2_BQ4                                    ((uint8_t)0x07)
+#define       STA350BW_BIQUADS_PER_CHANNEL                        ((uint8_t)0x04)
+#define       STA350BW_BIQUAD_COEFFS                              ((uint8_t)0x05)
 
+  /**
+  * @}
+  */
+  
+  /** @defgroup STA350BW_limiter_define STA350BW limiter define
+  * @brief STA350BW limiter definitions
+  * @{
+  */  
+#define       STA350BW_LIMITER_NONE                               ((uint8_t)0x00)
+#define       STA350BW_LIMITER_1                                  ((uint8_t)0x01)
+#define       STA350BW_LIMITER_2                                  ((uint8_t)0x02)
+#define       STA350BW_LIMITER_ANTICLIPPING                       ((uint8_t)0x00)
+#define       STA350BW_LIMITER_DRC                                ((uint8_t)0x01)
+#define       STA350BW_THRESHOLD_OFF                              ((int8_t)-128)
+  /**
+  * @}
+  */
+  
+  /** @defgroup STA350BW_status_define STA350BW status define
+  * @brief STA350BW STATUS register bits. Fault and warning bits are active
+  *        low, PLLUL is active high.
+  * @{
+  */  
+#define       STA350BW_STATUS_OK                                  ((uint8_t)0x7F)
+#define       STA350BW_STATUS_PLLUL                               ((uint8_t)0x80)
+#define       STA350BW_STATUS_FAULT                               ((uint8_t)0x40)
+#define       STA350BW_STATUS_UVFAULT                             ((uint8_t)0x20)
+#define       STA350BW_STATUS_OVFAULT                             ((uint8_t)0x10)
+#define       STA350BW_STATUS_OCFAULT                             ((uint8_t)0x08)
+#define       STA350BW_STATUS_OCWARN                              ((uint8_t)0x04)
+#define       STA350BW_STATUS_TFAULT                              ((uint8_t)0x02)
+#define       STA350BW_STATUS_TWARN                               ((uint8_t)0x01)
+#define       STA350BW_STATUS_FAULTS                              ((uint8_t)0x7A)
+#define       STA350BW_STATUS_WARNINGS                            ((uint8_t)0x05)
   
   
   
@@ -991,6 +1028,59 @@ extern "C" {
 } 
 STA350BW_Error_et;
   
+  /** 
+  * @brief  STA350BW limiter settings. The device supports 16 values for each
+  *         field, the nearest one is programmed. Thresholds are in dB and
+  *         their range depends on the limiter mode: -12..+10 dB (attack) and
+  *         -29..0 dB (release) in anti-clipping mode, -31..-4 dB (attack)
+  *         and -38..-6 dB (release) in DRC mode.
+  */ 
+  typedef struct
+  {
+    uint16_t       AttackRate;          /* dB/ms x 10000, 451..31584 */
+    uint16_t       ReleaseRate;         /* dB/ms x 10000, 104..5116 */
+    int8_t         AttackThreshold;     /* dB */
+    int8_t         ReleaseThreshold;    /* dB, STA350BW_THRESHOLD_OFF never releases */
+  }STA350BW_Limiter_t;
+  
+  /** 
+  * @brief  STA350BW extended driver structure definition, reachable through
+  *         the pExtVTable field of the component context.
+  */ 
+  typedef struct
+  {
+    int32_t        (*SetEqBank)(DrvContextTypeDef *, uint8_t, uint8_t, uint32_t *, void *p);
+    int32_t        (*Resync)(DrvContextTypeDef *, void *p);
+    int32_t        (*BeginUpdate)(DrvContextTypeDef *, void *p);
+    int32_t        (*CommitUpdate)(DrvContextTypeDef *, void *p);
+    int32_t        (*SetLimiterMapping)(DrvContextTypeDef *, uint8_t, uint8_t, void *p);
+    int32_t        (*SetLimiterMode)(DrvContextTypeDef *, uint8_t, void *p);
+    int32_t        (*SetLimiter)(DrvContextTypeDef *, uint8_t, STA350BW_Limiter_t *, void *p);
+    int32_t        (*GetStatus)(DrvContextTypeDef *, uint8_t *, void *p);
+    int32_t        (*SetProtection)(DrvContextTypeDef *, uint8_t, void *p);
+    int32_t        (*GetVolume)(DrvContextTypeDef *, uint8_t, uint8_t *, void *p);
+    int32_t        (*GetSoftVolume)(DrvContextTypeDef *, uint8_t *, void *p);
+  }STA350BW_ExtDrv_t;
+  
+  /** 
+  * @brief  STA350BW component data, reachable through the pData field of the
+  *         component context. When provided, the driver keeps a write-through
+  *         shadow of the register file and serves read-modify-write cycles
+  *         from it instead of reading the device. A write lost after it was 
+  *         accepted, by an asynchronous bus, is reported by clearing 
+  *         isShadowValid and setting isResyncPending: the next register read 
+  *         reloads the shadow first.
+  */ 
+  typedef struct
+  {
+    uint8_t        isShadowValid;
+    uint8_t        isResyncPending;                           /* Reload the shadow at the next read */
+    uint8_t        Shadow[STA350BW_MAX_REGISTERS];
+    uint8_t        UpdateDepth;                               /* Nested BeginUpdate calls */
+    uint8_t        Dirty[(STA350BW_MAX_REGISTERS + 7) / 8];   /* Registers written in the shadow only */
+    uint8_t        Protection;                                /* STA350BW_PROTECTION_xxx flags */
+  }STA350BW_Data_t;
+  
   
   
   
@@ -1015,10 +1105,24 @@ STA350BW_Error_et;
   int32_t STA350BW_SetVolume(DrvContextTypeDef * handle, uint8_t channel, uint8_t value, void *p);
   int32_t STA350BW_SetFrequency(DrvContextTypeDef * handle, uint32_t AudioFreq, void *p);
   int32_t STA350BW_SetDSPOption(DrvContextTypeDef * handle, uint8_t option, uint8_t state, void *p);
+  int32_t STA350BW_SetEqBank(DrvContextTypeDef * handle, uint8_t ramBlock, uint8_t channel, uint32_t * filterValues, void *p);
+  int32_t STA350BW_Resync(DrvContextTypeDef * handle, void *p);
+  int32_t STA350BW_BeginUpdate(DrvContextTypeDef * handle, void *p);
+  int32_t STA350BW_CommitUpdate(DrvContextTypeDef * handle, void *p);
+  int32_t STA350BW_SetLimiterMapping(DrvContextTypeDef * handle, uint8_t channel, uint8_t limiter, void *p);
+  int32_t STA350BW_SetLimiterMode(DrvContextTypeDef * handle, uint8_t mode, void *p);
+  int32_t STA350BW_SetLimiter(DrvContextTypeDef * handle, uint8_t limiter, STA350BW_Limiter_t * config, void *p);
+  int32_t STA350BW_GetStatus(DrvContextTypeDef * handle, uint8_t * status, void *p);
+  int32_t STA350BW_SetProtection(DrvContextTypeDef * handle, uint8_t state, void *p);
+  int32_t STA350BW_GetVolume(DrvContextTypeDef * handle, uint8_t channel, uint8_t * value, void *p);
+  int32_t STA350BW_GetSoftVolume(DrvContextTypeDef * handle, uint8_t * state, void *p);
 
   /* Audio processor driver structure */
   extern SOUNDTERMINAL_Drv_t STA350BW_Drv;
   
+  /* Audio processor extended driver structure */
+  extern STA350BW_ExtDrv_t STA350BW_ExtDrv;
+  
   /**
   * @}
   */
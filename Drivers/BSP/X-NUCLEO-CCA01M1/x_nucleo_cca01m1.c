@@ -60,7 +60,32 @@
 
 static uint32_t I2C_EXPBD_Timeout =
   NUCLEO_I2C_EXPBD_TIMEOUT_MAX;    /*<! Value of Timeout when I2C communication fails */
-static I2C_HandleTypeDef I2C_EXPBD_Handle;
+I2C_HandleTypeDef I2C_EXPBD_Handle;
+
+/* Asynchronous write queue: a ring of register writes sent one after the other
+   by interrupt driven transfers. Entry I2C_EXPBD_QHead is on the bus while
+   I2C_EXPBD_TxBusy is set and must not be touched. When it fails the queue
+   stalls with I2C_EXPBD_Stalled set, and the recovery and the retry are left
+   to Sensor_IO_Task, out of interrupt context. */
+typedef struct
+{
+  uint8_t Addr;
+  uint8_t Reg;
+  uint8_t Size;
+  uint8_t Retries;
+  uint8_t Data[NUCLEO_I2C_EXPBD_QUEUE_DATA_SIZE];
+} I2C_EXPBD_Cmd_t;
+
+static I2C_EXPBD_Cmd_t I2C_EXPBD_Queue[NUCLEO_I2C_EXPBD_QUEUE_DEPTH];
+static __IO uint8_t I2C_EXPBD_QHead = 0;
+static __IO uint8_t I2C_EXPBD_QCount = 0;
+static __IO uint8_t I2C_EXPBD_TxBusy = 0;
+static __IO uint8_t I2C_EXPBD_Blocking = 0;
+static __IO uint8_t I2C_EXPBD_Stalled = 0;
+static __IO uint8_t I2C_EXPBD_RecoverPending = 0;
+static uint8_t I2C_EXPBD_QueueEnabled = 0;
+static Sensor_IO_QueueStatsTypeDef I2C_EXPBD_Stats;
+static Sensor_IO_BusStatsTypeDef I2C_EXPBD_BusStats;
 
 /**
  * @}
@@ -71,10 +96,19 @@ uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint
 uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead );
 
 static void I2C_EXPBD_MspInit( void );
-static void I2C_EXPBD_Error( uint8_t Addr );
+static uint8_t I2C_EXPBD_Error( uint8_t Addr, uint8_t Attempt );
+static void I2C_EXPBD_Recover( void );
+static void I2C_EXPBD_PinsConfig( uint32_t Mode );
+static void I2C_EXPBD_Delay( void );
 static uint8_t I2C_EXPBD_ReadData( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer, uint16_t Size );
 static uint8_t I2C_EXPBD_WriteData( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer, uint16_t Size );
 static uint8_t I2C_EXPBD_Init( void );
+static uint8_t I2C_EXPBD_Enqueue( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer, uint16_t Size );
+static void I2C_EXPBD_Kick( void );
+static void I2C_EXPBD_TxDone( uint8_t Status );
+static void I2C_EXPBD_Service( void );
+static uint8_t I2C_EXPBD_BeginBlocking( void );
+static void I2C_EXPBD_EndBlocking( void );
 
 /** @addtogroup X_NUCLEO_CCA01M1_IO_Public_Functions Public functions
  * @{
@@ -99,6 +133,107 @@ DrvStatusTypeDef Sensor_IO_Init( void )
   }
 }
 
+/**
+ * @brief  Enables or disables the asynchronous write queue. While enabled,
+ *         Sensor_IO_Write() queues the write and returns at once, so that
+ *         control calls can be made from interrupt context without waiting
+ *         for the bus. Consecutive single byte writes to the same register
+ *         are coalesced, only the last value is sent. Multi byte writes are
+ *         sent as they are and keep their order with respect to every other
+ *         write. Sensor_IO_Read() waits for the queue to drain first.
+ * @param  Enable 1 to enable the queue, 0 to drain and disable it
+ * @retval COMPONENT_OK in case of success
+ * @retval COMPONENT_ERROR in case of failure
+ */
+DrvStatusTypeDef Sensor_IO_EnableQueue( uint8_t Enable )
+{
+  if ( Enable == 0 && Sensor_IO_Flush() != COMPONENT_OK )
+  {
+    return COMPONENT_ERROR;
+  }
+  I2C_EXPBD_QueueEnabled = Enable;
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief  Waits until every queued write has been sent. From interrupt
+ *         context it does not wait, as the I2C interrupt could not be
+ *         served, and only reports whether the queue is empty.
+ * @param  None
+ * @retval COMPONENT_OK if the queue is empty
+ * @retval COMPONENT_ERROR in case of timeout or if called from interrupt
+ *         context with writes still pending
+ */
+DrvStatusTypeDef Sensor_IO_Flush( void )
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while ( I2C_EXPBD_QCount != 0 || I2C_EXPBD_TxBusy )
+  {
+    if ( __get_IPSR() != 0 || (HAL_GetTick() - tickstart) > I2C_EXPBD_Timeout )
+    {
+      return COMPONENT_ERROR;
+    }
+    I2C_EXPBD_Service();
+  }
+  return COMPONENT_OK;
+}
+
+/**
+ * @brief  Recovers the bus and retries a failed queued write, to be called
+ *         from the main loop. The bit-banged recovery and the peripheral
+ *         re-initialization are never run from interrupt context, where they
+ *         would hold up the audio interrupts.
+ *         It also starts a write queued with interrupts disabled.
+ * @param  None
+ * @retval None
+ */
+void Sensor_IO_Task( void )
+{
+  I2C_EXPBD_Service();
+}
+
+/**
+ * @brief  Returns the asynchronous write queue counters.
+ * @param  Stats pointer to the counters to be filled
+ * @retval None
+ */
+void Sensor_IO_GetQueueStats( Sensor_IO_QueueStatsTypeDef *Stats )
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *Stats = I2C_EXPBD_Stats;
+  Stats->Pending = I2C_EXPBD_QCount;
+  __set_PRIMASK( primask );
+}
+
+/**
+ * @brief  Returns the bus error and recovery counters.
+ * @param  Stats pointer to the counters to be filled
+ * @retval None
+ */
+void Sensor_IO_GetBusStats( Sensor_IO_BusStatsTypeDef *Stats )
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *Stats = I2C_EXPBD_BusStats;
+  __set_PRIMASK( primask );
+}
+
+/**
+ * @brief  Called when a queued write is over: from the I2C interrupt once it
+ *         is acknowledged, from Sensor_IO_Task once its retries ran out.
+ * @param  Addr device address on BUS
+ * @param  Reg first register written
+ * @param  Status 0 if the device acknowledged the write, 1 otherwise
+ * @retval None
+ */
+__weak void Sensor_IO_WriteCplt_Callback( uint8_t Addr, uint8_t Reg, uint8_t Status )
+{
+}
+
 /**
  * @}
  */
@@ -125,16 +260,23 @@ DrvStatusTypeDef Sensor_IO_Init( void )
 uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite )
 {
   DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  uint8_t ret;
 
-  /* call I2C_EXPBD Read data bus function */
-  if ( I2C_EXPBD_WriteData( ctx->address, WriteAddr, pBuffer, nBytesToWrite ) )
+  if ( I2C_EXPBD_QueueEnabled && nBytesToWrite <= NUCLEO_I2C_EXPBD_QUEUE_DATA_SIZE )
   {
-    return 1;
+    return I2C_EXPBD_Enqueue( ctx->address, WriteAddr, pBuffer, nBytesToWrite );
   }
-  else
+
+  if ( I2C_EXPBD_BeginBlocking() )
   {
-    return 0;
+    return 1;
   }
+
+  /* call I2C_EXPBD Read data bus function */
+  ret = I2C_EXPBD_WriteData( ctx->address, WriteAddr, pBuffer, nBytesToWrite );
+
+  I2C_EXPBD_EndBlocking();
+  return ret;
 }
 
 
@@ -151,16 +293,18 @@ uint8_t Sensor_IO_Write( void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint
 uint8_t Sensor_IO_Read( void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead )
 {
   DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  uint8_t ret;
 
-  /* call I2C_EXPBD Read data bus function */
-  if ( I2C_EXPBD_ReadData( ctx->address, ReadAddr, pBuffer, nBytesToRead ) )
+  if ( I2C_EXPBD_BeginBlocking() )
   {
     return 1;
   }
-  else
-  {
-    return 0;
-  }
+
+  /* call I2C_EXPBD Read data bus function */
+  ret = I2C_EXPBD_ReadData( ctx->address, ReadAddr, pBuffer, nBytesToRead );
+
+  I2C_EXPBD_EndBlocking();
+  return ret;
 }
 
 
@@ -226,21 +370,24 @@ static uint8_t I2C_EXPBD_WriteData( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer,
 {
 
   HAL_StatusTypeDef status = HAL_OK;
+  uint8_t attempt;
 
-  status = HAL_I2C_Mem_Write( &I2C_EXPBD_Handle, Addr, ( uint16_t )Reg, I2C_MEMADD_SIZE_8BIT, pBuffer, Size,
-                              I2C_EXPBD_Timeout );
-
-  /* Check the communication status */
-  if( status != HAL_OK )
-  {
-
-    /* Execute user timeout callback */
-    I2C_EXPBD_Error( Addr );
-    return 1;
-  }
-  else
+  for ( attempt = 0; ; attempt++ )
   {
-    return 0;
+    status = HAL_I2C_Mem_Write( &I2C_EXPBD_Handle, Addr, ( uint16_t )Reg, I2C_MEMADD_SIZE_8BIT, pBuffer, Size,
+                                I2C_EXPBD_Timeout );
+
+    /* Check the communication status */
+    if( status == HAL_OK )
+    {
+      return 0;
+    }
+
+    /* Recover the bus, then retry unless the retries are over */
+    if ( I2C_EXPBD_Error( Addr, attempt ) )
+    {
+      return 1;
+    }
   }
 }
 
@@ -259,59 +406,450 @@ static uint8_t I2C_EXPBD_ReadData( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer,
 {
 
   HAL_StatusTypeDef status = HAL_OK;
+  uint8_t attempt;
+
+  for ( attempt = 0; ; attempt++ )
+  {
+    status = HAL_I2C_Mem_Read( &I2C_EXPBD_Handle, Addr, ( uint16_t )Reg, I2C_MEMADD_SIZE_8BIT, pBuffer, Size,
+                               I2C_EXPBD_Timeout );
+
+    /* Check the communication status */
+    if( status == HAL_OK )
+    {
+      return 0;
+    }
+
+    /* Recover the bus, then retry unless the retries are over */
+    if ( I2C_EXPBD_Error( Addr, attempt ) )
+    {
+      return 1;
+    }
+  }
+}
+
 
-  status = HAL_I2C_Mem_Read( &I2C_EXPBD_Handle, Addr, ( uint16_t )Reg, I2C_MEMADD_SIZE_8BIT, pBuffer, Size,
-                             I2C_EXPBD_Timeout );
 
-  /* Check the communication status */
-  if( status != HAL_OK )
+/**
+ * @brief  Queues a register write, merging it into a pending single byte
+ *         write to the same register when no multi byte write sits between
+ *         the two.
+ * @param  Addr Device address on BUS
+ * @param  Reg The target register address to be written
+ * @param  pBuffer The data to be written, copied in the queue
+ * @param  Size Number of bytes to be written
+ * @retval 0 in case of success
+ * @retval 1 if the queue is full
+ */
+static uint8_t I2C_EXPBD_Enqueue( uint8_t Addr, uint8_t Reg, uint8_t* pBuffer, uint16_t Size )
+{
+  uint32_t primask = __get_PRIMASK();
+  I2C_EXPBD_Cmd_t *cmd;
+  uint8_t first;
+  uint8_t i;
+
+  __disable_irq();
+
+  if ( Size == 1 )
   {
+    /* Walk back from the newest entry, the one on the bus is out of reach */
+    first = I2C_EXPBD_TxBusy ? 1 : 0;
+    for ( i = I2C_EXPBD_QCount; i > first; i-- )
+    {
+      cmd = &I2C_EXPBD_Queue[( I2C_EXPBD_QHead + i - 1 ) % NUCLEO_I2C_EXPBD_QUEUE_DEPTH];
+      if ( cmd->Size != 1 )
+      {
+        break;
+      }
+      if ( cmd->Addr == Addr && cmd->Reg == Reg )
+      {
+        cmd->Data[0] = pBuffer[0];
+        I2C_EXPBD_Stats.Coalesced++;
+        __set_PRIMASK( primask );
+        return 0;
+      }
+    }
+  }
 
-    /* Execute user timeout callback */
-    I2C_EXPBD_Error( Addr );
+  if ( I2C_EXPBD_QCount == NUCLEO_I2C_EXPBD_QUEUE_DEPTH )
+  {
+    I2C_EXPBD_Stats.Dropped++;
+    __set_PRIMASK( primask );
     return 1;
   }
-  else
+
+  cmd = &I2C_EXPBD_Queue[( I2C_EXPBD_QHead + I2C_EXPBD_QCount ) % NUCLEO_I2C_EXPBD_QUEUE_DEPTH];
+  cmd->Addr = Addr;
+  cmd->Reg = Reg;
+  cmd->Size = ( uint8_t )Size;
+  cmd->Retries = 0;
+  memcpy( cmd->Data, pBuffer, Size );
+  I2C_EXPBD_QCount++;
+  I2C_EXPBD_Stats.Queued++;
+  if ( I2C_EXPBD_QCount > I2C_EXPBD_Stats.MaxDepth )
+  {
+    I2C_EXPBD_Stats.MaxDepth = I2C_EXPBD_QCount;
+  }
+  __set_PRIMASK( primask );
+
+  I2C_EXPBD_Kick();
+  return 0;
+}
+
+/**
+ * @brief  Starts the oldest queued write if the bus is free. The bus is
+ *         claimed with interrupts disabled, by setting I2C_EXPBD_TxBusy, and
+ *         the transfer is started once they are restored: HAL_I2C_Mem_Write_IT
+ *         may wait up to 25 ms for the BUSY flag to clear. Called with
+ *         interrupts disabled it does nothing, the write is started by the
+ *         next call made with them enabled, at the latest by Sensor_IO_Task.
+ * @param  None
+ * @retval None
+ */
+static void I2C_EXPBD_Kick( void )
+{
+  uint32_t primask = __get_PRIMASK();
+  I2C_EXPBD_Cmd_t *cmd;
+
+  if ( primask != 0 )
+  {
+    return;
+  }
+  __disable_irq();
+  if ( I2C_EXPBD_TxBusy || I2C_EXPBD_Blocking || I2C_EXPBD_Stalled || I2C_EXPBD_RecoverPending
+       || I2C_EXPBD_QCount == 0 )
+  {
+    __set_PRIMASK( primask );
+    return;
+  }
+  I2C_EXPBD_TxBusy = 1;
+  __set_PRIMASK( primask );
+
+  /* The head entry is ours until the transfer is over */
+  cmd = &I2C_EXPBD_Queue[I2C_EXPBD_QHead];
+  if ( HAL_I2C_Mem_Write_IT( &I2C_EXPBD_Handle, cmd->Addr, ( uint16_t )cmd->Reg, I2C_MEMADD_SIZE_8BIT,
+                             cmd->Data, cmd->Size ) == HAL_OK )
+  {
+    return;
+  }
+
+  /* Bus stuck: the write stays at the head until Sensor_IO_Task */
+  __disable_irq();
+  I2C_EXPBD_TxBusy = 0;
+  I2C_EXPBD_Stalled = 1;
+  __set_PRIMASK( primask );
+}
+
+/**
+ * @brief  Retires the queued write on the bus and starts the next one.
+ * @param  Status 0 if the write has been acknowledged, 1 otherwise
+ * @retval None
+ */
+static void I2C_EXPBD_TxDone( uint8_t Status )
+{
+  I2C_EXPBD_Cmd_t *cmd = &I2C_EXPBD_Queue[I2C_EXPBD_QHead];
+
+  I2C_EXPBD_TxBusy = 0;
+  if ( Status )
+  {
+    /* The write stays at the head of the queue, Sensor_IO_Task retries it */
+    I2C_EXPBD_Stalled = 1;
+    return;
+  }
+  I2C_EXPBD_Stats.Completed++;
+  I2C_EXPBD_QHead = ( I2C_EXPBD_QHead + 1 ) % NUCLEO_I2C_EXPBD_QUEUE_DEPTH;
+  I2C_EXPBD_QCount--;
+  Sensor_IO_WriteCplt_Callback( cmd->Addr, cmd->Reg, 0 );
+  I2C_EXPBD_Kick();
+}
+
+/**
+ * @brief  Recovers the bus when it has been left failed and retries the
+ *         stalled queued write, or gives it up once its retries are over.
+ *         Otherwise starts a write queued with interrupts disabled. Does
+ *         nothing from interrupt context or with interrupts disabled.
+ * @param  None
+ * @retval None
+ */
+static void I2C_EXPBD_Service( void )
+{
+  I2C_EXPBD_Cmd_t *cmd = &I2C_EXPBD_Queue[I2C_EXPBD_QHead];
+  uint32_t primask;
+  uint8_t addr = 0;
+  uint8_t reg = 0;
+  uint8_t drop = 0;
+
+  if ( __get_IPSR() != 0 || __get_PRIMASK() != 0 )
+  {
+    return;
+  }
+  if ( !I2C_EXPBD_Stalled && !I2C_EXPBD_RecoverPending )
+  {
+    I2C_EXPBD_Kick();
+    return;
+  }
+
+  /* Own the bus, so that no transfer starts from an interrupt meanwhile */
+  __disable_irq();
+  if ( I2C_EXPBD_Blocking || I2C_EXPBD_TxBusy )
+  {
+    __enable_irq();
+    return;
+  }
+  I2C_EXPBD_Blocking = 1;
+  __enable_irq();
+
+  if ( I2C_EXPBD_RecoverPending )
+  {
+    I2C_EXPBD_RecoverPending = 0;
+    I2C_EXPBD_Recover();
+  }
+  if ( I2C_EXPBD_Stalled && I2C_EXPBD_QCount != 0 && I2C_EXPBD_Error( cmd->Addr, cmd->Retries++ ) )
+  {
+    drop = 1;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if ( drop )
+  {
+    addr = cmd->Addr;
+    reg = cmd->Reg;
+    I2C_EXPBD_Stats.Errors++;
+    I2C_EXPBD_QHead = ( I2C_EXPBD_QHead + 1 ) % NUCLEO_I2C_EXPBD_QUEUE_DEPTH;
+    I2C_EXPBD_QCount--;
+  }
+  I2C_EXPBD_Stalled = 0;
+  I2C_EXPBD_Blocking = 0;
+  __set_PRIMASK( primask );
+  I2C_EXPBD_Kick();
+
+  if ( drop )
+  {
+    Sensor_IO_WriteCplt_Callback( addr, reg, 1 );
+  }
+}
+
+/**
+ * @brief  Takes the bus for a blocking transfer, once the queue is empty.
+ *         From interrupt context the bus is taken only if it is already idle.
+ * @param  None
+ * @retval 0 in case of success
+ * @retval 1 if the queue could not be drained
+ */
+static uint8_t I2C_EXPBD_BeginBlocking( void )
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint32_t primask;
+
+  if ( !I2C_EXPBD_QueueEnabled )
   {
     return 0;
   }
+
+  for ( ;; )
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ( I2C_EXPBD_QCount == 0 && !I2C_EXPBD_TxBusy && !I2C_EXPBD_Blocking )
+    {
+      I2C_EXPBD_Blocking = 1;
+      __set_PRIMASK( primask );
+      return 0;
+    }
+    __set_PRIMASK( primask );
+
+    if ( __get_IPSR() != 0 || (HAL_GetTick() - tickstart) > I2C_EXPBD_Timeout )
+    {
+      return 1;
+    }
+    I2C_EXPBD_Service();
+  }
 }
 
+/**
+ * @brief  Releases the bus after a blocking transfer and restarts the queue
+ *         with anything queued from interrupt context in the meantime.
+ * @param  None
+ * @retval None
+ */
+static void I2C_EXPBD_EndBlocking( void )
+{
+  uint32_t primask = __get_PRIMASK();
 
+  if ( !I2C_EXPBD_Blocking )
+  {
+    return;
+  }
+  __disable_irq();
+  I2C_EXPBD_Blocking = 0;
+  __set_PRIMASK( primask );
+  I2C_EXPBD_Kick();
+}
 
 /**
- * @brief  Manages error callback by re-initializing I2C
- * @param  Addr I2C Address
+ * @brief  Memory Tx transfer completed callback
+ * @param  hi2c I2C handle
  * @retval None
  */
-static void I2C_EXPBD_Error( uint8_t Addr )
+void HAL_I2C_MemTxCpltCallback( I2C_HandleTypeDef *hi2c )
 {
+  if ( hi2c == &I2C_EXPBD_Handle && I2C_EXPBD_TxBusy )
+  {
+    I2C_EXPBD_TxDone( 0 );
+  }
+}
 
-  /* De-initialize the I2C comunication bus */
-  HAL_I2C_DeInit( &I2C_EXPBD_Handle );
+/**
+ * @brief  I2C error callback
+ * @param  hi2c I2C handle
+ * @retval None
+ */
+void HAL_I2C_ErrorCallback( I2C_HandleTypeDef *hi2c )
+{
+  if ( hi2c == &I2C_EXPBD_Handle && I2C_EXPBD_TxBusy )
+  {
+    I2C_EXPBD_TxDone( 1 );
+  }
+}
+
+/**
+ * @brief  Manages a failed transfer. A device that did not acknowledge leaves
+ *         the bus idle and the transfer is simply retried, any other error
+ *         gets the bus recovered first. From interrupt context, or with
+ *         interrupts disabled, the recovery is only scheduled for
+ *         Sensor_IO_Task and the transfer is given up.
+ * @param  Addr I2C Address
+ * @param  Attempt number of retries already made for the transfer
+ * @retval 0 if the transfer has to be retried
+ * @retval 1 if the retries are over
+ */
+static uint8_t I2C_EXPBD_Error( uint8_t Addr, uint8_t Attempt )
+{
+  uint8_t nack = HAL_I2C_GetError( &I2C_EXPBD_Handle ) == HAL_I2C_ERROR_AF
+                 && __HAL_I2C_GET_FLAG( &I2C_EXPBD_Handle, I2C_FLAG_BUSY ) == RESET;
 
-  /* Re-Initiaize the I2C comunication bus */
-  I2C_EXPBD_Init();
+  I2C_EXPBD_BusStats.Errors++;
+  if ( nack )
+  {
+    I2C_EXPBD_BusStats.Nacks++;
+  }
+  else if ( __get_IPSR() != 0 || __get_PRIMASK() != 0 )
+  {
+    I2C_EXPBD_RecoverPending = 1;
+    I2C_EXPBD_BusStats.Failures++;
+    return 1;
+  }
+  else
+  {
+    /* Leave a usable bus behind, even when giving up */
+    I2C_EXPBD_Recover();
+  }
+
+  if ( Attempt >= NUCLEO_I2C_EXPBD_RETRIES )
+  {
+    I2C_EXPBD_BusStats.Failures++;
+    return 1;
+  }
+  I2C_EXPBD_BusStats.Retries++;
+  return 0;
 }
 
+/**
+ * @brief  Recovers the bus without going through the MSP: the pins are
+ *         taken as GPIOs to clock out a slave holding SDA low and to force
+ *         a STOP, then the peripheral alone is reset and configured again.
+ *         Only if SDA is still held low the I2C is fully re-initialized.
+ * @param  None
+ * @retval None
+ */
+static void I2C_EXPBD_Recover( void )
+{
+  uint8_t i;
+  uint8_t released;
+
+  I2C_EXPBD_BusStats.Recoveries++;
+
+  if ( HAL_I2C_GetState( &I2C_EXPBD_Handle ) == HAL_I2C_STATE_RESET )
+  {
+    I2C_EXPBD_Init();
+    return;
+  }
 
+  __HAL_I2C_DISABLE( &I2C_EXPBD_Handle );
+  I2C_EXPBD_PinsConfig( GPIO_MODE_OUTPUT_OD );
+  HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SCL_PIN | NUCLEO_I2C_EXPBD_SDA_PIN,
+                     GPIO_PIN_SET );
+  I2C_EXPBD_Delay();
+
+  /* Clock SCL until the slave lets SDA go, at most one byte and the ACK */
+  if ( HAL_GPIO_ReadPin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SDA_PIN ) == GPIO_PIN_RESET )
+  {
+    I2C_EXPBD_BusStats.Released++;
+  }
+  for ( i = 0; i < NUCLEO_I2C_EXPBD_RECOVERY_CLOCKS
+        && HAL_GPIO_ReadPin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SDA_PIN ) == GPIO_PIN_RESET; i++ )
+  {
+    HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SCL_PIN, GPIO_PIN_RESET );
+    I2C_EXPBD_Delay();
+    HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SCL_PIN, GPIO_PIN_SET );
+    I2C_EXPBD_Delay();
+  }
+
+  /* STOP: SDA rising while SCL is high */
+  HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SCL_PIN, GPIO_PIN_RESET );
+  I2C_EXPBD_Delay();
+  HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SDA_PIN, GPIO_PIN_RESET );
+  I2C_EXPBD_Delay();
+  HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SCL_PIN, GPIO_PIN_SET );
+  I2C_EXPBD_Delay();
+  HAL_GPIO_WritePin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SDA_PIN, GPIO_PIN_SET );
+  I2C_EXPBD_Delay();
+  released = HAL_GPIO_ReadPin( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, NUCLEO_I2C_EXPBD_SDA_PIN ) == GPIO_PIN_SET;
+
+  I2C_EXPBD_PinsConfig( GPIO_MODE_AF_OD );
+
+#if ((defined (USE_STM32F4XX_NUCLEO)) || (defined (USE_STM32L1XX_NUCLEO)))
+  /* Clears a BUSY flag left set by the glitches on the lines */
+  SET_BIT( I2C_EXPBD_Handle.Instance->CR1, I2C_CR1_SWRST );
+  CLEAR_BIT( I2C_EXPBD_Handle.Instance->CR1, I2C_CR1_SWRST );
+#endif
+
+  /* The handle is not in reset state: only the peripheral is configured */
+  HAL_I2C_Init( &I2C_EXPBD_Handle );
+
+  if ( !released || HAL_I2C_GetState( &I2C_EXPBD_Handle ) != HAL_I2C_STATE_READY )
+  {
+    I2C_EXPBD_BusStats.Reinits++;
+    HAL_I2C_DeInit( &I2C_EXPBD_Handle );
+    I2C_EXPBD_Init();
+  }
+}
 
 /**
- * @brief I2C MSP Initialization
- * @param None
+ * @brief  Busy waits for half a period of the recovery clock.
+ * @param  None
  * @retval None
  */
+static void I2C_EXPBD_Delay( void )
+{
+  __IO uint32_t count = ( SystemCoreClock / 1000000U ) * NUCLEO_I2C_EXPBD_RECOVERY_HALF_US / 4U;
 
-static void I2C_EXPBD_MspInit( void )
+  while ( count-- )
+  {
+  }
+}
+
+/**
+ * @brief  Configures the SCL and SDA pins.
+ * @param  Mode GPIO_MODE_AF_OD for the I2C, GPIO_MODE_OUTPUT_OD for recovery
+ * @retval None
+ */
+static void I2C_EXPBD_PinsConfig( uint32_t Mode )
 {
   GPIO_InitTypeDef  GPIO_InitStruct;
 
-  /* Enable I2C GPIO clocks */
-  NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_CLK_ENABLE();
-
-  /* I2C_EXPBD SCL and SDA pins configuration -------------------------------------*/
   GPIO_InitStruct.Pin        = NUCLEO_I2C_EXPBD_SCL_PIN | NUCLEO_I2C_EXPBD_SDA_PIN;
-  GPIO_InitStruct.Mode       = GPIO_MODE_AF_OD;
+  GPIO_InitStruct.Mode       = Mode;
 #if ((defined (USE_STM32F4XX_NUCLEO)) || (defined (USE_STM32L0XX_NUCLEO)) || (defined (USE_STM32L4XX_NUCLEO)) || (defined (USE_STM32F7XX_NUCLEO_144)))
   GPIO_InitStruct.Speed = GPIO_SPEED_FAST;
 #endif
@@ -323,6 +861,23 @@ static void I2C_EXPBD_MspInit( void )
   GPIO_InitStruct.Alternate  = NUCLEO_I2C_EXPBD_SCL_SDA_AF;
 
   HAL_GPIO_Init( NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_PORT, &GPIO_InitStruct );
+}
+
+
+
+/**
+ * @brief I2C MSP Initialization
+ * @param None
+ * @retval None
+ */
+
+static void I2C_EXPBD_MspInit( void )
+{
+  /* Enable I2C GPIO clocks */
+  NUCLEO_I2C_EXPBD_SCL_SDA_GPIO_CLK_ENABLE();
+
+  /* I2C_EXPBD SCL and SDA pins configuration -------------------------------------*/
+  I2C_EXPBD_PinsConfig( GPIO_MODE_AF_OD );
 
   /* Enable the I2C_EXPBD peripheral clock */
   NUCLEO_I2C_EXPBD_CLK_ENABLE();
@@ -135,6 +135,8 @@ extern "C" {
 #if ((defined (USE_STM32F4XX_NUCLEO)) ||(defined (USE_STM32F3XX_NUCLEO)) || (defined (USE_STM32L1XX_NUCLEO)) || (defined (USE_STM32F7XX_NUCLEO_144)) || (defined (USE_STM32L4XX_NUCLEO)))
 #define NUCLEO_I2C_EXPBD_EV_IRQn                    I2C1_EV_IRQn
 #define NUCLEO_I2C_EXPBD_ER_IRQn                    I2C1_ER_IRQn
+#define NUCLEO_I2C_EXPBD_EV_IRQHandler              I2C1_EV_IRQHandler
+#define NUCLEO_I2C_EXPBD_ER_IRQHandler              I2C1_ER_IRQHandler
 #endif
 
 #if (defined (USE_STM32L0XX_NUCLEO) || (defined (USE_STM32F0XX_NUCLEO)))
@@ -148,6 +150,56 @@ extern "C" {
    conditions (interrupts routines ...). */
 #define NUCLEO_I2C_EXPBD_TIMEOUT_MAX    0x1000 /*<! The value of the maximal timeout for BUS waiting loops */
 
+/* Asynchronous write queue, see Sensor_IO_EnableQueue() */
+#define NUCLEO_I2C_EXPBD_QUEUE_DEPTH        16  /*<! Pending register writes */
+#define NUCLEO_I2C_EXPBD_QUEUE_DATA_SIZE    20  /*<! Largest queued write, bigger ones go out blocking */
+
+/* Bus recovery: a failed transfer is retried up to NUCLEO_I2C_EXPBD_RETRIES
+   times. Before each retry, unless the device just did not acknowledge, SCL
+   is clocked up to NUCLEO_I2C_EXPBD_RECOVERY_CLOCKS times to release a slave
+   holding SDA, a STOP is forced and the peripheral alone is reset. With
+   5 us half periods the whole sequence takes about 0.1 ms. It only runs out
+   of interrupt context: queued writes are retried by Sensor_IO_Task. */
+#define NUCLEO_I2C_EXPBD_RETRIES             2   /*<! Retries of a failed transfer */
+#define NUCLEO_I2C_EXPBD_RECOVERY_CLOCKS     9   /*<! SCL pulses to release SDA */
+#define NUCLEO_I2C_EXPBD_RECOVERY_HALF_US    5   /*<! Half period of the recovery clock */
+
+/**
+  * @}
+  */
+
+/** @addtogroup X_NUCLEO_CCA01M1_IO_Public_Types Public types
+ * @{
+ */
+
+/**
+ * @brief  Asynchronous write queue counters
+ */
+typedef struct
+{
+  uint32_t Queued;      /*<! Writes accepted in the queue */
+  uint32_t Coalesced;   /*<! Writes merged into a pending write to the same register */
+  uint32_t Completed;   /*<! Writes acknowledged by the device */
+  uint32_t Dropped;     /*<! Writes rejected because the queue was full */
+  uint32_t Errors;      /*<! Writes dropped once the bus retries ran out */
+  uint32_t MaxDepth;    /*<! Queue high watermark */
+  uint32_t Pending;     /*<! Writes in the queue, including the one on the bus */
+} Sensor_IO_QueueStatsTypeDef;
+
+/**
+ * @brief  Bus error and recovery counters
+ */
+typedef struct
+{
+  uint32_t Errors;      /*<! Transfers failed on the bus, retries included */
+  uint32_t Nacks;       /*<! Failures due to the device not acknowledging */
+  uint32_t Retries;     /*<! Transfers started again after a failure */
+  uint32_t Recoveries;  /*<! Bus recovery sequences run */
+  uint32_t Released;    /*<! Recoveries that had to clock SCL to free SDA */
+  uint32_t Reinits;     /*<! Full re-initializations, when SDA stayed low */
+  uint32_t Failures;    /*<! Transfers given up once the retries ran out */
+} Sensor_IO_BusStatsTypeDef;
+
 /**
   * @}
   */
@@ -157,6 +209,14 @@ extern "C" {
  */
 
 DrvStatusTypeDef Sensor_IO_Init( void );
+DrvStatusTypeDef Sensor_IO_EnableQueue( uint8_t Enable );
+DrvStatusTypeDef Sensor_IO_Flush( void );
+void Sensor_IO_Task( void );
+void Sensor_IO_GetQueueStats( Sensor_IO_QueueStatsTypeDef *Stats );
+void Sensor_IO_GetBusStats( Sensor_IO_BusStatsTypeDef *Stats );
+void Sensor_IO_WriteCplt_Callback( uint8_t Addr, uint8_t Reg, uint8_t Status );
+
+extern I2C_HandleTypeDef I2C_EXPBD_Handle;
 
 
 /**
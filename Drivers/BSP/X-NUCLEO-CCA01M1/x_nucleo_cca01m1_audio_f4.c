@@ -60,10 +60,34 @@
 * @}
 */
 
+/** @defgroup X_NUCLEO_CCA01M1_AUDIO_Private_Types Private Types
+* @{
+*/
+/* Volume ramp of the master and channel volume registers (MVOL to C3VOL).
+The output interrupts count the half-buffers, BSP_AUDIO_OUT_VolumeTask writes
+the value reached after Elapsed of Blocks half-buffers */
+typedef struct
+{
+  uint8_t Start[STA350BW_CHANNEL_3 + 1];
+  uint8_t Current[STA350BW_CHANNEL_3 + 1];
+  uint8_t Target[STA350BW_CHANNEL_3 + 1];
+  uint16_t Blocks[STA350BW_CHANNEL_3 + 1];
+  uint16_t Elapsed[STA350BW_CHANNEL_3 + 1];
+  __IO uint8_t Active;
+  __IO uint16_t Pending;
+} AUDIO_OUT_Ramp_t;
+/**
+* @}
+*/
+
 /** @defgroup X_NUCLEO_CCA01M1_AUDIO_Private_Variables Private Variables
 * @{
 */
 static DrvContextTypeDef CODEC_Handle[SOUNDTERMINAL_DEVICE_NBR];
+static STA350BW_Data_t CODEC_Data[SOUNDTERMINAL_DEVICE_NBR];
+static __IO uint8_t CODEC_FaultPending[SOUNDTERMINAL_DEVICE_NBR];
+static uint8_t CODEC_Status[SOUNDTERMINAL_DEVICE_NBR];
+static AUDIO_OUT_Ramp_t CODEC_Ramp[SOUNDTERMINAL_DEVICE_NBR];
 I2S_HandleTypeDef hAudioOutI2s[SOUNDTERMINAL_DEVICE_NBR];
 /**
 * @}
@@ -73,6 +97,7 @@ I2S_HandleTypeDef hAudioOutI2s[SOUNDTERMINAL_DEVICE_NBR];
 * @{
 */
 static void I2Sx_Init(I2S_HandleTypeDef *hi2s, uint32_t AudioFreq);
+static void Volume_RampTick(uint8_t instance);
 /**
 * @}
 */
@@ -142,9 +167,11 @@ uint8_t BSP_AUDIO_OUT_Init(CODEC_ID_t id, void **handle, uint16_t OutputDevice,
   CODEC_Handle[tmp].isInitialized = 0;
   CODEC_Handle[tmp].isEnabled     = 0;
   CODEC_Handle[tmp].isCombo       = 1;
-  CODEC_Handle[tmp].pData         = ( void * )NULL;
+  CODEC_Handle[tmp].pData         = ( void * )&CODEC_Data[tmp];
   CODEC_Handle[tmp].pVTable       = ( void * )&STA350BW_Drv;
-  CODEC_Handle[tmp].pExtVTable    = 0;
+  CODEC_Handle[tmp].pExtVTable    = ( void * )&STA350BW_ExtDrv;
+  CODEC_Ramp[tmp].Active          = 0;
+  CODEC_Ramp[tmp].Pending         = 0;
   
   *handle = (void *)&CODEC_Handle[tmp];  
   driver = ( SOUNDTERMINAL_Drv_t * )((DrvContextTypeDef *)(*handle))->pVTable;
@@ -356,6 +383,7 @@ uint8_t BSP_AUDIO_OUT_SetVolume(void *handle, uint8_t channel, uint8_t value)
 {
   DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
   SOUNDTERMINAL_Drv_t *driver = NULL;  
+  uint32_t primask;
   
   if(ctx == NULL)
   {
@@ -364,6 +392,15 @@ uint8_t BSP_AUDIO_OUT_SetVolume(void *handle, uint8_t channel, uint8_t value)
   
   driver = ( SOUNDTERMINAL_Drv_t * )ctx->pVTable;  
   
+  /* An immediate write overrides a ramp in progress on the same register */
+  if(channel <= STA350BW_CHANNEL_3)
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    CODEC_Ramp[ctx->instance].Active &= ~(1 << channel);
+    __set_PRIMASK(primask);
+  }
+  
   if(driver->SetVolume(ctx, channel, value, NULL) != 0)
   {
     return COMPONENT_ERROR;
@@ -371,6 +408,177 @@ uint8_t BSP_AUDIO_OUT_SetVolume(void *handle, uint8_t channel, uint8_t value)
   return COMPONENT_OK;  
 }
 
+/**
+* @brief  Move a volume to a new value over a number of output half-buffers.
+* @param  handle: device handle
+* @param  channel: channel to be configured
+*         This parameter can be a value of @ref STA350BW_channel_define
+* @param  value: target volume register value
+* @param  blocks: number of half-buffer periods the change is spread over, 
+*         0 writes the value immediately
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+* @note   The I2S DMA half and full transfer interrupts count the 
+*         half-buffers and BSP_AUDIO_OUT_VolumeTask, called from the main 
+*         loop, writes the volumes reached, with one I2C write for all the 
+*         ramping registers of the device. Calls made while a ramp is running 
+*         restart it from the value reached toward the new target.
+*         When soft volume is enabled in the device (CONFE.SVE, set after 
+*         reset) the device ramps by itself and the target is written in one
+*         step after the next half-buffer: clear it with the STA350BW_SVE 
+*         DSP option for a ramp over the given blocks.
+*/
+uint8_t BSP_AUDIO_OUT_SetVolumeRamp(void *handle, uint8_t channel, uint8_t value, uint16_t blocks)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  AUDIO_OUT_Ramp_t *ramp;
+  uint8_t soft = STA350BW_DISABLE;
+  uint8_t current = 0;
+  uint32_t primask;
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL || channel > STA350BW_CHANNEL_3)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  if(blocks == 0)
+  {
+    return BSP_AUDIO_OUT_SetVolume(handle, channel, value);
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  ramp = &CODEC_Ramp[ctx->instance];
+  
+  if(extDriver->GetSoftVolume(ctx, &soft, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  if(soft == STA350BW_ENABLE)
+  {
+    blocks = 1;
+  }
+  if(extDriver->GetVolume(ctx, channel, &current, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if(ramp->Active == 0)
+  {
+    ramp->Pending = 0;
+  }
+  if(!(ramp->Active & (1 << channel)))
+  {
+    ramp->Current[channel] = current;
+  }
+  ramp->Start[channel] = ramp->Current[channel];
+  ramp->Target[channel] = value;
+  ramp->Blocks[channel] = blocks;
+  ramp->Elapsed[channel] = 0;
+  ramp->Active |= (1 << channel);
+  __set_PRIMASK(primask);
+  
+  return COMPONENT_OK;  
+}
+
+/**
+* @brief  Write the volumes reached by the ramps of a device, to be called 
+*         from the main loop. The half-buffers elapsed since the last call 
+*         are applied at once, so a late call does not slow the ramp down.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_VolumeTask(void *handle)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  SOUNDTERMINAL_Drv_t *driver = NULL;
+  STA350BW_ExtDrv_t *extDriver = NULL;
+  AUDIO_OUT_Ramp_t *ramp;
+  uint8_t volume[STA350BW_CHANNEL_3 + 1];
+  uint8_t update = 0;
+  uint8_t channel;
+  uint16_t elapsed;
+  uint32_t primask;
+  uint8_t ret = COMPONENT_OK;
+  
+  if(ctx == NULL || ctx->pVTable == NULL || ctx->pExtVTable == NULL || ctx->instance >= SOUNDTERMINAL_DEVICE_NBR)
+  {
+    return COMPONENT_ERROR;
+  }
+  ramp = &CODEC_Ramp[ctx->instance];
+  if(ramp->Active == 0 || ramp->Pending == 0)
+  {
+    return COMPONENT_OK;
+  }
+  
+  /* Volume registers are linear in dB, so are the steps: the value after k 
+  of N half-buffers is Start + (Target - Start) * k / N */
+  primask = __get_PRIMASK();
+  __disable_irq();
+  elapsed = ramp->Pending;
+  ramp->Pending = 0;
+  for(channel = STA350BW_CHANNEL_MASTER; channel <= STA350BW_CHANNEL_3; channel++)
+  {
+    if(!(ramp->Active & (1 << channel)))
+    {
+      continue;
+    }
+    if(elapsed >= ramp->Blocks[channel] - ramp->Elapsed[channel])
+    {
+      ramp->Elapsed[channel] = ramp->Blocks[channel];
+      ramp->Active &= ~(1 << channel);
+    }
+    else
+    {
+      ramp->Elapsed[channel] += elapsed;
+    }
+    ramp->Current[channel] = (uint8_t)((int32_t)ramp->Start[channel] + 
+                                       ((int32_t)ramp->Target[channel] - ramp->Start[channel]) * 
+                                       ramp->Elapsed[channel] / ramp->Blocks[channel]);
+    volume[channel] = ramp->Current[channel];
+    update |= (1 << channel);
+  }
+  __set_PRIMASK(primask);
+  
+  if(update == 0)
+  {
+    return COMPONENT_OK;
+  }
+  driver = ( SOUNDTERMINAL_Drv_t * )ctx->pVTable;
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;
+  
+  extDriver->BeginUpdate(ctx, NULL);
+  for(channel = STA350BW_CHANNEL_MASTER; channel <= STA350BW_CHANNEL_3; channel++)
+  {
+    if((update & (1 << channel)) && driver->SetVolume(ctx, channel, volume[channel], NULL) != 0)
+    {
+      ret = COMPONENT_ERROR;
+    }
+  }
+  if(extDriver->CommitUpdate(ctx, NULL) != 0)
+  {
+    ret = COMPONENT_ERROR;
+  }
+  return ret;
+}
+
+/**
+* @brief  Tell whether a volume ramp is in progress.
+* @param  handle: device handle
+* @retval 1 if at least one volume register is ramping, 0 otherwise
+*/
+uint8_t BSP_AUDIO_OUT_IsVolumeRamping(void *handle)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  
+  if(ctx == NULL)
+  {
+    return 0;
+  }
+  return CODEC_Ramp[ctx->instance].Active != 0;
+}
+
 /**
 * @brief  Set Equalization.
 * @param  handle: device handle
@@ -401,6 +609,456 @@ uint8_t BSP_AUDIO_OUT_SetEq(void *handle, uint8_t ramBlock, uint8_t filterNumber
   return COMPONENT_OK;    
 }
 
+/**
+* @brief  Set all the biquads of a channel in one sequence.
+* @param  handle: device handle
+* @param  ramBlock: device RAM block to be written
+* @param  channel: channel to be programmed, STA350BW_CHANNEL_MASTER loads 
+*         the same filters on both channels
+* @param  filterValues: pointer to the filter values of every biquad of the 
+*         channel, 5 coefficients per biquad
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetEqBank(void *handle, uint8_t ramBlock, uint8_t channel, uint32_t * filterValues)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->SetEqBank(ctx, ramBlock, channel, filterValues, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Set the coefficient range of the first biquads, as returned by 
+*         BQ_CALC_ComputeFilterRange. The range of a biquad is shared by both 
+*         channels and all RAM blocks, the bits are written in one sequence.
+* @param  handle: device handle
+* @param  ranges: range of each biquad, 1, 2 or 4
+* @param  count: number of biquads, from the first one. Only the first 
+*         AUDIO_OUT_EXT_RANGE_BIQUADS have an extended range, the next ones 
+*         must be 1
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetEqRanges(void *handle, const uint8_t * ranges, uint8_t count)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  SOUNDTERMINAL_Drv_t *driver = NULL;  
+  uint8_t ret = COMPONENT_OK;
+  uint8_t i = 0;
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL || ranges == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  for(i = 0; i < count; i++)
+  {
+    if(ranges[i] != 1 && (i >= AUDIO_OUT_EXT_RANGE_BIQUADS || (ranges[i] != 2 && ranges[i] != 4)))
+    {
+      return COMPONENT_ERROR;
+    }
+  }
+  if(count > AUDIO_OUT_EXT_RANGE_BIQUADS)
+  {
+    count = AUDIO_OUT_EXT_RANGE_BIQUADS;
+  }
+  
+  driver = ( SOUNDTERMINAL_Drv_t * )ctx->pVTable;
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->BeginUpdate(ctx, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  for(i = 0; i < count; i++)
+  {
+    if(driver->SetDSPOption(ctx, STA350BW_EXT_RANGE_BQ1 + i, ranges[i], NULL) != 0)
+    {
+      ret = COMPONENT_ERROR;
+    }
+  }
+  if(extDriver->CommitUpdate(ctx, NULL) != 0)
+  {
+    ret = COMPONENT_ERROR;
+  }
+  return ret;    
+}
+
+/**
+* @brief  Load one side of a crossover (BQ_CALC_ComputeCrossover) in the first 
+*         biquads of a channel and set their coefficient range. For bi-amping 
+*         on one device the low side goes to STA350BW_CHANNEL_1 and the high 
+*         side to STA350BW_CHANNEL_2; with one device per side each one takes 
+*         its side on STA350BW_CHANNEL_MASTER. The next biquads keep their EQ.
+*         Coefficients and range bits are not written atomically: load the 
+*         crossover before playing or while muted.
+* @param  handle: device handle
+* @param  ramBlock: device RAM block to be written
+* @param  channel: STA350BW_CHANNEL_1, STA350BW_CHANNEL_2 or 
+*         STA350BW_CHANNEL_MASTER
+* @param  filterValues: 5 coefficients per biquad
+* @param  ranges: range of each biquad, 1, 2 or 4
+* @param  biquads: number of biquads of the side
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetCrossover(void *handle, uint8_t ramBlock, uint8_t channel, uint32_t * filterValues, 
+                                   const uint8_t * ranges, uint8_t biquads)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  SOUNDTERMINAL_Drv_t *driver = NULL;  
+  uint8_t i = 0;
+  
+  if(ctx == NULL || filterValues == NULL || biquads == 0 || biquads > STA350BW_BIQUADS_PER_CHANNEL)
+  {
+    return COMPONENT_ERROR;
+  }
+  if(channel != STA350BW_CHANNEL_MASTER && channel != STA350BW_CHANNEL_1 && channel != STA350BW_CHANNEL_2)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  driver = ( SOUNDTERMINAL_Drv_t * )ctx->pVTable;  
+  
+  for(i = 0; i < biquads; i++)
+  {
+    uint32_t *set = &filterValues[i * STA350BW_BIQUAD_COEFFS];
+    
+    if(channel != STA350BW_CHANNEL_2 && driver->SetEq(ctx, ramBlock, STA350BW_CH1_BQ1 + i, set, NULL) != 0)
+    {
+      return COMPONENT_ERROR;
+    }
+    if(channel != STA350BW_CHANNEL_1 && driver->SetEq(ctx, ramBlock, STA350BW_CH2_BQ1 + i, set, NULL) != 0)
+    {
+      return COMPONENT_ERROR;
+    }
+  }
+  return BSP_AUDIO_OUT_SetEqRanges(handle, ranges, biquads);
+}
+
+/**
+* @brief  Reload the driver register shadow from the device, to be called 
+*         after BSP_AUDIO_OUT_Reset on an initialized device.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_Resync(void *handle)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->Resync(ctx, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Start a group of control changes. Volume, mute, tone, DSP option 
+*         and bank select changes made until BSP_AUDIO_OUT_CommitUpdate are 
+*         merged and written together.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_BeginUpdate(void *handle)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->BeginUpdate(ctx, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Write the control changes made since BSP_AUDIO_OUT_BeginUpdate, 
+*         adjacent registers in a single I2C transfer.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_CommitUpdate(void *handle)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->CommitUpdate(ctx, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Assign a limiter to a channel.
+* @param  handle: device handle
+* @param  channel: channel to be mapped, STA350BW_CHANNEL_MASTER maps both
+*         channel 1 and 2
+* @param  limiter: STA350BW_LIMITER_NONE, STA350BW_LIMITER_1 or STA350BW_LIMITER_2
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetLimiterMapping(void *handle, uint8_t channel, uint8_t limiter)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->SetLimiterMapping(ctx, channel, limiter, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Select anti-clipping or DRC operation of the limiters.
+* @param  handle: device handle
+* @param  mode: STA350BW_LIMITER_ANTICLIPPING or STA350BW_LIMITER_DRC
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetLimiterMode(void *handle, uint8_t mode)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->SetLimiterMode(ctx, mode, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Set attack/release rates and thresholds of a limiter.
+* @param  handle: device handle
+* @param  limiter: STA350BW_LIMITER_1 or STA350BW_LIMITER_2
+* @param  config: rates in dB/ms x 10000 and thresholds in dB
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_SetLimiter(void *handle, uint8_t limiter, STA350BW_Limiter_t * config)
+{    
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;  
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;  
+  
+  if(extDriver->SetLimiter(ctx, limiter, config, NULL) != 0)
+  {
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;    
+}
+
+/**
+* @brief  Start the fault monitoring: the fault line of the device raises an 
+*         EXTI on both edges and BSP_AUDIO_OUT_FaultTask reads STATUS only
+*         then, without any periodic I2C traffic. A first read is scheduled
+*         to fill the status snapshot.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_FaultInit(void *handle)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  GPIO_InitTypeDef  GPIO_InitStruct;
+  
+  if(ctx == NULL)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_LOW;
+  
+  if(ctx->instance == STA350BW_0)
+  {
+    AUDIO_OUT1_INT_GPIO_CLK_ENABLE();
+    GPIO_InitStruct.Pin = AUDIO_OUT1_INT_PIN;
+    HAL_GPIO_Init(AUDIO_OUT1_INT_GPIO_PORT, &GPIO_InitStruct);
+    HAL_NVIC_SetPriority(AUDIO_OUT1_INT_EXTI_IRQn, AUDIO_OUT_IRQ_PREPRIO, 0);
+    HAL_NVIC_EnableIRQ(AUDIO_OUT1_INT_EXTI_IRQn);
+  }
+  else if(ctx->instance == STA350BW_1)
+  {
+    AUDIO_OUT2_INT_GPIO_CLK_ENABLE();
+    GPIO_InitStruct.Pin = AUDIO_OUT2_INT_PIN;
+    HAL_GPIO_Init(AUDIO_OUT2_INT_GPIO_PORT, &GPIO_InitStruct);
+    HAL_NVIC_SetPriority(AUDIO_OUT2_INT_EXTI_IRQn, AUDIO_OUT_IRQ_PREPRIO, 0);
+    HAL_NVIC_EnableIRQ(AUDIO_OUT2_INT_EXTI_IRQn);
+  }
+  else
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  CODEC_FaultPending[ctx->instance] = 1;
+  return COMPONENT_OK;
+}
+
+/**
+* @brief  Read STATUS after a fault line edge, to be called from the main 
+*         loop. On a fault (bridge, under/overvoltage, overcurrent or thermal)
+*         the output is muted and the power stage turned off; both are 
+*         restored once STATUS is clear again. Warnings are only recorded.
+* @param  handle: device handle
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_FaultTask(void *handle)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  STA350BW_ExtDrv_t *extDriver = NULL;
+  uint8_t status = 0;
+  uint8_t protect = STA350BW_DISABLE;
+  
+  if(ctx == NULL || ctx->pExtVTable == NULL || ctx->instance >= SOUNDTERMINAL_DEVICE_NBR)
+  {
+    return COMPONENT_ERROR;
+  }
+  extDriver = ( STA350BW_ExtDrv_t * )ctx->pExtVTable;
+  
+  if(!CODEC_FaultPending[ctx->instance])
+  {
+    return COMPONENT_OK;
+  }
+  
+  /* Cleared before the read: an edge during the read schedules another one */
+  CODEC_FaultPending[ctx->instance] = 0;
+  
+  if(extDriver->GetStatus(ctx, &status, NULL) != 0)
+  {
+    CODEC_FaultPending[ctx->instance] = 1;
+    return COMPONENT_ERROR;
+  }
+  CODEC_Status[ctx->instance] = status;
+  
+  if((status & STA350BW_STATUS_FAULTS) != STA350BW_STATUS_FAULTS)
+  {
+    protect = STA350BW_ENABLE;
+  }
+  if(extDriver->SetProtection(ctx, protect, NULL) != 0)
+  {
+    CODEC_FaultPending[ctx->instance] = 1;
+    return COMPONENT_ERROR;
+  }
+  return COMPONENT_OK;
+}
+
+/**
+* @brief  Get the STATUS snapshot taken by the last BSP_AUDIO_OUT_FaultTask
+*         read, without any I2C access.
+* @param  handle: device handle
+* @param  status: STATUS value, see @ref STA350BW_status_define
+* @retval COMPONENT_OK if no problem during execution, COMPONENT_ERROR otherwise
+*/
+uint8_t BSP_AUDIO_OUT_GetStatus(void *handle, uint8_t *status)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+  
+  if(ctx == NULL || ctx->instance >= SOUNDTERMINAL_DEVICE_NBR)
+  {
+    return COMPONENT_ERROR;
+  }
+  *status = CODEC_Status[ctx->instance];
+  return COMPONENT_OK;
+}
+
+/**
+* @brief  To be called from HAL_GPIO_EXTI_Callback: schedules the STATUS 
+*         read of the device whose fault line has changed.
+* @param  GPIO_Pin: pin of the EXTI line
+* @retval None
+*/
+void BSP_AUDIO_OUT_FaultCallback(uint16_t GPIO_Pin)
+{
+  if(GPIO_Pin == AUDIO_OUT1_INT_PIN)
+  {
+    CODEC_FaultPending[STA350BW_0] = 1;
+  }
+  if(GPIO_Pin == AUDIO_OUT2_INT_PIN)
+  {
+    CODEC_FaultPending[STA350BW_1] = 1;
+  }
+}
+
+/**
+* @brief  Called by the I2C queue when a write is over. A write given up by 
+*         the bus leaves the driver shadow ahead of the device: the shadow 
+*         is no longer used, and the driver reloads it at its next register
+*         read, whichever call makes it.
+* @param  Addr: device address on the bus
+* @param  Reg: first register written
+* @param  Status: 0 if the device acknowledged the write, 1 otherwise
+* @retval None
+*/
+void Sensor_IO_WriteCplt_Callback(uint8_t Addr, uint8_t Reg, uint8_t Status)
+{
+  uint8_t i;
+  
+  if(Status == 0)
+  {
+    return;
+  }
+  for(i = 0; i < SOUNDTERMINAL_DEVICE_NBR; i++)
+  {
+    if(CODEC_Handle[i].pData != NULL && CODEC_Handle[i].address == Addr)
+    {
+      CODEC_Data[i].isShadowValid = 0;
+      CODEC_Data[i].isResyncPending = 1;
+    }
+  }
+}
+
 /**
 * @brief  Set Tone.
 * @param  handle: device handle
@@ -916,10 +1574,12 @@ void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s)
   /* Call the record update function to get the next buffer to fill and its size (size is ignored) */
   if(hi2s->Instance == AUDIO_OUT1_I2S_INSTANCE)
   {
+    Volume_RampTick(STA350BW_0);
     BSP_AUDIO_OUT_TransferComplete_CallBack(STA350BW_0);
   }
   if(hi2s->Instance == AUDIO_OUT2_I2S_INSTANCE)
   {
+    Volume_RampTick(STA350BW_1);
     BSP_AUDIO_OUT_TransferComplete_CallBack(STA350BW_1);
   }  
 }
@@ -935,10 +1595,12 @@ void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s)
   should be coded by user (its prototype is already declared in stm324xg_eval_audio.h) */  
   if(hi2s->Instance == AUDIO_OUT1_I2S_INSTANCE)
   {
+    Volume_RampTick(STA350BW_0);
     BSP_AUDIO_OUT_HalfTransfer_CallBack(STA350BW_0);
   }
   if(hi2s->Instance == AUDIO_OUT2_I2S_INSTANCE)
   {
+    Volume_RampTick(STA350BW_1);
     BSP_AUDIO_OUT_HalfTransfer_CallBack(STA350BW_1);
   }
 }
@@ -963,6 +1625,23 @@ __weak void BSP_AUDIO_OUT_HalfTransfer_CallBack(uint16_t OutputDevice)
 { 
 }
 
+/**
+* @brief  Count an output half-buffer for the volume ramps of a device. The 
+*         volumes are written by BSP_AUDIO_OUT_VolumeTask, out of the 
+*         interrupt, since the driver update state is not reentrant.
+* @param  instance: device instance
+* @retval None
+*/
+static void Volume_RampTick(uint8_t instance)
+{
+  AUDIO_OUT_Ramp_t *ramp = &CODEC_Ramp[instance];
+  
+  if(ramp->Active != 0 && ramp->Pending != 0xFFFF)
+  {
+    ramp->Pending++;
+  }
+}
+
 /**
 * @brief  Initializes the Audio Codec audio interface (I2S)
 * @note   This function assumes that the I2S input clock (through PLL_R in 
@@ -46,7 +46,7 @@ extern "C" {
   
   /* Includes ------------------------------------------------------------------*/
   
-#include "..\Components\sta350bw\STA350BW_Driver.h"
+#include "../Components/sta350bw/STA350BW_Driver.h"
 #include "x_nucleo_cca01m1.h"
   
   /** @addtogroup BSP
@@ -118,6 +118,11 @@ extern "C" {
 #define AUDIO_OUT1_PD_GPIO_CLK_ENABLE()   	__GPIOA_CLK_ENABLE()
 #define AUDIO_OUT1_PD_GPIO_CLK_DISABLE()  	__GPIOA_CLK_DISABLE()
 #define AUDIO_OUT1_PD_PIN                	GPIO_PIN_0
+  /* Fault line (STA350BW INT_LINE, open drain, low on fault) definitions */
+#define AUDIO_OUT1_INT_GPIO_PORT                GPIOA
+#define AUDIO_OUT1_INT_GPIO_CLK_ENABLE()        __GPIOA_CLK_ENABLE()
+#define AUDIO_OUT1_INT_PIN                      GPIO_PIN_1
+#define AUDIO_OUT1_INT_EXTI_IRQn                EXTI1_IRQn
   
   /* DEVICE 2 */ 
   /* I2S peripheral configuration defines */
@@ -155,10 +160,17 @@ extern "C" {
 #define AUDIO_OUT2_PD_GPIO_CLK_ENABLE()         __GPIOB_CLK_ENABLE()
 #define AUDIO_OUT2_PD_GPIO_CLK_DISABLE()        __GPIOB_CLK_DISABLE()
 #define AUDIO_OUT2_PD_PIN                       GPIO_PIN_0  
+  /* Fault line (STA350BW INT_LINE, open drain, low on fault) definitions */
+#define AUDIO_OUT2_INT_GPIO_PORT                GPIOC
+#define AUDIO_OUT2_INT_GPIO_CLK_ENABLE()        __GPIOC_CLK_ENABLE()
+#define AUDIO_OUT2_INT_PIN                      GPIO_PIN_0
+#define AUDIO_OUT2_INT_EXTI_IRQn                EXTI0_IRQn
   /* Select the interrupt preemption priority and subpriority for the IT/DMA interrupt */
 #define AUDIO_OUT_IRQ_PREPRIO                   6   /* Select the preemption priority level(0 is the highest) */
 #define DMA_MAX_SZE                             0xFFFF
 #define DMA_MAX(_X_)                            (((_X_) <= DMA_MAX_SZE)? (_X_):DMA_MAX_SZE)  
+  /* Biquads with an extended coefficient range (STA350BW_EXT_RANGE_BQ1..BQ7) */
+#define AUDIO_OUT_EXT_RANGE_BIQUADS             7
   /* Audio status definition */     
 #ifndef AUDIO_OK
 #define AUDIO_OK                                ((uint8_t)0)
@@ -184,7 +196,24 @@ extern "C" {
   uint8_t BSP_AUDIO_OUT_Resume(void *handle);
   uint8_t BSP_AUDIO_OUT_Stop(void *handle, uint32_t Option);;
   uint8_t BSP_AUDIO_OUT_SetVolume(void *handle, uint8_t channel, uint8_t value);
+  uint8_t BSP_AUDIO_OUT_SetVolumeRamp(void *handle, uint8_t channel, uint8_t value, uint16_t blocks);
+  uint8_t BSP_AUDIO_OUT_VolumeTask(void *handle);
+  uint8_t BSP_AUDIO_OUT_IsVolumeRamping(void *handle);
   uint8_t BSP_AUDIO_OUT_SetEq(void *handle, uint8_t ramBlock, uint8_t filterNumber, uint32_t * filterValues);
+  uint8_t BSP_AUDIO_OUT_SetEqBank(void *handle, uint8_t ramBlock, uint8_t channel, uint32_t * filterValues);
+  uint8_t BSP_AUDIO_OUT_SetEqRanges(void *handle, const uint8_t * ranges, uint8_t count);
+  uint8_t BSP_AUDIO_OUT_SetCrossover(void *handle, uint8_t ramBlock, uint8_t channel, uint32_t * filterValues, 
+                                     const uint8_t * ranges, uint8_t biquads);
+  uint8_t BSP_AUDIO_OUT_Resync(void *handle);
+  uint8_t BSP_AUDIO_OUT_BeginUpdate(void *handle);
+  uint8_t BSP_AUDIO_OUT_CommitUpdate(void *handle);
+  uint8_t BSP_AUDIO_OUT_SetLimiterMapping(void *handle, uint8_t channel, uint8_t limiter);
+  uint8_t BSP_AUDIO_OUT_SetLimiterMode(void *handle, uint8_t mode);
+  uint8_t BSP_AUDIO_OUT_SetLimiter(void *handle, uint8_t limiter, STA350BW_Limiter_t * config);
+  uint8_t BSP_AUDIO_OUT_FaultInit(void *handle);
+  uint8_t BSP_AUDIO_OUT_FaultTask(void *handle);
+  uint8_t BSP_AUDIO_OUT_GetStatus(void *handle, uint8_t *status);
+  void BSP_AUDIO_OUT_FaultCallback(uint16_t GPIO_Pin);
   uint8_t BSP_AUDIO_OUT_SetTone(void *handle, uint8_t toneGain);
   uint8_t BSP_AUDIO_OUT_SetMute(void *handle, uint8_t channel, uint8_t state);
   uint8_t BSP_AUDIO_OUT_SetFrequency(void *handle, uint32_t AudioFreq);
@@ -145,6 +145,7 @@ static uint8_t AUDIO_IN_Timer_Init(void);
 static uint8_t AUDIO_IN_Timer_Start(void);
 static void AUDIO_IN_I2S_MspInit(void);
 static void AUDIO_IN_SPI_MspInit(void);
+static void AUDIO_IN_PDM_Handoff(void);
 /**
 * @}
 */
@@ -350,6 +351,7 @@ uint8_t BSP_AUDIO_IN_Record(uint16_t * pbuf, uint32_t size)
 {  
   
   X_NUCLEO_CCA02M1_Handler.PDM_Data = pbuf;  
+  X_NUCLEO_CCA02M1_Handler.PDM_Ready = pbuf;  
   if(X_NUCLEO_CCA02M1_Handler.MicChannels > 2)
   {
     if(HAL_SPI_Receive_DMA(&hAudioInSPI, (uint8_t *)SPI_InternalBuffer, X_NUCLEO_CCA02M1_Handler.PdmBufferSize) != HAL_OK)
@@ -500,6 +502,46 @@ uint8_t BSP_AUDIO_IN_Resume(void)
   return AUDIO_OK;
 }
 
+/**
+* @brief  Sets a second PDM buffer, of the same size as the one passed to 
+*         BSP_AUDIO_IN_Record(...). When set, the demux fills the two buffers
+*         alternately so that the last filled one can be handed to a consumer
+*         (e.g. a DMA transfer) without copy while the next one is being filled.
+* @param  pbuf: second PDM buffer, NULL to go back to a single buffer
+* @note   Must be called before BSP_AUDIO_IN_Record(...). In this mode the 
+*         buffer to be used in the user callbacks is BSP_AUDIO_IN_GetPDMBuffer().
+*         A buffer is not written while BSP_AUDIO_IN_PDMBufferBusy() reports
+*         it in use, the frame is dropped instead.
+* @retval AUDIO_OK
+*/
+uint8_t BSP_AUDIO_IN_SetPDMDoubleBuffer(uint16_t *pbuf)
+{
+  X_NUCLEO_CCA02M1_Handler.PDM_Data_Alt = pbuf;
+  return AUDIO_OK;
+}
+
+/**
+* @brief  Returns the PDM buffer filled by the last demux, to be used in the 
+*         BSP_AUDIO_IN_HalfTransfer_CallBack / TransferComplete_CallBack.
+* @param  None
+* @retval Pointer to the byte-interleaved PDM data of all the microphones,
+*         NULL if the last frame was dropped in double buffer mode
+*/
+uint16_t *BSP_AUDIO_IN_GetPDMBuffer(void)
+{
+  return X_NUCLEO_CCA02M1_Handler.PDM_Ready;
+}
+
+/**
+* @brief  Returns the size of the PDM data produced at each demux.
+* @param  None
+* @retval Size in bytes, all the microphones included
+*/
+uint32_t BSP_AUDIO_IN_GetPDMBufferSize(void)
+{
+  return (X_NUCLEO_CCA02M1_Handler.PDM_Clock_Freq / 8) * X_NUCLEO_CCA02M1_Handler.MicChannels * N_MS_PER_INTERRUPT;
+}
+
 
 /**
 * @brief Rx Transfer completed callbacks. It performs demuxing of the bit-interleaved PDM streams into 
@@ -567,6 +609,7 @@ void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s)
     
   }
   
+  AUDIO_IN_PDM_Handoff();
   BSP_AUDIO_IN_TransferComplete_CallBack();
 }
 
@@ -634,6 +677,7 @@ void HAL_I2S_RxHalfCpltCallback(I2S_HandleTypeDef *hi2s)
     
   }
   
+  AUDIO_IN_PDM_Handoff();
   BSP_AUDIO_IN_HalfTransfer_CallBack();
 }
 
@@ -661,6 +705,20 @@ __weak void BSP_AUDIO_IN_HalfTransfer_CallBack(void)
   to prepare the next buffer pointer and its size. */
 }
 
+/**
+* @brief  Tells whether a PDM buffer is still in use by its consumer, checked
+*         by the double buffer mode before the demux writes into it again.
+* @param  pbuf: PDM buffer previously returned by BSP_AUDIO_IN_GetPDMBuffer()
+* @note   Being __weak it can be overwritten by the application, e.g. to 
+*         return USBD_AUDIO_PDM_IsBusy() when the buffers go to the USB bulk
+*         endpoint.
+* @retval 1 if the buffer must not be written, 0 otherwise
+*/
+__weak uint8_t BSP_AUDIO_IN_PDMBufferBusy(uint16_t *pbuf)
+{
+  return 0;
+}
+
 /**
 * @brief  Audio IN Error callback function
 * @param  None
@@ -738,6 +796,31 @@ __weak uint8_t BSP_AUDIO_IN_PDMToPCM_Init(uint32_t AudioFreq, uint32_t ChnlNbrIn
   
   return AUDIO_OK;
 }
+/**
+* @brief  Publishes the PDM buffer just filled and, in double buffer mode,
+*         moves the demux to the other buffer. If the other buffer is still
+*         held by its consumer the frame just filled is dropped: nothing is
+*         published and the demux fills the same buffer again.
+* @param  None
+* @retval None
+*/
+static void AUDIO_IN_PDM_Handoff(void)
+{
+  uint16_t *filled = X_NUCLEO_CCA02M1_Handler.PDM_Data;
+  
+  X_NUCLEO_CCA02M1_Handler.PDM_Ready = filled;
+  if(X_NUCLEO_CCA02M1_Handler.PDM_Data_Alt != NULL)
+  {
+    if(BSP_AUDIO_IN_PDMBufferBusy(X_NUCLEO_CCA02M1_Handler.PDM_Data_Alt))
+    {
+      X_NUCLEO_CCA02M1_Handler.PDM_Ready = NULL;
+      return;
+    }
+    X_NUCLEO_CCA02M1_Handler.PDM_Data = X_NUCLEO_CCA02M1_Handler.PDM_Data_Alt;
+    X_NUCLEO_CCA02M1_Handler.PDM_Data_Alt = filled;
+  }
+}
+
 /**
 * @brief AUDIO IN I2S MSP Init
 * @param None
@@ -85,6 +85,10 @@ typedef struct
   
   uint16_t * PDM_Data;      /*!< Takes track of the external PDM data buffer as passed by the user in the start function*/
   
+  uint16_t * PDM_Data_Alt;  /*!< Second external PDM buffer, when set the demux alternates between the two buffers*/
+  
+  uint16_t * PDM_Ready;     /*!< Last PDM buffer filled by the demux, NULL if its frame was dropped*/
+  
 }
 X_NUCLEO_CCA02M1_HandlerTypeDef;
   
@@ -279,6 +283,9 @@ extern I2S_HandleTypeDef                hAudioInI2s;
   uint8_t BSP_AUDIO_IN_PDMToPCM(uint16_t *PDMBuf, uint16_t *PCMBuf);
   uint8_t BSP_AUDIO_IN_ClockConfig(I2S_HandleTypeDef *hi2s, uint32_t AudioFreq, void *Params);
   uint8_t BSP_AUDIO_IN_PDMToPCM_Init(uint32_t AudioFreq, uint32_t ChnlNbrIn, uint32_t ChnlNbrOut);
+  uint8_t BSP_AUDIO_IN_SetPDMDoubleBuffer(uint16_t *pbuf);
+  uint16_t *BSP_AUDIO_IN_GetPDMBuffer(void);
+  uint32_t BSP_AUDIO_IN_GetPDMBufferSize(void);
 
 
 
@@ -289,6 +296,7 @@ extern I2S_HandleTypeDef                hAudioInI2s;
   void BSP_AUDIO_IN_TransferComplete_CallBack(void);
   void BSP_AUDIO_IN_HalfTransfer_CallBack(void);
   void BSP_AUDIO_IN_Error_Callback(void);
+  uint8_t BSP_AUDIO_IN_PDMBufferBusy(uint16_t *pbuf);
   
   /**
   * @}
@@ -49,6 +49,7 @@
 #include "cube_hal.h"
 #include "Fragment1.h"
 #include "BiquadCalculator.h"
+#include "LoudnessMeter.h"
 #include "stdlib.h"
 
 
@@ -68,6 +69,14 @@
 /** @defgroup AUDIO_APPLICATION_Private_Types 
 * @{
 */  
+/*EQ preset preloaded in a STA350BW RAM bank*/
+typedef struct
+{
+  uint32_t *Coefficients;  /* STA350BW_BIQUADS_PER_CHANNEL sets of 5 coefficients */
+  uint8_t  Bank;           /* STA350BW_RAM_BANK_FIRST .. STA350BW_RAM_BANK_THIRD */
+  uint8_t  Loaded;         /* Upload queued to the device */
+  const BIQUAD_Filter_t *Design; /* Design of each biquad, NULL for the legacy tables, which cannot be morphed */
+}EQ_Preset_t;
 
 /**
 * @}
@@ -80,7 +89,17 @@
 #define AUDIO_OUTPUT_BUFF_SIZE 512              /* Output buffer size for each channel */
 #define DEFAULT_SAMPLING_FREQUENCY 32000        /* Default Sampling frequency */
 #define DEFAULT_VOLUME 0x11                     /* Default Volume */
+#define VOLUME_RAMP_BLOCKS 16                   /* Volume changes are spread over 16 half-buffers (128 ms) */
 #define FILTER_NB 2
+#define PRESET_HPF 0                            /* Presets, one per STA350BW RAM bank */
+#define PRESET_BASS_BOOST 1
+#define PRESET_VOCAL 2
+#define PRESET_LOUDNESS 3                       /* Shares the PRESET_HPF bank, the two are morphed into each other */
+#define PRESET_NUMBER 4
+#define PRESET_QUEUE_ENTRIES (2 + 2 * STA350BW_BIQUADS_PER_CHANNEL) /* I2C writes to upload and reselect a bank */
+#define MORPH_STEPS 32                          /* Steps of a preset morph, one biquad of both channels per half-buffer */
+#define MORPH_QUEUE_ENTRIES 4                   /* I2C writes of one morph update: bank select and biquad, per channel */
+/* #define BIQUAD_BENCH */                      /* Time BQ_CALC_ComputeFilter, BQ_CALC_Fit, LOUDNESS_Feed and SPECTRUM_Process at init, results in Biquad_BenchCycles, Biquad_FitCycles, Loudness_FeedCycles and Spectrum_HopCycles */
 /**
 * @}
 */
@@ -94,6 +113,15 @@ uint32_t Init_AudioOut_Device(void);
 uint32_t Start_AudioOut_Device(void);
 uint32_t Stop_AudioOut_Device(void);
 uint32_t Switch_Demo(void);
+uint32_t Init_Presets(void);
+uint32_t Preset_Select(uint8_t preset);
+void Preset_Task(void);
+void Fault_Task(void);
+void Volume_Task(void);
+void Loudness_Read(LOUDNESS_Readings_t *pReadings);
+#ifdef BIQUAD_BENCH
+void Biquad_Bench(void);
+#endif
 
 
 /**
@@ -28,10 +28,39 @@
 /* Includes ------------------------------------------------------------------*/
 #include "BiquadCalculator.h"
 
+#include "arm_math.h"
+
 #ifndef NULL
 #define NULL      (void *) 0
 #endif
 
+#define BQ_CALC_LN10_20   0.115129255f          /* ln(10) / 20, dB to amplitude */
+#define BQ_CALC_LN10_80   0.028782314f          /* ln(10) / 80, sqrt of the shelf gain */
+#define BQ_CALC_LOG2E     1.442695041f
+#define BQ_CALC_LN2_HI    0.693145752f          /* ln(2) split for the range reduction */
+#define BQ_CALC_LN2_LO    1.428606820e-06f
+#define BQ_CALC_Q23       8388608.0f            /* 2^23, 1.23 coefficient format */
+
+#define BQ_CALC_SHARED_TRIG     0x01            /* Valid bits of BQ_CALC_Shared_t */
+#define BQ_CALC_SHARED_GAIN20   0x02
+#define BQ_CALC_SHARED_GAIN80   0x04
+
+/* Intermediate values reused by the next band when it has the same Fs and Fc, 
+or the same gain */
+typedef struct
+{
+  uint32_t Fs;
+  uint32_t Fc;
+  float SinW;
+  float CosW;
+  float K;
+  float W;
+  float GainDb;
+  float Gain20;
+  float Gain80;
+  uint8_t Valid;
+} BQ_CALC_Shared_t;
+
 /** @addtogroup MIDDLEWARES
 * @{
 */
@@ -40,189 +69,272 @@
 * @{
 */
 
-/** @defgroup SOUND_TERMINAL_BIQUAD_CALCULATOR_Functions 
+/** @defgroup SOUND_TERMINAL_BIQUAD_CALCULATOR_Private_Functions 
 * @{
 */
 
 /**
-* @brief        function for computing filter coefficient basing on 
-*               the filter parameters in the BIQUAD_Filter_t. Computed values 
-*               will be saved in the dedicated memory space inside the BIQUAD_Filter_t
-*               structure in order to be used to setup the device.
-* @param        *pEq: pointer to an istance of BIQUAD_Filter_t.
-* @retval       BIQUAD_CALCULATOR_ERROR if an error accurred. In any other case, 
-*               the return value is related to the range of the computed values.
-*               This parameter can be a value of 
-*               ref Biquad_Calculator_Return_values_definition
+* @brief        Single precision e^x: x = n * ln(2) + r with |r| <= ln(2) / 2, 
+*               degree 6 polynomial for e^r and 2^n set in the exponent field.
+*               Relative error below 2.5e-7 for |x| < 87.
+* @param        x: exponent
+* @retval       e^x
 */
-int32_t BQ_CALC_ComputeFilter(BIQUAD_Filter_t *pEq)
-{  
+static float BQ_CALC_Exp(float x)
+{
+  union
+  {
+    float f;
+    int32_t i;
+  } scale;
+  float r, p;
+  int32_t n;
   
-  float omega_c = 0, K = 0, W = 0, DE = 0, alpha = 0, beta = 0, a0 = 0, a1 = 0, a2 = 0,
-  b0 = 0, b1 = 0, b2 = 0;
-  float CoeffSTA350BW[K_NUM];
-  int32_t ret = 0;
+  if(x > 87.0f)
+  {
+    x = 87.0f;
+  }
+  else if(x < -87.0f)
+  {
+    x = -87.0f;
+  }
+  
+  p = x * BQ_CALC_LOG2E;
+  n = (int32_t)(p + ((p < 0.0f) ? -0.5f : 0.5f));
+  r = (x - (float)n * BQ_CALC_LN2_HI) - (float)n * BQ_CALC_LN2_LO;
+  
+  p = 1.0f + r * (1.0f + r * (0.5f + r * (1.0f / 6.0f + r * (1.0f / 24.0f + 
+      r * (1.0f / 120.0f + r * (1.0f / 720.0f))))));
+  scale.i = (n + 127) << 23;
   
-  if(pEq->Fs != 96000)
+  return p * scale.f;
+}
+
+/**
+* @brief        10^(Gain / 20) or 10^(Gain / 80), reusing the previous value 
+*               when the gain has not changed.
+* @param        *shared: values shared between bands.
+* @param        gainDb: gain in dB.
+* @param        which: BQ_CALC_SHARED_GAIN20 or BQ_CALC_SHARED_GAIN80.
+* @retval       linear gain
+*/
+static float BQ_CALC_Gain(BQ_CALC_Shared_t *shared, float gainDb, uint8_t which)
+{
+  if(!(shared->Valid & (BQ_CALC_SHARED_GAIN20 | BQ_CALC_SHARED_GAIN80)) || shared->GainDb != gainDb)
   {
-    omega_c = 2.0f * PI * (float) (pEq->Fc) / (float) (pEq->Fs * 2);
+    shared->Valid &= ~(BQ_CALC_SHARED_GAIN20 | BQ_CALC_SHARED_GAIN80);
+    shared->GainDb = gainDb;
   }
-  else
+  if(!(shared->Valid & which))
   {
-    omega_c = 2.0f * PI * (float) (pEq->Fc) / (float) (pEq->Fs);
+    if(which == BQ_CALC_SHARED_GAIN20)
+    {
+      shared->Gain20 = BQ_CALC_Exp(gainDb * BQ_CALC_LN10_20);
+    }
+    else
+    {
+      shared->Gain80 = BQ_CALC_Exp(gainDb * BQ_CALC_LN10_80);
+    }
+    shared->Valid |= which;
+  }
+  return (which == BQ_CALC_SHARED_GAIN20) ? shared->Gain20 : shared->Gain80;
+}
+
+/**
+* @brief        Computes the coefficients of one band, see BQ_CALC_ComputeFilter.
+* @param        *pEq: pointer to an istance of BIQUAD_Filter_t.
+* @param        *shared: values shared with the previous band.
+* @param        *CoeffSTA350BW: the K_NUM coefficients in the device order, 
+*               not quantized.
+* @retval       BIQUAD_CALCULATOR_OK, or BIQUAD_CALCULATOR_ERROR for an unknown type
+*/
+static int32_t BQ_CALC_Design(BIQUAD_Filter_t *pEq, BQ_CALC_Shared_t *shared, float *CoeffSTA350BW)
+{  
+  float sinW = 0.0f, cosW = 0.0f, K = 0.0f, W = 0.0f, kq = 0.0f, kd = 0.0f, 
+  kn = 0.0f, norm = 0.0f, alpha = 0.0f, beta = 0.0f, gain = 0.0f, a0 = 1.0f, 
+  a1 = 0.0f, a2 = 0.0f, b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+  
+  if(!(shared->Valid & BQ_CALC_SHARED_TRIG) || shared->Fs != pEq->Fs || shared->Fc != pEq->Fc)
+  {
+    float fs = (float)pEq->Fs;
     
+    if(pEq->Fs != 96000)
+    {
+      fs *= 2.0f;
+    }
+    /* omega_c = 2 * PI * Fc / fs, in degrees for the table based sine and cosine */
+    arm_sin_cos_f32(360.0f * (float)pEq->Fc / fs, &shared->SinW, &shared->CosW);
+    
+    /* tan(omega_c / 2) */
+    shared->K = shared->SinW / (1.0f + shared->CosW);
+    shared->W = shared->K * shared->K;
+    shared->Fs = pEq->Fs;
+    shared->Fc = pEq->Fc;
+    shared->Valid |= BQ_CALC_SHARED_TRIG;
   }
-  K = tanf(omega_c / 2.0f);
-  alpha = 1 + K;
-  W = K * K;
-  DE = 1.0f + (1 / pEq->Q) * K + W;
+  sinW = shared->SinW;
+  cosW = shared->CosW;
+  K = shared->K;
+  W = shared->W;
   
+
   switch (pEq->Type) {
   case BIQUAD_CALCULATOR_FO_LPF:
-    {
-      a0 = 1;
-      a1 = -((1.0f - K) / alpha);
-      b0 = K / alpha;
-      b1 = K / alpha;
-      a2 = 0;
-      b2 = 0;
-      break;
-    }
   case BIQUAD_CALCULATOR_FO_HPF:
     {
-      a0 = 1;
-      a1 = -((1.0f - K) / alpha);
-      b0 = 1 / alpha;
-      b1 = -b0;
-      a2 = 0;
-      b2 = 0;
+      norm = 1.0f / (1.0f + K);
+      a1 = -(1.0f - K) * norm;
+      if(pEq->Type == BIQUAD_CALCULATOR_FO_LPF)
+      {
+        b0 = K * norm;
+        b1 = b0;
+      }
+      else
+      {
+        b0 = norm;
+        b1 = -b0;
+      }
       break;
     }
   case BIQUAD_CALCULATOR_SO_LPF:
-    {
-      a0 = 1.0f;
-      a1 = 2.0f * (W - 1) / DE;
-      a2 = ((1 - (K / pEq->Q) + W) / DE);
-      b0 = W / DE;
-      b1 = 2.0f * b0;
-      b2 = b0;
-      break;
-    }
   case BIQUAD_CALCULATOR_SO_HPF:
     {
-      a0 = 1.0f;
-      a1 = 2.0f * (W - 1) / DE;
-      a2 = ((1 - (K / pEq->Q) + W) / DE);
-      b0 = 1.0f / DE;
-      b1 = -2.0f / DE;
+      kq = K / pEq->Q;
+      norm = 1.0f / (1.0f + kq + W);
+      a1 = 2.0f * (W - 1.0f) * norm;
+      a2 = (1.0f - kq + W) * norm;
+      if(pEq->Type == BIQUAD_CALCULATOR_SO_LPF)
+      {
+        b0 = W * norm;
+        b1 = 2.0f * b0;
+      }
+      else
+      {
+        b0 = norm;
+        b1 = -2.0f * norm;
+      }
       b2 = b0;
       break;
     }
-  case (BIQUAD_CALCULATOR_PEAK):
+  case BIQUAD_CALCULATOR_PEAK:
     {
-      float gain = expf((float)(pEq->Gain) * 0.115129254f);
-      if (gain < 1.0f)
+      /* The gain divides the pole term on cut and multiplies the zero term 
+      on boost */
+      gain = BQ_CALC_Gain(shared, pEq->Gain, BQ_CALC_SHARED_GAIN20);
+      kq = K / pEq->Q;
+      kd = kq;
+      kn = kq;
+      if(gain < 1.0f)
       {
-        float cutValue = 1.0f + K * (1/gain/pEq->Q) + W;
-        a0 = 1.0f;
-        a1 = 2.0f * (W - 1) / cutValue;
-        a2 = ((1 - (1/gain/pEq->Q) * K + W) / cutValue);
-        b0 = (1 + K/pEq->Q + W) / cutValue;
-        b1 = (2.0f * (W - 1)) / cutValue;
-        b2 = (1 - K/pEq->Q + W) / cutValue;
+        kd = kq / gain;
       }
       else
       {
-        float boostValue = 1 + 1/pEq->Q * K + W;
-        a0 = 1;
-        a1 = (2.0f * (W - 1)) / boostValue;
-        a2 = ((1 - (K / pEq->Q) + W) / boostValue);
-        b0 = (1 + K * gain / pEq->Q + W) / boostValue;
-        b1 = 2.0f * (W - 1) / boostValue;
-        b2 = (1 - K * gain / pEq->Q + W) / boostValue;
+        kn = kq * gain;
       }
+      norm = 1.0f / (1.0f + kd + W);
+      a1 = 2.0f * (W - 1.0f) * norm;
+      a2 = (1.0f - kd + W) * norm;
+      b0 = (1.0f + kn + W) * norm;
+      b1 = a1;
+      b2 = (1.0f - kn + W) * norm;
       break;
     }
   case BIQUAD_CALCULATOR_LOW_SHELF:
-    {
-      float gain = powf(10.0f, pEq->Gain/40.0f);
-      alpha = (sinf(omega_c) / 2.0f) * sqrtf((gain + (1.0f / gain)) * (1.0f / pEq->Slope - 1.0f) + 2.0f);
-      beta = 2.0f * alpha * sqrtf(gain);
-      a0 = (gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) + beta;
-      a1 = -2.0 * ((gain - 1.0f) + (gain + 1.0f) * cosf(omega_c));
-      a2 = (gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) - beta;
-      b0 = gain * ((gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) + beta);
-      b1 = 2.0f * gain * ((gain - 1.0f) - (gain + 1.0f) * cosf(omega_c));
-      b2 = gain * ((gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) - beta);
-      break;
-    }
   case BIQUAD_CALCULATOR_HIGH_SHELF:
     {
-      float gain = powf(10.0f, pEq->Gain/40.0f);
-      alpha = (sinf(omega_c) / 2.0f) * sqrtf((gain + (1.0f / gain)) * (1.0f / pEq->Slope - 1.0f) + 2.0f);
-      beta = 2.0f * alpha * sqrtf(gain);
-      a0 = (gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) + beta;
-      a1 = 2.0f * ((gain - 1.0f) - (gain + 1.0f) * cosf(omega_c));
-      a2 = (gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) - beta;
-      b0 = gain * ((gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) + beta);
-      b1 = -2.0f * gain * ((gain - 1.0f) + (gain + 1.0f) * cosf(omega_c));
-      b2 = gain * ((gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) - beta);
+      /* beta = 2 * sqrt(gain) * alpha, with gain = 10^(Gain / 40) */
+      float sqrtGain = BQ_CALC_Gain(shared, pEq->Gain, BQ_CALC_SHARED_GAIN80);
+      float gp1, gm1, cp1, cm1;
+      
+      gain = sqrtGain * sqrtGain;
+      alpha = 0.5f * sinW * sqrtf((gain + (1.0f / gain)) * (1.0f / pEq->Slope - 1.0f) + 2.0f);
+      beta = 2.0f * alpha * sqrtGain;
+      gp1 = gain + 1.0f;
+      gm1 = gain - 1.0f;
+      cp1 = gp1 * cosW;
+      cm1 = gm1 * cosW;
+      if(pEq->Type == BIQUAD_CALCULATOR_LOW_SHELF)
+      {
+        a0 = gp1 + cm1 + beta;
+        a1 = -2.0f * (gm1 + cp1);
+        a2 = gp1 + cm1 - beta;
+        b0 = gain * (gp1 - cm1 + beta);
+        b1 = 2.0f * gain * (gm1 - cp1);
+        b2 = gain * (gp1 - cm1 - beta);
+      }
+      else
+      {
+        a0 = gp1 - cm1 + beta;
+        a1 = 2.0f * (gm1 - cp1);
+        a2 = gp1 - cm1 - beta;
+        b0 = gain * (gp1 + cm1 + beta);
+        b1 = -2.0f * gain * (gm1 + cp1);
+        b2 = gain * (gp1 + cm1 - beta);
+      }
       break;
     }
   case BIQUAD_CALCULATOR_NOTCH:
-    {
-      alpha = sinf(omega_c)/(2*pEq->Q);
-      a0 = 1.0f + alpha;
-      a1 = -2.0f * cosf(omega_c);
-      a2 = 1.0f - alpha;
-      b0 = 1.0f;
-      b1 = -2.0f * cos(omega_c);
-      b2 = 1.0f;
-      break;
-    }
   case BIQUAD_CALCULATOR_ALL_PASS:
-    {
-      alpha = sinf(omega_c)/(2*pEq->Q);
-      a0 = 1.0f + alpha;
-      a1 = -2.0f * cosf(omega_c);
-      a2 = 1.0f - alpha;
-      b0 = 1.0f - alpha;
-      b1 = -2.0f * cos(omega_c);
-      b2 = 1.0f + alpha;
-      break;
-    }
   case BIQUAD_CALCULATOR_BAND_PASS:
     {
-      alpha = sinf(omega_c) / (2*pEq->Q);
-      float gain = powf(10.0, pEq->Gain / 20.0f);
+      alpha = 0.5f * sinW / pEq->Q;
       a0 = 1.0f + alpha;
-      a1 = -2.0f * cosf(omega_c);
+      a1 = -2.0f * cosW;
       a2 = 1.0f - alpha;
-      b0 = alpha * gain;
-      b1 = 0;
-      b2 = -b0;
+      if(pEq->Type == BIQUAD_CALCULATOR_NOTCH)
+      {
+        b0 = 1.0f;
+        b1 = a1;
+        b2 = 1.0f;
+      }
+      else if(pEq->Type == BIQUAD_CALCULATOR_ALL_PASS)
+      {
+        b0 = a2;
+        b1 = a1;
+        b2 = a0;
+      }
+      else
+      {
+        b0 = alpha * BQ_CALC_Gain(shared, pEq->Gain, BQ_CALC_SHARED_GAIN20);
+        b1 = 0.0f;
+        b2 = -b0;
+      }
       break;
     }
     
   default:
-    break;
+    return BIQUAD_CALCULATOR_ERROR;
   }
   
-  CoeffSTA350BW[0] = (b1 / 2.0f)/a0;
-  CoeffSTA350BW[1] = b2/a0;
-  CoeffSTA350BW[2] = (-a1 / 2.0f)/a0;  
-  CoeffSTA350BW[3] = -a2/a0;
-  CoeffSTA350BW[4] = (b0 / 2.0f)/a0;
+  norm = 1.0f / a0;
+  CoeffSTA350BW[0] = 0.5f * b1 * norm;
+  CoeffSTA350BW[1] = b2 * norm;
+  CoeffSTA350BW[2] = -0.5f * a1 * norm;  
+  CoeffSTA350BW[3] = -a2 * norm;
+  CoeffSTA350BW[4] = 0.5f * b0 * norm;
   
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @brief        Quantizes a band in 1.23 format without range shift, as 
+*               BQ_CALC_ComputeFilter has always done.
+* @param        *pEq: pointer to an istance of BIQUAD_Filter_t.
+* @param        *CoeffSTA350BW: the K_NUM coefficients from BQ_CALC_Design.
+* @retval       BIQUAD_CALCULATOR_ERROR or the range of the computed values
+*/
+static int32_t BQ_CALC_Quantize(BIQUAD_Filter_t *pEq, const float *CoeffSTA350BW)
+{
   float max_value = 0.0f;
-  float mult;
+  int32_t ret = 0;
   uint16_t i = 0;
   
   for (i = 0; i < K_NUM ; i++)
   {
-    if(fabs(CoeffSTA350BW[i]) > max_value)
+    if(fabsf(CoeffSTA350BW[i]) > max_value)
     {
-      max_value = fabs(CoeffSTA350BW[i]);
+      max_value = fabsf(CoeffSTA350BW[i]);
     }
   }  
   
@@ -243,16 +355,206 @@ int32_t BQ_CALC_ComputeFilter(BIQUAD_Filter_t *pEq)
     ret = BIQUAD_RANGE_ONE;
   }
   
-  mult = powf(2 , 23);
-  
   for (i = 0; i < K_NUM ; i++)
   {        
-    pEq->Coefficients[i]= (int32_t)((float)CoeffSTA350BW[i] * (float)mult);
+    pEq->Coefficients[i]= (int32_t)(CoeffSTA350BW[i] * BQ_CALC_Q23);
   } 
   
   return ret;  
 }
 
+/**
+* @}
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_CALCULATOR_Functions 
+* @{
+*/
+
+/**
+* @brief        function for computing filter coefficient basing on 
+*               the filter parameters in the BIQUAD_Filter_t. Computed values 
+*               will be saved in the dedicated memory space inside the BIQUAD_Filter_t
+*               structure in order to be used to setup the device.
+* @param        *pEq: pointer to an istance of BIQUAD_Filter_t.
+* @retval       BIQUAD_CALCULATOR_ERROR if an error accurred. In any other case, 
+*               the return value is related to the range of the computed values.
+*               This parameter can be a value of 
+*               ref Biquad_Calculator_Return_values_definition
+* @note         Single precision only: sine and cosine come from one 
+*               arm_sin_cos_f32 call and the dB gains from BQ_CALC_Exp. Over 
+*               the ranges checked by Utilities/BiquadCalc_Bench the 
+*               coefficients are within BQ_CALC_MAX_ERROR_LSB of the former 
+*               sinf/tanf/powf based computation.
+*/
+int32_t BQ_CALC_ComputeFilter(BIQUAD_Filter_t *pEq)
+{
+  BQ_CALC_Shared_t shared;
+  float coeff[K_NUM];
+  
+  shared.Valid = 0;
+  if(BQ_CALC_Design(pEq, &shared, coeff) != BIQUAD_CALCULATOR_OK)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  return BQ_CALC_Quantize(pEq, coeff);
+}
+
+/**
+* @brief        Computes a set of bands, such as a whole RAM bank. Sine, cosine 
+*               and gain are computed once for consecutive bands with the same 
+*               Fs and Fc, or the same gain, so list the bands of both 
+*               channels, or the two sides of a crossover, next to each other.
+* @param        *pEq: array of BIQUAD_Filter_t, the Coefficients of each 
+*               element are updated as by BQ_CALC_ComputeFilter.
+* @param        count: number of bands.
+* @param        *pCoefficients: if not NULL, receives count * K_NUM 24 bit 
+*               coefficients back to back, the layout taken by 
+*               BSP_AUDIO_OUT_SetEqBank for a single burst upload.
+* @retval       BIQUAD_CALCULATOR_ERROR if any band failed, otherwise the 
+*               widest range of the computed values.
+*               This parameter can be a value of 
+*               ref Biquad_Calculator_Return_values_definition
+*/
+int32_t BQ_CALC_ComputeFilters(BIQUAD_Filter_t *pEq, uint32_t count, uint32_t *pCoefficients)
+{
+  BQ_CALC_Shared_t shared;
+  float coeff[K_NUM];
+  int32_t range = BIQUAD_RANGE_ONE;
+  int32_t ret = 0;
+  uint32_t band = 0;
+  uint32_t i = 0;
+  
+  shared.Valid = 0;
+  for(band = 0; band < count; band++)
+  {
+    ret = BQ_CALC_Design(&pEq[band], &shared, coeff);
+    if(ret == BIQUAD_CALCULATOR_OK)
+    {
+      ret = BQ_CALC_Quantize(&pEq[band], coeff);
+    }
+    if(ret == BIQUAD_CALCULATOR_ERROR)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    if(ret > range)
+    {
+      range = ret;
+    }
+    if(pCoefficients != NULL)
+    {
+      for(i = 0; i < K_NUM; i++)
+      {
+        *pCoefficients++ = pEq[band].Coefficients[i] & 0xFFFFFF;
+      }
+    }
+  }
+  return range;
+}
+
+/**
+* @brief        Computes a filter directly in the device format, in the 
+*               smallest coefficient range that holds it: Coefficients are 
+*               rounded to 24 bit at the resolution of that range, ready to be 
+*               written with the extended range of the biquad set to the 
+*               returned value (STA350BW_EXT_RANGE_BQ1..BQ7), with no 
+*               BQ_CALC_ShiftCoefficients. The quantized filter is then checked 
+*               with BQ_CALC_CheckStability.
+* @param        *pEq: pointer to an istance of BIQUAD_Filter_t.
+* @param        minRange: smallest range allowed, BIQUAD_RANGE_ONE unless the 
+*               same biquad of the other channel needs a wider one.
+* @retval       BIQUAD_CALCULATOR_ERROR if the filter does not fit [-4 4) or 
+*               its quantized poles are not inside the unit circle, the range 
+*               otherwise.
+*               This parameter can be a value of 
+*               ref Biquad_Calculator_Return_values_definition
+*/
+int32_t BQ_CALC_ComputeFilterRange(BIQUAD_Filter_t *pEq, int32_t minRange)
+{
+  BQ_CALC_Shared_t shared;
+  float coeff[K_NUM];
+  int32_t q[K_NUM];
+  int32_t range = 0;
+  uint32_t i = 0;
+  
+  if(minRange != BIQUAD_RANGE_ONE && minRange != BIQUAD_RANGE_TWO && minRange != BIQUAD_RANGE_FOUR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  shared.Valid = 0;
+  if(BQ_CALC_Design(pEq, &shared, coeff) != BIQUAD_CALCULATOR_OK)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  for(range = minRange; range <= BIQUAD_RANGE_FOUR; range <<= 1)
+  {
+    float scale = BQ_CALC_Q23 / (float)range;
+    
+    /* Round to nearest, a coefficient fits when it is within -2^23..2^23-1 */
+    for(i = 0; i < K_NUM; i++)
+    {
+      float v = coeff[i] * scale;
+      
+      if(v >= BQ_CALC_Q23 - 0.5f || v < -BQ_CALC_Q23 - 0.5f)
+      {
+        break;
+      }
+      q[i] = (int32_t)((v < 0.0f) ? (v - 0.5f) : (v + 0.5f));
+    }
+    if(i == K_NUM)
+    {
+      break;
+    }
+  }
+  if(range > BIQUAD_RANGE_FOUR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  for(i = 0; i < K_NUM; i++)
+  {
+    pEq->Coefficients[i] = (uint32_t)q[i] & 0xFFFFFF;
+  }
+  if(BQ_CALC_CheckStability(pEq->Coefficients, range) != BIQUAD_CALCULATOR_OK)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  return range;
+}
+
+/**
+* @brief        Checks that the poles of a quantized biquad are strictly inside 
+*               the unit circle: |a2| < 1 and |a1| < 1 + a2. The test is done on 
+*               the integer values, so it is exact.
+* @param        *pCoefficients: K_NUM 24 bit coefficients in the device order.
+* @param        range: coefficient range the biquad is programmed with.
+*               This parameter can be a value of 
+*               ref Biquad_Calculator_Return_values_definition
+* @retval       BIQUAD_CALCULATOR_OK if stable, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_CheckStability(const uint32_t *pCoefficients, int32_t range)
+{
+  /* In units of range / 2^23: one, a1 = -2 * (-a1 / 2) and a2 = -(-a2) */
+  int32_t one = (int32_t)(0x800000 / range);
+  int32_t a1 = -2 * ((int32_t)(pCoefficients[2] << 8) >> 8);
+  int32_t a2 = -((int32_t)(pCoefficients[3] << 8) >> 8);
+  
+  if(range != BIQUAD_RANGE_ONE && range != BIQUAD_RANGE_TWO && range != BIQUAD_RANGE_FOUR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  if(a2 >= one || a2 <= -one)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  if(a1 >= one + a2 || a1 <= -(one + a2))
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  return BIQUAD_CALCULATOR_OK;
+}
+
 /**
 * @brief        Some Sound Terminal devices supports coefficients in the range 
 *               up to  float [-4 4).
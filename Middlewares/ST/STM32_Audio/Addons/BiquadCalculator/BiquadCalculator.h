@@ -42,6 +42,7 @@ extern "C" {
   
   
 #define K_NUM 5
+#define BQ_CALC_MAX_ERROR_LSB 16          /* Max coefficient difference with the former libm based version, 1.23 LSB */
   
   /** @addtogroup MIDDLEWARES
   * @{
@@ -118,6 +119,9 @@ extern "C" {
   /** @defgroup  SOUND_TERMINAL_BIQUAD_CALCULATOR_Functions 
   * @{ */  
   int32_t BQ_CALC_ComputeFilter(BIQUAD_Filter_t *pEq);
+  int32_t BQ_CALC_ComputeFilters(BIQUAD_Filter_t *pEq, uint32_t count, uint32_t *pCoefficients);
+  int32_t BQ_CALC_ComputeFilterRange(BIQUAD_Filter_t *pEq, int32_t minRange);
+  int32_t BQ_CALC_CheckStability(const uint32_t *pCoefficients, int32_t range);
   int32_t BQ_CALC_ShiftCoefficients(BIQUAD_Filter_t *pEq, uint8_t coeffRange);
   /**
   * @}
@@ -0,0 +1,220 @@
+/**
+******************************************************************************
+* @file    BiquadCrossover.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides the design of Linkwitz-Riley crossovers for the 
+*          Sound Terminal biquads, built from cascaded second order low and 
+*          high pass filters, and the response of their acoustic sum.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "BiquadCrossover.h"
+#include "BiquadResponse.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+#define BQ_XO_Q_LR2       0.5f                  /* Two first order Butterworth sections in one biquad */
+#define BQ_XO_Q_LR4       0.70710678f           /* Second order Butterworth */
+#define BQ_XO_DB_TO_LOG2  0.16609640f           /* log2(10) / 20 */
+#define BQ_XO_10_LOG2     3.0103000f            /* 10 * log10(2) */
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+* @{
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_CROSSOVER_Private_Functions 
+* @{
+*/
+
+/**
+* @brief        Changes the polarity of a biquad in the device format, by 
+*               negating its numerator (b1/2, b2 and b0/2).
+* @param        *pSet: K_NUM 24 bit coefficients.
+* @retval       None
+*/
+static void BQ_XO_Invert(uint32_t *pSet)
+{
+  static const uint8_t numerator[] = { 0, 1, 4 };
+  uint32_t i;
+  
+  for(i = 0; i < sizeof(numerator); i++)
+  {
+    int32_t c = (int32_t)(pSet[numerator[i]] << 8) >> 8;
+    
+    pSet[numerator[i]] = (uint32_t)(-c) & 0xFFFFFF;
+  }
+}
+
+/**
+* @}
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_CROSSOVER_Functions 
+* @{
+*/
+
+/**
+* @brief        Designs a Linkwitz-Riley crossover. Each side is a cascade of 
+*               identical second order sections (BIQUAD_CALCULATOR_SO_LPF and 
+*               BIQUAD_CALCULATOR_SO_HPF): one with Q = 0.5 for LR2, two 
+*               Butterworth ones for LR4. Both sides have the same poles, so 
+*               their sum is an all pass. The LR2 high pass comes out with 
+*               inverted polarity, without it the sum has a notch at Fc.
+*               Coefficients are computed with BQ_CALC_ComputeFilterRange, in 
+*               the same range on both sides since the range of a biquad is 
+*               shared by the two channels of a device.
+* @param        *pXo: crossover with Type, Fs and Fc set. Biquads, Low, High 
+*               and Ranges are filled in.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_ComputeCrossover(BQ_CALC_Crossover_t *pXo)
+{
+  BIQUAD_Filter_t low, high;
+  int32_t lowRange, highRange;
+  uint32_t i, j;
+  
+  if(pXo == NULL || (pXo->Type != BQ_CALC_CROSSOVER_LR2 && pXo->Type != BQ_CALC_CROSSOVER_LR4) ||
+     pXo->Fc == 0 || pXo->Fc >= pXo->Fs / 2)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  low.Type = BIQUAD_CALCULATOR_SO_LPF;
+  low.Fs = pXo->Fs;
+  low.Fc = pXo->Fc;
+  low.Q = (pXo->Type == BQ_CALC_CROSSOVER_LR2) ? BQ_XO_Q_LR2 : BQ_XO_Q_LR4;
+  low.Slope = 0.0f;
+  low.Gain = 0.0f;
+  high = low;
+  high.Type = BIQUAD_CALCULATOR_SO_HPF;
+  
+  lowRange = BQ_CALC_ComputeFilterRange(&low, BIQUAD_RANGE_ONE);
+  highRange = BQ_CALC_ComputeFilterRange(&high, BIQUAD_RANGE_ONE);
+  if(lowRange == BIQUAD_CALCULATOR_ERROR || highRange == BIQUAD_CALCULATOR_ERROR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  if(lowRange < highRange)
+  {
+    lowRange = BQ_CALC_ComputeFilterRange(&low, highRange);
+  }
+  else if(highRange < lowRange)
+  {
+    highRange = BQ_CALC_ComputeFilterRange(&high, lowRange);
+  }
+  if(lowRange == BIQUAD_CALCULATOR_ERROR || highRange == BIQUAD_CALCULATOR_ERROR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  /* The sections of a side are identical */
+  pXo->Biquads = pXo->Type / 2;
+  for(i = 0; i < pXo->Biquads; i++)
+  {
+    for(j = 0; j < K_NUM; j++)
+    {
+      pXo->Low[i * K_NUM + j] = low.Coefficients[j];
+      pXo->High[i * K_NUM + j] = high.Coefficients[j];
+    }
+    pXo->Ranges[i] = (uint8_t)lowRange;
+  }
+  if(pXo->Type == BQ_CALC_CROSSOVER_LR2)
+  {
+    BQ_XO_Invert(pXo->High);
+  }
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @brief        Magnitude of the sum of the two sides of a crossover, as the 
+*               woofer and tweeter add up on axis. It is 0 dB at every 
+*               frequency for a correct Linkwitz-Riley design, up to the 
+*               quantization of the coefficients.
+* @param        *pXo: crossover computed by BQ_CALC_ComputeCrossover.
+* @param        *pFreq: frequencies in Hz.
+* @param        count: number of frequencies.
+* @param        *pMagDb: magnitude in dB of each frequency.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_CrossoverSum(const BQ_CALC_Crossover_t *pXo, const float *pFreq, uint32_t count, float *pMagDb)
+{
+  float lowMag[BQ_CALC_RESPONSE_BLOCK];
+  float lowPhase[BQ_CALC_RESPONSE_BLOCK];
+  float highMag[BQ_CALC_RESPONSE_BLOCK];
+  float highPhase[BQ_CALC_RESPONSE_BLOCK];
+  uint32_t done = 0;
+  
+  if(pXo == NULL || pFreq == NULL || pMagDb == NULL)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  while(done < count)
+  {
+    uint32_t n = count - done;
+    uint32_t k;
+    
+    if(n > BQ_CALC_RESPONSE_BLOCK)
+    {
+      n = BQ_CALC_RESPONSE_BLOCK;
+    }
+    if(BQ_CALC_ResponseRange(pXo->Low, pXo->Ranges, pXo->Biquads, pXo->Fs, &pFreq[done], n, 
+                             lowMag, lowPhase) != BIQUAD_CALCULATOR_OK ||
+       BQ_CALC_ResponseRange(pXo->High, pXo->Ranges, pXo->Biquads, pXo->Fs, &pFreq[done], n, 
+                             highMag, highPhase) != BIQUAD_CALCULATOR_OK)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    
+    /* |L + H|^2 = |L|^2 + |H|^2 + 2 |L| |H| cos(arg(L) - arg(H)) */
+    for(k = 0; k < n; k++)
+    {
+      float l = exp2f(BQ_XO_DB_TO_LOG2 * lowMag[k]);
+      float h = exp2f(BQ_XO_DB_TO_LOG2 * highMag[k]);
+      float sum = l * l + h * h + 2.0f * l * h * cosf(lowPhase[k] - highPhase[k]);
+      
+      pMagDb[done + k] = BQ_XO_10_LOG2 * log2f(sum);
+    }
+    done += n;
+  }
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,101 @@
+/**
+******************************************************************************
+* @file    BiquadCrossover.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for BiquadCrossover.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BIQUAD_CROSSOVER_H
+#define __BIQUAD_CROSSOVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+  
+#include "BiquadCalculator.h"
+  
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+  
+  /** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+  * @{
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_CROSSOVER_Exported_Constants 
+  * @{
+  */
+#define BQ_CALC_CROSSOVER_LR2           ((uint32_t)2)   /*!< Linkwitz-Riley 12 dB/octave, one biquad per side */
+#define BQ_CALC_CROSSOVER_LR4           ((uint32_t)4)   /*!< Linkwitz-Riley 24 dB/octave, two biquads per side */
+#define BQ_CALC_CROSSOVER_MAX_BIQUADS   2               /*!< Biquads per side of the steepest crossover */
+  /**
+  * @}
+  */
+  
+  /** @defgroup SOUND_TERMINAL_BIQUAD_CROSSOVER_Exported_Types_Definitions 
+  * @{
+  */
+  
+  /** 
+  * @brief Two way crossover: a low pass and a high pass side, ready for the 
+  *        first biquads of two channels, or of two devices.
+  */ 
+  typedef struct
+  {
+    uint32_t    Type;                                                   /*!< BQ_CALC_CROSSOVER_LR2 or BQ_CALC_CROSSOVER_LR4 */
+    uint32_t    Fs;                                                     /*!< Sampling frequency */
+    uint32_t    Fc;                                                     /*!< Crossover frequency, both sides are at -6 dB */
+    uint32_t    Biquads;                                                /*!< Biquads per side, set by BQ_CALC_ComputeCrossover */
+    uint32_t    Low[BQ_CALC_CROSSOVER_MAX_BIQUADS * K_NUM];             /*!< Low pass side, 24 bit in the order of the device RAM */
+    uint32_t    High[BQ_CALC_CROSSOVER_MAX_BIQUADS * K_NUM];            /*!< High pass side, 24 bit in the order of the device RAM */
+    uint8_t     Ranges[BQ_CALC_CROSSOVER_MAX_BIQUADS];                  /*!< Range of each biquad, the same on both sides */
+  }BQ_CALC_Crossover_t;
+  
+  /**
+  * @}
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_CROSSOVER_Functions 
+  * @{ */  
+  int32_t BQ_CALC_ComputeCrossover(BQ_CALC_Crossover_t *pXo);
+  int32_t BQ_CALC_CrossoverSum(const BQ_CALC_Crossover_t *pXo, const float *pFreq, uint32_t count, float *pMagDb);
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BIQUAD_CROSSOVER_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,522 @@
+/**
+******************************************************************************
+* @file    BiquadFit.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides the fit of peak and shelving Sound Terminal 
+*          biquads to a measured magnitude response, for room correction 
+*          computed on the device.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "BiquadFit.h"
+#include "BiquadResponse.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+#define BQ_FIT_FC             0                 /* Parameters: log2 of Fc */
+#define BQ_FIT_GAIN           1                 /* gain in dB */
+#define BQ_FIT_Q              2                 /* log2 of Q, peak filters only */
+#define BQ_FIT_PARAMS         3
+#define BQ_FIT_SHELF_SLOPE    1.0f              /* Steepest shelf without overshoot */
+#define BQ_FIT_SHELF_SPLITS   8                 /* Corner frequencies tried for a new shelf */
+
+/* Search steps: first and smallest, in octaves for Fc and Q, in dB for the gain */
+static const float BQ_FIT_Step[BQ_FIT_PARAMS] = { 0.33f, 1.0f, 0.5f };
+static const float BQ_FIT_MinStep[BQ_FIT_PARAMS] = { 0.02f, 0.05f, 0.03f };
+
+/* One filter of the fit */
+typedef struct
+{
+  uint32_t Type;
+  float Param[BQ_FIT_PARAMS];
+  float Step[BQ_FIT_PARAMS];
+} BQ_FIT_Band_t;
+
+/* Fit in progress, on the BQ_CALC_FIT_POINTS grid */
+typedef struct
+{
+  const BQ_CALC_Fit_t *pFit;
+  float Freq[BQ_CALC_FIT_POINTS];                       /* Grid, Hz */
+  float Deviation[BQ_CALC_FIT_POINTS];                  /* Target - measure */
+  float Desired[BQ_CALC_FIT_POINTS];                    /* Deviation within the boost and cut limits */
+  float Sum[BQ_CALC_FIT_POINTS];                        /* Response of all the bands, dB */
+  float Resp[BQ_CALC_FIT_MAX_BIQUADS][BQ_CALC_FIT_POINTS];
+  BQ_FIT_Band_t Band[BQ_CALC_FIT_MAX_BIQUADS];
+  float Min[BQ_FIT_PARAMS];
+  float Max[BQ_FIT_PARAMS];
+  uint32_t Evaluations;
+} BQ_FIT_State_t;
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+* @{
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_FIT_Private_Functions 
+* @{
+*/
+
+/**
+* @brief        Linear interpolation of a measurement on a log frequency axis.
+* @param        *pFreq: increasing frequencies.
+* @param        *pVal: values at each frequency.
+* @param        count: number of points.
+* @param        f: frequency to interpolate at.
+* @retval       interpolated value, the closest end one out of the measurement
+*/
+static float BQ_FIT_Interpolate(const float *pFreq, const float *pVal, uint32_t count, float f)
+{
+  uint32_t lo = 0, hi = count - 1;
+  
+  if(f <= pFreq[0])
+  {
+    return pVal[0];
+  }
+  if(f >= pFreq[hi])
+  {
+    return pVal[hi];
+  }
+  while(hi - lo > 1)
+  {
+    uint32_t mid = (lo + hi) / 2;
+    
+    if(pFreq[mid] <= f)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return pVal[lo] + (pVal[hi] - pVal[lo]) * log2f(f / pFreq[lo]) / log2f(pFreq[hi] / pFreq[lo]);
+}
+
+/**
+* @brief        Response of one band on the grid, through BQ_CALC_ComputeFilter 
+*               so that it includes the coefficient quantization.
+* @param        *s: fit state.
+* @param        type: filter type.
+* @param        *pParam: BQ_FIT_PARAMS parameters.
+* @param        *pOut: response in dB.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+static int32_t BQ_FIT_Response(BQ_FIT_State_t *s, uint32_t type, const float *pParam, float *pOut)
+{
+  BIQUAD_Filter_t f;
+  
+  f.Type = type;
+  f.Fs = s->pFit->Fs;
+  f.Fc = (uint32_t)(exp2f(pParam[BQ_FIT_FC]) + 0.5f);
+  f.Q = exp2f(pParam[BQ_FIT_Q]);
+  f.Slope = BQ_FIT_SHELF_SLOPE;
+  f.Gain = pParam[BQ_FIT_GAIN];
+  s->Evaluations++;
+  if(BQ_CALC_ComputeFilter(&f) == BIQUAD_CALCULATOR_ERROR)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  return BQ_CALC_Response(&f, 1, s->Freq, BQ_CALC_FIT_POINTS, pOut, NULL);
+}
+
+/**
+* @brief        Mean square error with one band response replaced.
+* @param        *s: fit state.
+* @param        *pOld: response of the band in the sum, NULL if not in it.
+* @param        *pNew: response that replaces it.
+* @retval       mean square error in dB^2
+*/
+static float BQ_FIT_Cost(const BQ_FIT_State_t *s, const float *pOld, const float *pNew)
+{
+  float acc = 0.0f;
+  uint32_t k;
+  
+  for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+  {
+    float e = s->Desired[k] - s->Sum[k] - pNew[k];
+    
+    if(pOld != NULL)
+    {
+      e += pOld[k];
+    }
+    acc += e * e;
+  }
+  return acc / (float)BQ_CALC_FIT_POINTS;
+}
+
+/**
+* @brief        Pattern search of the parameters of one band, the others fixed: 
+*               each parameter moves by its step while the error drops, and 
+*               the step is halved when neither direction helps.
+* @param        *s: fit state.
+* @param        b: band index, its response is in the sum.
+* @param        cost: current mean square error.
+* @param        budget: evaluation count to stop at.
+* @retval       mean square error after the search
+*/
+static float BQ_FIT_Refine(BQ_FIT_State_t *s, uint32_t b, float cost, uint32_t budget)
+{
+  BQ_FIT_Band_t *band = &s->Band[b];
+  float resp[BQ_CALC_FIT_POINTS];
+  uint32_t params = (band->Type == BIQUAD_CALCULATOR_PEAK) ? BQ_FIT_PARAMS : BQ_FIT_Q;
+  uint32_t active = 1;
+  
+  while(active && s->Evaluations < budget)
+  {
+    uint32_t p;
+    
+    active = 0;
+    for(p = 0; p < params && s->Evaluations < budget; p++)
+    {
+      float dir = 1.0f;
+      uint32_t moved = 0;
+      uint32_t i, k;
+      
+      if(band->Step[p] < BQ_FIT_MinStep[p])
+      {
+        continue;
+      }
+      active = 1;
+      for(i = 0; i < 2 && !moved && s->Evaluations < budget; i++, dir = -dir)
+      {
+        float trial[BQ_FIT_PARAMS];
+        float c;
+        
+        for(k = 0; k < BQ_FIT_PARAMS; k++)
+        {
+          trial[k] = band->Param[k];
+        }
+        trial[p] += dir * band->Step[p];
+        trial[p] = (trial[p] < s->Min[p]) ? s->Min[p] : ((trial[p] > s->Max[p]) ? s->Max[p] : trial[p]);
+        if(trial[p] == band->Param[p] || BQ_FIT_Response(s, band->Type, trial, resp) != BIQUAD_CALCULATOR_OK)
+        {
+          continue;
+        }
+        c = BQ_FIT_Cost(s, s->Resp[b], resp);
+        if(c < cost)
+        {
+          for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+          {
+            s->Sum[k] += resp[k] - s->Resp[b][k];
+            s->Resp[b][k] = resp[k];
+          }
+          band->Param[p] = trial[p];
+          cost = c;
+          moved = 1;
+        }
+      }
+      if(!moved)
+      {
+        band->Step[p] *= 0.5f;
+      }
+    }
+  }
+  return cost;
+}
+
+/**
+* @brief        First guess of a new band from the error left: a peak on the 
+*               largest deviation, with the width where it stays above half, 
+*               or a shelf on the side where the mean deviation explains the 
+*               most error.
+* @param        *s: fit state.
+* @param        type: BIQUAD_CALCULATOR_PEAK, LOW_SHELF or HIGH_SHELF.
+* @param        *band: band to initialize.
+* @retval       None
+*/
+static void BQ_FIT_Guess(const BQ_FIT_State_t *s, uint32_t type, BQ_FIT_Band_t *band)
+{
+  float r[BQ_CALC_FIT_POINTS];
+  float octave = log2f(s->Freq[BQ_CALC_FIT_POINTS - 1] / s->Freq[0]) / (float)(BQ_CALC_FIT_POINTS - 1);
+  uint32_t k, best = 0;
+  
+  for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+  {
+    r[k] = s->Desired[k] - s->Sum[k];
+  }
+  band->Type = type;
+  band->Param[BQ_FIT_Q] = 0.0f;
+  
+  if(type == BIQUAD_CALCULATOR_PEAK)
+  {
+    uint32_t lo, hi;
+    float bw;
+    
+    for(k = 1; k < BQ_CALC_FIT_POINTS; k++)
+    {
+      if(fabsf(r[k]) > fabsf(r[best]))
+      {
+        best = k;
+      }
+    }
+    for(lo = best; lo > 0 && r[lo - 1] * r[best] > 0.0f && fabsf(r[lo - 1]) >= 0.5f * fabsf(r[best]); lo--)
+    {
+    }
+    for(hi = best; hi < BQ_CALC_FIT_POINTS - 1 && r[hi + 1] * r[best] > 0.0f && fabsf(r[hi + 1]) >= 0.5f * fabsf(r[best]); hi++)
+    {
+    }
+    /* Q of a band with bw octaves between its half gain points */
+    bw = exp2f((float)(hi - lo + 1) * octave);
+    band->Param[BQ_FIT_Q] = log2f(sqrtf(bw) / (bw - 1.0f));
+    band->Param[BQ_FIT_GAIN] = r[best];
+  }
+  else
+  {
+    float total = 0.0f, bestScore = -1.0f;
+    uint32_t j;
+    
+    for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+    {
+      total += r[k];
+    }
+    for(j = 1; j < BQ_FIT_SHELF_SPLITS; j++)
+    {
+      uint32_t split = j * BQ_CALC_FIT_POINTS / BQ_FIT_SHELF_SPLITS;
+      uint32_t n = (type == BIQUAD_CALCULATOR_LOW_SHELF) ? split : BQ_CALC_FIT_POINTS - split;
+      float part = 0.0f, mean, score;
+      
+      for(k = 0; k < split; k++)
+      {
+        part += r[k];
+      }
+      if(type == BIQUAD_CALCULATOR_HIGH_SHELF)
+      {
+        part = total - part;
+      }
+      mean = part / (float)n;
+      score = mean * mean * (float)n;
+      if(score > bestScore)
+      {
+        bestScore = score;
+        best = split;
+        band->Param[BQ_FIT_GAIN] = mean;
+      }
+    }
+  }
+  band->Param[BQ_FIT_FC] = log2f(s->Freq[best]);
+  for(k = 0; k < BQ_FIT_PARAMS; k++)
+  {
+    band->Param[k] = (band->Param[k] < s->Min[k]) ? s->Min[k] : ((band->Param[k] > s->Max[k]) ? s->Max[k] : band->Param[k]);
+    band->Step[k] = BQ_FIT_Step[k];
+  }
+}
+
+/**
+* @}
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_FIT_Functions 
+* @{
+*/
+
+/**
+* @brief        Fits peak and shelving filters to the deviation of a measured 
+*               magnitude response from a target, for the biquads of one 
+*               channel of a RAM bank. The measure is resampled on 
+*               BQ_CALC_FIT_POINTS log spaced frequencies of the correction 
+*               band and the correction is kept within the boost and cut 
+*               limits. Bands are added one at a time where the error left 
+*               is the largest, each one as the peak, low shelf or high 
+*               shelf that removes the most error, then all of them are 
+*               refined together. Every response goes through 
+*               BQ_CALC_ComputeFilter, so the fit includes the coefficient 
+*               quantization, and the run stops after 
+*               BQ_CALC_FIT_MAX_EVALUATIONS responses. Bands that do not 
+*               lower the error are left flat (0 dB peak).
+* @param        *pFit: measure, target and limits. InitialErrorDb, ErrorDb 
+*               and Evaluations are filled in.
+* @param        *pEq: pFit->Biquads filters, designed and with their 
+*               Coefficients computed by BQ_CALC_ComputeFilter.
+* @retval       BIQUAD_CALCULATOR_ERROR or the widest range of the computed 
+*               values, as BQ_CALC_ComputeFilters.
+*/
+int32_t BQ_CALC_Fit(BQ_CALC_Fit_t *pFit, BIQUAD_Filter_t *pEq)
+{
+  static const uint32_t Types[] = { BIQUAD_CALCULATOR_PEAK, BIQUAD_CALCULATOR_LOW_SHELF, BIQUAD_CALCULATOR_HIGH_SHELF };
+  BQ_FIT_State_t s;
+  float resp[BQ_CALC_FIT_POINTS];
+  float mean = 0.0f, cost = 0.0f, e = 0.0f;
+  int32_t range = BIQUAD_RANGE_ONE;
+  int32_t ret = 0;
+  uint32_t b, k, t, used = 0;
+  
+  if(pFit == NULL || pEq == NULL || pFit->pFreq == NULL || pFit->pMagDb == NULL || pFit->Count < 2 ||
+     pFit->Biquads == 0 || pFit->Biquads > BQ_CALC_FIT_MAX_BIQUADS || pFit->FreqLow <= 0.0f ||
+     pFit->FreqHigh <= pFit->FreqLow || pFit->FreqHigh > (float)pFit->Fs / 2.0f ||
+     pFit->MaxBoost < 0.0f || pFit->MaxCut < 0.0f)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  s.pFit = pFit;
+  s.Evaluations = 0;
+  s.Min[BQ_FIT_FC] = log2f(pFit->FreqLow);
+  s.Max[BQ_FIT_FC] = log2f(pFit->FreqHigh);
+  s.Min[BQ_FIT_GAIN] = -pFit->MaxCut;
+  s.Max[BQ_FIT_GAIN] = pFit->MaxBoost;
+  s.Min[BQ_FIT_Q] = log2f(BQ_CALC_FIT_MIN_Q);
+  s.Max[BQ_FIT_Q] = log2f(BQ_CALC_FIT_MAX_Q);
+  
+  /* Measure and target on the grid, a missing target is flat at the mean level */
+  for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+  {
+    s.Freq[k] = exp2f(s.Min[BQ_FIT_FC] + (s.Max[BQ_FIT_FC] - s.Min[BQ_FIT_FC]) * (float)k / (float)(BQ_CALC_FIT_POINTS - 1));
+    s.Deviation[k] = -BQ_FIT_Interpolate(pFit->pFreq, pFit->pMagDb, pFit->Count, s.Freq[k]);
+    mean += s.Deviation[k];
+  }
+  mean /= (float)BQ_CALC_FIT_POINTS;
+  for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+  {
+    if(pFit->pTargetDb != NULL)
+    {
+      s.Deviation[k] += BQ_FIT_Interpolate(pFit->pFreq, pFit->pTargetDb, pFit->Count, s.Freq[k]);
+    }
+    else
+    {
+      s.Deviation[k] -= mean;
+    }
+    s.Desired[k] = (s.Deviation[k] < s.Min[BQ_FIT_GAIN]) ? s.Min[BQ_FIT_GAIN] : 
+      ((s.Deviation[k] > s.Max[BQ_FIT_GAIN]) ? s.Max[BQ_FIT_GAIN] : s.Deviation[k]);
+    s.Sum[k] = 0.0f;
+    e += s.Deviation[k] * s.Deviation[k];
+  }
+  pFit->InitialErrorDb = sqrtf(e / (float)BQ_CALC_FIT_POINTS);
+  cost = BQ_FIT_Cost(&s, NULL, s.Sum);
+  
+  /* Greedy placement, each new band refined with a share of half the budget */
+  for(b = 0; b < pFit->Biquads; b++)
+  {
+    BQ_FIT_Band_t candidate;
+    float best = cost;
+    
+    s.Band[b].Type = BIQUAD_CALCULATOR_PEAK;
+    for(t = 0; t < sizeof(Types) / sizeof(Types[0]); t++)
+    {
+      float c;
+      
+      BQ_FIT_Guess(&s, Types[t], &candidate);
+      if(BQ_FIT_Response(&s, candidate.Type, candidate.Param, resp) != BIQUAD_CALCULATOR_OK)
+      {
+        continue;
+      }
+      c = BQ_FIT_Cost(&s, NULL, resp);
+      if(c < best)
+      {
+        best = c;
+        s.Band[b] = candidate;
+        for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+        {
+          s.Resp[b][k] = resp[k];
+        }
+      }
+    }
+    if(best >= cost)
+    {
+      break;
+    }
+    for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+    {
+      s.Sum[k] += s.Resp[b][k];
+    }
+    cost = BQ_FIT_Refine(&s, b, best, s.Evaluations + BQ_CALC_FIT_MAX_EVALUATIONS / (2 * pFit->Biquads));
+    used++;
+  }
+  
+  /* Joint refinement with the rest of the budget, smaller steps */
+  while(used > 0 && s.Evaluations < BQ_CALC_FIT_MAX_EVALUATIONS)
+  {
+    uint32_t start = s.Evaluations;
+    
+    for(b = 0; b < used; b++)
+    {
+      for(k = 0; k < BQ_FIT_PARAMS; k++)
+      {
+        s.Band[b].Step[k] = 0.25f * BQ_FIT_Step[k];
+      }
+      cost = BQ_FIT_Refine(&s, b, cost, BQ_CALC_FIT_MAX_EVALUATIONS);
+    }
+    if(s.Evaluations - start <= used * BQ_FIT_PARAMS * 2 * 3)
+    {
+      /* Every band only shrank its steps down to the end */
+      break;
+    }
+  }
+  
+  e = 0.0f;
+  for(k = 0; k < BQ_CALC_FIT_POINTS; k++)
+  {
+    float d = s.Deviation[k] - s.Sum[k];
+    
+    e += d * d;
+  }
+  pFit->ErrorDb = sqrtf(e / (float)BQ_CALC_FIT_POINTS);
+  pFit->Evaluations = s.Evaluations;
+  
+  for(b = 0; b < pFit->Biquads; b++)
+  {
+    pEq[b].Fs = pFit->Fs;
+    pEq[b].Slope = BQ_FIT_SHELF_SLOPE;
+    if(b < used)
+    {
+      pEq[b].Type = s.Band[b].Type;
+      pEq[b].Fc = (uint32_t)(exp2f(s.Band[b].Param[BQ_FIT_FC]) + 0.5f);
+      pEq[b].Q = exp2f(s.Band[b].Param[BQ_FIT_Q]);
+      pEq[b].Gain = s.Band[b].Param[BQ_FIT_GAIN];
+    }
+    else
+    {
+      pEq[b].Type = BIQUAD_CALCULATOR_PEAK;
+      pEq[b].Fc = 1000;
+      pEq[b].Q = 1.0f;
+      pEq[b].Gain = 0.0f;
+    }
+    ret = BQ_CALC_ComputeFilter(&pEq[b]);
+    if(ret == BIQUAD_CALCULATOR_ERROR)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    if(ret > range)
+    {
+      range = ret;
+    }
+  }
+  return range;
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
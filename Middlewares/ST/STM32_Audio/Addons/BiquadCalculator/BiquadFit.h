@@ -0,0 +1,109 @@
+/**
+******************************************************************************
+* @file    BiquadFit.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for BiquadFit.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BIQUAD_FIT_H
+#define __BIQUAD_FIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+  
+#include "BiquadCalculator.h"
+  
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+  
+  /** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+  * @{
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_FIT_Exported_Constants 
+  * @{
+  */
+#define BQ_CALC_FIT_MAX_BIQUADS         4       /*!< Biquads of a channel in one STA350BW RAM bank */
+#define BQ_CALC_FIT_POINTS              64      /*!< Log spaced points the fit is done on, sets the stack use */
+#define BQ_CALC_FIT_MAX_EVALUATIONS     600     /*!< Band responses computed at most, bounds the run time */
+#define BQ_CALC_FIT_MIN_Q               0.5f    /*!< Widest peak filter */
+#define BQ_CALC_FIT_MAX_Q               8.0f    /*!< Narrowest peak filter */
+  /**
+  * @}
+  */
+  
+  /** @defgroup SOUND_TERMINAL_BIQUAD_FIT_Exported_Types_Definitions 
+  * @{
+  */
+  
+  /** 
+  * @brief Room correction request: a measured magnitude response, the target 
+  *        and the limits of the correction. The last fields are set by 
+  *        BQ_CALC_Fit.
+  */ 
+  typedef struct
+  {
+    uint32_t            Fs;             /*!< Sampling frequency of the corrected stream */
+    const float         *pFreq;         /*!< Measurement frequencies in Hz, increasing */
+    const float         *pMagDb;        /*!< Measured magnitude in dB at each frequency */
+    const float         *pTargetDb;     /*!< Target in dB at each frequency, NULL for flat at the mean level of the band */
+    uint32_t            Count;          /*!< Number of measurement points */
+    float               FreqLow;        /*!< Lowest frequency corrected, Hz */
+    float               FreqHigh;       /*!< Highest frequency corrected, Hz, below Fs / 2 */
+    float               MaxBoost;       /*!< Largest boost in dB, filling room nulls wastes headroom */
+    float               MaxCut;         /*!< Largest cut in dB, positive */
+    uint32_t            Biquads;        /*!< Filters to fit, up to BQ_CALC_FIT_MAX_BIQUADS */
+    float               InitialErrorDb; /*!< RMS deviation from the target before the correction */
+    float               ErrorDb;        /*!< RMS deviation from the target after the correction */
+    uint32_t            Evaluations;    /*!< Band responses computed */
+  }BQ_CALC_Fit_t;
+  
+  /**
+  * @}
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_FIT_Functions 
+  * @{ */  
+  int32_t BQ_CALC_Fit(BQ_CALC_Fit_t *pFit, BIQUAD_Filter_t *pEq);
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BIQUAD_FIT_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
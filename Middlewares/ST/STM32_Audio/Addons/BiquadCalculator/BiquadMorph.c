@@ -0,0 +1,294 @@
+/**
+******************************************************************************
+* @file    BiquadMorph.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides click-free transitions between two sets of 
+*          Sound Terminal biquads, interpolated on their design parameters.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "BiquadMorph.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+* @{
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_MORPH_Private_Functions 
+* @{
+*/
+
+/**
+* @brief        Tells whether a filter type is flat at 0 dB gain.
+* @param        type: filter type.
+* @retval       1 for the peak and shelving filters, 0 otherwise
+*/
+static uint32_t BQ_MORPH_HasGain(uint32_t type)
+{
+  return type == BIQUAD_CALCULATOR_PEAK || type == BIQUAD_CALCULATOR_LOW_SHELF || 
+    type == BIQUAD_CALCULATOR_HIGH_SHELF;
+}
+
+/**
+* @brief        Tells whether two designs give the same filter.
+* @param        *pA: first design.
+* @param        *pB: second design.
+* @retval       1 if they are the same, or both flat, 0 otherwise
+*/
+static uint32_t BQ_MORPH_Same(const BIQUAD_Filter_t *pA, const BIQUAD_Filter_t *pB)
+{
+  if(BQ_MORPH_HasGain(pA->Type) && BQ_MORPH_HasGain(pB->Type) && pA->Gain == 0.0f && pB->Gain == 0.0f)
+  {
+    return 1;
+  }
+  return pA->Type == pB->Type && pA->Fc == pB->Fc && pA->Q == pB->Q && 
+    pA->Slope == pB->Slope && pA->Gain == pB->Gain;
+}
+
+/**
+* @brief        Geometric interpolation, for frequencies and quality factors.
+* @param        a: value at t = 0, positive.
+* @param        b: value at t = 1, positive.
+* @param        t: position, 0 to 1.
+* @retval       interpolated value
+*/
+static float BQ_MORPH_Log(float a, float b, float t)
+{
+  if(a <= 0.0f || b <= 0.0f)
+  {
+    return a + (b - a) * t;
+  }
+  return a * exp2f(t * log2f(b / a));
+}
+
+/**
+* @}
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_MORPH_Functions 
+* @{
+*/
+
+/**
+* @brief        Intermediate design between two filter designs. Filters of 
+*               the same type move along their parameters, frequency and Q 
+*               on a log scale, slope and gain in dB linearly. A peak or 
+*               shelving filter turns into another one through flat: the 
+*               gain of the first one goes to 0 dB over the first half, 
+*               that of the second one comes from 0 dB over the second 
+*               half, and a flat end only morphs the gain of the other one. 
+*               Other changes of type have no continuous path and switch at 
+*               the middle.
+* @param        *pFrom: design at t = 0.
+* @param        *pTo: design at t = 1.
+* @param        t: position, 0 to 1.
+* @param        *pOut: intermediate design, Coefficients are not computed.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_MorphPoint(const BIQUAD_Filter_t *pFrom, const BIQUAD_Filter_t *pTo, float t, BIQUAD_Filter_t *pOut)
+{
+  const BIQUAD_Filter_t *shape = pTo;
+  float gain = 0.0f;
+  
+  if(pFrom == NULL || pTo == NULL || pOut == NULL || pFrom->Fs != pTo->Fs)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  if(t <= 0.0f || t >= 1.0f)
+  {
+    *pOut = (t <= 0.0f) ? *pFrom : *pTo;
+    return BIQUAD_CALCULATOR_OK;
+  }
+  
+  if(pFrom->Type == pTo->Type)
+  {
+    pOut->Type = pTo->Type;
+    pOut->Fs = pTo->Fs;
+    pOut->Fc = (uint32_t)(BQ_MORPH_Log((float)pFrom->Fc, (float)pTo->Fc, t) + 0.5f);
+    pOut->Q = BQ_MORPH_Log(pFrom->Q, pTo->Q, t);
+    pOut->Slope = pFrom->Slope + (pTo->Slope - pFrom->Slope) * t;
+    pOut->Gain = pFrom->Gain + (pTo->Gain - pFrom->Gain) * t;
+    return BIQUAD_CALCULATOR_OK;
+  }
+  
+  if(!BQ_MORPH_HasGain(pFrom->Type) || !BQ_MORPH_HasGain(pTo->Type))
+  {
+    *pOut = (t < 0.5f) ? *pFrom : *pTo;
+    return BIQUAD_CALCULATOR_OK;
+  }
+  
+  if(pFrom->Gain == 0.0f)
+  {
+    gain = pTo->Gain * t;
+  }
+  else if(pTo->Gain == 0.0f)
+  {
+    shape = pFrom;
+    gain = pFrom->Gain * (1.0f - t);
+  }
+  else if(t < 0.5f)
+  {
+    shape = pFrom;
+    gain = pFrom->Gain * (1.0f - 2.0f * t);
+  }
+  else
+  {
+    gain = pTo->Gain * (2.0f * t - 1.0f);
+  }
+  *pOut = *shape;
+  pOut->Gain = gain;
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @brief        Prepares a transition between two sets of designs. Both sets 
+*               must have the same sampling frequency and coefficients in the 
+*               [-1 1) range, so that the range bits of the device do not 
+*               change during the transition.
+* @param        *pMorph: transition to initialize.
+* @param        *pFrom: designs the device holds, as BQ_CALC_ComputeFilter 
+*               input. They must stay valid during the transition.
+* @param        *pTo: designs to reach, same constraints.
+* @param        biquads: number of designs in each set, up to 
+*               BQ_CALC_MORPH_MAX_BIQUADS.
+* @param        steps: intermediate designs of each changing biquad, 1 
+*               switches at once.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_MorphInit(BQ_CALC_Morph_t *pMorph, const BIQUAD_Filter_t *pFrom, const BIQUAD_Filter_t *pTo, 
+                          uint32_t biquads, uint32_t steps)
+{
+  BIQUAD_Filter_t f;
+  uint32_t b;
+  
+  if(pMorph == NULL || pFrom == NULL || pTo == NULL || biquads == 0 || 
+     biquads > BQ_CALC_MORPH_MAX_BIQUADS || steps == 0)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  pMorph->Changed = 0;
+  for(b = 0; b < biquads; b++)
+  {
+    if(pFrom[b].Fs != pTo[b].Fs)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    f = pFrom[b];
+    if(BQ_CALC_ComputeFilter(&f) != BIQUAD_RANGE_ONE)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    f = pTo[b];
+    if(BQ_CALC_ComputeFilter(&f) != BIQUAD_RANGE_ONE)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    if(!BQ_MORPH_Same(&pFrom[b], &pTo[b]))
+    {
+      pMorph->Changed |= (1 << b);
+    }
+  }
+  
+  pMorph->pFrom = pFrom;
+  pMorph->pTo = pTo;
+  pMorph->Biquads = biquads;
+  pMorph->Steps = steps;
+  pMorph->Step = 0;
+  pMorph->Next = 0;
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @brief        Computes the next biquad update of a transition. Each step 
+*               updates every changing biquad once, the last step writes the 
+*               target designs, and unchanged biquads are never written. The 
+*               coefficients are those of BQ_CALC_ComputeFilter, in the 
+*               format of the preset tables. An intermediate design that 
+*               would leave the [-1 1) range is skipped, the biquad then 
+*               keeps its previous value for one more step.
+* @param        *pMorph: transition in progress.
+* @param        *pBiquad: index of the biquad to write.
+* @param        *pCoefficients: K_NUM 24 bit coefficients to write.
+* @retval       BIQUAD_CALCULATOR_OK with one update, BQ_CALC_MORPH_DONE at 
+*               the end of the transition, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_MorphNext(BQ_CALC_Morph_t *pMorph, uint32_t *pBiquad, uint32_t *pCoefficients)
+{
+  BIQUAD_Filter_t f;
+  uint32_t i;
+  
+  if(pMorph == NULL || pBiquad == NULL || pCoefficients == NULL)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  
+  while(pMorph->Step < pMorph->Steps)
+  {
+    while(pMorph->Next < pMorph->Biquads)
+    {
+      uint32_t b = pMorph->Next++;
+      
+      if(!(pMorph->Changed & (1 << b)))
+      {
+        continue;
+      }
+      BQ_CALC_MorphPoint(&pMorph->pFrom[b], &pMorph->pTo[b], 
+                         (float)(pMorph->Step + 1) / (float)pMorph->Steps, &f);
+      if(BQ_CALC_ComputeFilter(&f) != BIQUAD_RANGE_ONE)
+      {
+        continue;
+      }
+      for(i = 0; i < K_NUM; i++)
+      {
+        pCoefficients[i] = f.Coefficients[i] & 0xFFFFFF;
+      }
+      *pBiquad = b;
+      return BIQUAD_CALCULATOR_OK;
+    }
+    pMorph->Next = 0;
+    pMorph->Step++;
+  }
+  return BQ_CALC_MORPH_DONE;
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
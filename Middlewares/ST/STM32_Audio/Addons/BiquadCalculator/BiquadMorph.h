@@ -0,0 +1,103 @@
+/**
+******************************************************************************
+* @file    BiquadMorph.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for BiquadMorph.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BIQUAD_MORPH_H
+#define __BIQUAD_MORPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+  
+#include "BiquadCalculator.h"
+  
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+  
+  /** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+  * @{
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_MORPH_Exported_Constants 
+  * @{
+  */
+#define BQ_CALC_MORPH_MAX_BIQUADS       7                       /*!< Biquads of a STA350BW channel */
+#define BQ_CALC_MORPH_DONE              ((int32_t) 1)           /*!< BQ_CALC_MorphNext: the transition is over */
+  /**
+  * @}
+  */
+  
+  /** @defgroup SOUND_TERMINAL_BIQUAD_MORPH_Exported_Types_Definitions 
+  * @{
+  */
+  
+  /** 
+  * @brief Transition between two sets of filter designs, walked one biquad 
+  *        update at a time by BQ_CALC_MorphNext.
+  */ 
+  typedef struct
+  {
+    const BIQUAD_Filter_t       *pFrom;         /*!< Designs the transition starts from */
+    const BIQUAD_Filter_t       *pTo;           /*!< Designs the transition ends on */
+    uint32_t                    Biquads;        /*!< Number of designs in each set */
+    uint32_t                    Steps;          /*!< Intermediate designs of each changing biquad, the last one is pTo */
+    uint32_t                    Step;           /*!< Step in progress */
+    uint32_t                    Next;           /*!< Next biquad of the step */
+    uint32_t                    Changed;        /*!< Bit mask of the biquads that differ */
+  }BQ_CALC_Morph_t;
+  
+  /**
+  * @}
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_MORPH_Functions 
+  * @{ */  
+  int32_t BQ_CALC_MorphInit(BQ_CALC_Morph_t *pMorph, const BIQUAD_Filter_t *pFrom, const BIQUAD_Filter_t *pTo, 
+                            uint32_t biquads, uint32_t steps);
+  int32_t BQ_CALC_MorphNext(BQ_CALC_Morph_t *pMorph, uint32_t *pBiquad, uint32_t *pCoefficients);
+  int32_t BQ_CALC_MorphPoint(const BIQUAD_Filter_t *pFrom, const BIQUAD_Filter_t *pTo, float t, BIQUAD_Filter_t *pOut);
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BIQUAD_MORPH_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -30,6 +30,7 @@
 #define __BIQUAD_PRESETS_H
 
 #include "stdint.h"
+#include "BiquadCalculator.h"
 
 #ifdef __cplusplus
 extern "C" {  
@@ -51,6 +52,12 @@ extern uint32_t DIALOG_EQ_PRESET[];
 extern uint32_t BASS_BOOST1_EQ_PRESET[];
 extern uint32_t BASS_BOOST2_EQ_PRESET[];
 extern uint32_t BASS_BOOST3_EQ_PRESET[];
+
+/* Generated from BiquadPresets_Spec.h, see BiquadPresetsGen.c */
+extern uint32_t HPF_1K_EQ_PRESET[];
+extern uint32_t LOUDNESS_EQ_PRESET[];
+extern const BIQUAD_Filter_t HPF_1K_EQ_PRESET_DESIGN[];
+extern const BIQUAD_Filter_t LOUDNESS_EQ_PRESET_DESIGN[];
   
 #ifdef __cplusplus
 }
@@ -0,0 +1,71 @@
+/**
+******************************************************************************
+* @file    BiquadPresetsGen.c
+* @author  Central Labs
+* @version V1.0.0
+* @brief   EQ presets generated by Utilities/BiquadPreset_Gen from
+*          BiquadPresets_Spec.h. Do not edit, change the spec and
+*          run the generator again.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+#include "BiquadPresets.h"
+
+/*!< Second order high pass, Fc = 1 KHz
+    BQ1 SO_HPF     Fs 32000 Fc  1000 Q  0.80 Slope 0.00 Gain  +0.0 dB
+*/
+uint32_t HPF_1K_EQ_PRESET[] = 
+{ 
+  0x87ADDA, 0x785226, 0x7807CF, 0x8EC707, 0x3C2913,
+  0x000000, 0x000000, 0x000000, 0x000000, 0x400000,
+  0x000000, 0x000000, 0x000000, 0x000000, 0x400000,
+  0x000000, 0x000000, 0x000000, 0x000000, 0x400000
+};
+
+const BIQUAD_Filter_t HPF_1K_EQ_PRESET_DESIGN[] = 
+{ 
+  {BIQUAD_CALCULATOR_SO_HPF, 32000, 1000, 0.8f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 32000, 1000, 1.0f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 32000, 1000, 1.0f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 32000, 1000, 1.0f, 0.0f, 0.0f, {0}}
+};
+
+/*!< Loudness, +6 dB below 100 Hz and +3 dB above 8 KHz
+    BQ1 SO_HPF     Fs 32000 Fc    40 Q  0.71 Slope 0.00 Gain  +0.0 dB
+    BQ2 LOW_SHELF  Fs 32000 Fc   100 Q  0.00 Slope 1.00 Gain  +6.0 dB
+    BQ3 HIGH_SHELF Fs 32000 Fc  8000 Q  0.00 Slope 1.00 Gain  +3.0 dB
+*/
+uint32_t LOUDNESS_EQ_PRESET[] = 
+{ 
+  0x805A7F, 0x7FA581, 0x7FA560, 0x80B4BD, 0x3FD2C0,
+  0x80BFF2, 0x7E357D, 0x7F409B, 0x817C92, 0x402787,
+  0xAC098F, 0x3B9138, 0x374DC6, 0xD8BA94, 0x5282C5,
+  0x000000, 0x000000, 0x000000, 0x000000, 0x400000
+};
+
+const BIQUAD_Filter_t LOUDNESS_EQ_PRESET_DESIGN[] = 
+{ 
+  {BIQUAD_CALCULATOR_SO_HPF, 32000, 40, 0.71f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_LOW_SHELF, 32000, 100, 0.0f, 1.0f, 6.0f, {0}},
+  {BIQUAD_CALCULATOR_HIGH_SHELF, 32000, 8000, 0.0f, 1.0f, 3.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 32000, 1000, 1.0f, 0.0f, 0.0f, {0}}
+};
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
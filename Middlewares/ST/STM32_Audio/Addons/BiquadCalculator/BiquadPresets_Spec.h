@@ -0,0 +1,44 @@
+/**
+******************************************************************************
+* @file    BiquadPresets_Spec.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Design parameters of the generated EQ presets. This is not a 
+*          regular header: Utilities/BiquadPreset_Gen includes it to build 
+*          BiquadPresetsGen.c, the tables in STA350BW format.
+*
+*          PRESET(name, brief) starts a preset, each BAND(type, Fs, Fc, Q, 
+*          Slope, Gain) that follows is one biquad, computed with 
+*          BQ_CALC_ComputeFilter. Biquads not listed are flat.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+/* Second order high pass at 1 KHz, used by the demo at 32 KHz */
+PRESET(HPF_1K_EQ_PRESET, "Second order high pass, Fc = 1 KHz")
+BAND(BIQUAD_CALCULATOR_SO_HPF,    32000, 1000,  0.80f, 0.0f,  0.0f)
+
+/* Loudness compensation for small speakers at low listening levels */
+PRESET(LOUDNESS_EQ_PRESET, "Loudness, +6 dB below 100 Hz and +3 dB above 8 KHz")
+BAND(BIQUAD_CALCULATOR_SO_HPF,    32000, 40,    0.71f, 0.0f,  0.0f)
+BAND(BIQUAD_CALCULATOR_LOW_SHELF, 32000, 100,   0.0f,  1.0f,  6.0f)
+BAND(BIQUAD_CALCULATOR_HIGH_SHELF, 32000, 8000, 0.0f,  1.0f,  3.0f)
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
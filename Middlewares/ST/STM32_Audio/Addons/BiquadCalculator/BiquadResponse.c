@@ -0,0 +1,328 @@
+/**
+******************************************************************************
+* @file    BiquadResponse.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides the frequency response of a cascade of Sound 
+*          Terminal biquadratic filters, evaluated on blocks of frequencies 
+*          with the CMSIS DSP complex kernels.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "BiquadResponse.h"
+
+#include "arm_math.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+#define BQ_RESP_Q23_INV   1.1920929e-07f        /* 2^-23, 1.23 coefficient format */
+#define BQ_RESP_10_LOG2   3.0103000f            /* 10 * log10(2) */
+
+/* Biquad in the direct form: b0, b1, b2, a1, a2 with a0 = 1 */
+typedef struct
+{
+  float b0;
+  float b1;
+  float b2;
+  float a1;
+  float a2;
+} BQ_RESP_Biquad_t;
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+* @{
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_RESPONSE_Private_Functions 
+* @{
+*/
+
+/**
+* @brief        Rate the device runs the biquads at: input rates up to 48 KHz 
+*               are oversampled by 2, as assumed by BQ_CALC_ComputeFilter.
+* @param        Fs: input sampling frequency.
+* @retval       processing rate in Hz
+*/
+static float BQ_RESP_ProcessingRate(uint32_t Fs)
+{
+  return (Fs != 96000) ? 2.0f * (float)Fs : (float)Fs;
+}
+
+/**
+* @brief        Converts a biquad in STA350BW order (b1/2, b2, -a1/2, -a2, 
+*               b0/2) to the direct form.
+* @param        *pIn: 5 coefficients, 1.23 format sign extended to 32 bit.
+* @param        scale: value of one LSB, 2^-23 times the coefficient range.
+* @param        *pOut: biquad in direct form.
+* @retval       None
+*/
+static void BQ_RESP_FromDevice(const int32_t *pIn, float scale, BQ_RESP_Biquad_t *pOut)
+{
+  pOut->b1 = 2.0f * (float)pIn[0] * scale;
+  pOut->b2 = (float)pIn[1] * scale;
+  pOut->a1 = -2.0f * (float)pIn[2] * scale;
+  pOut->a2 = -(float)pIn[3] * scale;
+  pOut->b0 = 2.0f * (float)pIn[4] * scale;
+}
+
+/**
+* @brief        Accumulates c0 + c1 d + c2 d^2 of every biquad into a running 
+*               complex product, for a block of frequencies.
+* @param        *pE1: d of each frequency, interleaved complex.
+* @param        *pE2: d^2 of each frequency, interleaved complex.
+* @param        *pAcc: running product, interleaved complex, updated.
+* @param        *pPoly: scratch buffer, 2 * n floats.
+* @param        *pTmp: scratch buffer, 2 * n floats.
+* @param        c0, c1, c2: polynomial coefficients.
+* @param        n: number of frequencies.
+* @retval       pointer to the buffer now holding the product, pAcc or pTmp
+*/
+static float *BQ_RESP_Accumulate(float *pE1, float *pE2, float *pAcc, float *pPoly, 
+                                 float *pTmp, float c0, float c1, float c2, uint32_t n)
+{
+  uint32_t k;
+  
+  arm_scale_f32(pE1, c1, pPoly, 2 * n);
+  arm_scale_f32(pE2, c2, pTmp, 2 * n);
+  arm_add_f32(pPoly, pTmp, pPoly, 2 * n);
+  for(k = 0; k < n; k++)
+  {
+    pPoly[2 * k] += c0;
+  }
+  arm_cmplx_mult_cmplx_f32(pAcc, pPoly, pTmp, n);
+  return pTmp;
+}
+
+/**
+* @brief        Magnitude and phase of a cascade in direct form.
+* @param        *pBq: biquads.
+* @param        biquads: number of biquads.
+* @param        rate: processing rate in Hz.
+* @param        *pFreq: frequencies in Hz.
+* @param        count: number of frequencies.
+* @param        *pMagDb: magnitude in dB of each frequency.
+* @param        *pPhase: phase in radians of each frequency, NULL if not needed.
+* @retval       None
+*/
+static void BQ_RESP_Evaluate(const BQ_RESP_Biquad_t *pBq, uint32_t biquads, float rate, 
+                             const float *pFreq, uint32_t count, float *pMagDb, float *pPhase)
+{
+  float e1[2 * BQ_CALC_RESPONSE_BLOCK];
+  float e2[2 * BQ_CALC_RESPONSE_BLOCK];
+  float bufA[2 * BQ_CALC_RESPONSE_BLOCK];
+  float bufB[2 * BQ_CALC_RESPONSE_BLOCK];
+  float bufC[2 * BQ_CALC_RESPONSE_BLOCK];
+  float poly[2 * BQ_CALC_RESPONSE_BLOCK];
+  float degPerHz = 180.0f / rate;
+  uint32_t done = 0;
+  
+  while(done < count)
+  {
+    uint32_t n = count - done;
+    float *num = bufA;
+    float *den = bufB;
+    float *spare = bufC;
+    float *res;
+    uint32_t k, b;
+    
+    if(n > BQ_CALC_RESPONSE_BLOCK)
+    {
+      n = BQ_CALC_RESPONSE_BLOCK;
+    }
+    
+    /* Polynomials in d = z^-1 - 1 = -2 sin^2(w / 2) - j sin(w), their 
+    coefficients are exact sums of the 1.23 values: no cancellation at low 
+    frequencies where the response of high pass and shelving filters is set */
+    for(k = 0; k < n; k++)
+    {
+      float s, c;
+      
+      arm_sin_cos_f32(degPerHz * pFreq[done + k], &s, &c);
+      e1[2 * k] = -2.0f * s * s;
+      e1[2 * k + 1] = -2.0f * s * c;
+      num[2 * k] = 1.0f;
+      num[2 * k + 1] = 0.0f;
+      den[2 * k] = 1.0f;
+      den[2 * k + 1] = 0.0f;
+    }
+    arm_cmplx_mult_cmplx_f32(e1, e1, e2, n);
+    
+    /* Running products of the numerators and of the denominators */
+    for(b = 0; b < biquads; b++)
+    {
+      res = BQ_RESP_Accumulate(e1, e2, num, poly, spare, pBq[b].b0 + pBq[b].b1 + pBq[b].b2, 
+                               pBq[b].b1 + 2.0f * pBq[b].b2, pBq[b].b2, n);
+      spare = num;
+      num = res;
+      res = BQ_RESP_Accumulate(e1, e2, den, poly, spare, 1.0f + pBq[b].a1 + pBq[b].a2, 
+                               pBq[b].a1 + 2.0f * pBq[b].a2, pBq[b].a2, n);
+      spare = den;
+      den = res;
+    }
+    
+    /* |H|^2 = |num|^2 / |den|^2, arg(H) = arg(num * conj(den)) */
+    arm_cmplx_mag_squared_f32(num, e2, n);
+    arm_cmplx_mag_squared_f32(den, e2 + BQ_CALC_RESPONSE_BLOCK, n);
+    for(k = 0; k < n; k++)
+    {
+      pMagDb[done + k] = BQ_RESP_10_LOG2 * (log2f(e2[k]) - log2f(e2[BQ_CALC_RESPONSE_BLOCK + k]));
+    }
+    if(pPhase != NULL)
+    {
+      arm_cmplx_conj_f32(den, poly, n);
+      arm_cmplx_mult_cmplx_f32(num, poly, spare, n);
+      for(k = 0; k < n; k++)
+      {
+        pPhase[done + k] = atan2f(spare[2 * k + 1], spare[2 * k]);
+      }
+    }
+    done += n;
+  }
+}
+
+/**
+* @}
+*/
+
+/** @defgroup SOUND_TERMINAL_BIQUAD_RESPONSE_Functions 
+* @{
+*/
+
+/**
+* @brief        Frequency response of a cascade of filters designed with 
+*               BQ_CALC_ComputeFilter or BQ_CALC_ComputeFilters.
+* @param        *pEq: filters, with the Coefficients as computed, before any 
+*               BQ_CALC_ShiftCoefficients. All must have the same Fs.
+* @param        filters: number of filters, up to BQ_CALC_RESPONSE_MAX_BIQUADS.
+* @param        *pFreq: frequencies in Hz.
+* @param        count: number of frequencies.
+* @param        *pMagDb: magnitude in dB of each frequency.
+* @param        *pPhase: phase in radians of each frequency, NULL if not needed.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_Response(const BIQUAD_Filter_t *pEq, uint32_t filters, const float *pFreq, 
+                         uint32_t count, float *pMagDb, float *pPhase)
+{
+  BQ_RESP_Biquad_t bq[BQ_CALC_RESPONSE_MAX_BIQUADS];
+  uint32_t i;
+  
+  if(pEq == NULL || filters == 0 || filters > BQ_CALC_RESPONSE_MAX_BIQUADS || pMagDb == NULL)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  for(i = 0; i < filters; i++)
+  {
+    if(pEq[i].Fs != pEq[0].Fs)
+    {
+      return BIQUAD_CALCULATOR_ERROR;
+    }
+    BQ_RESP_FromDevice((const int32_t *)pEq[i].Coefficients, BQ_RESP_Q23_INV, &bq[i]);
+  }
+  BQ_RESP_Evaluate(bq, filters, BQ_RESP_ProcessingRate(pEq[0].Fs), pFreq, count, pMagDb, pPhase);
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @brief        Frequency response of a cascade given as STA350BW coefficients, 
+*               such as the presets in BiquadPresets.c.
+* @param        *pCoefficients: biquads * 5 coefficients, 24 bit in the 
+*               [-1 1) range, in the order of the device RAM.
+* @param        biquads: number of biquads, up to BQ_CALC_RESPONSE_MAX_BIQUADS.
+* @param        Fs: sampling frequency.
+* @param        *pFreq: frequencies in Hz.
+* @param        count: number of frequencies.
+* @param        *pMagDb: magnitude in dB of each frequency.
+* @param        *pPhase: phase in radians of each frequency, NULL if not needed.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_ResponseFixed(const uint32_t *pCoefficients, uint32_t biquads, uint32_t Fs, 
+                              const float *pFreq, uint32_t count, float *pMagDb, float *pPhase)
+{
+  return BQ_CALC_ResponseRange(pCoefficients, NULL, biquads, Fs, pFreq, count, pMagDb, pPhase);
+}
+
+/**
+* @brief        Frequency response of a cascade given as STA350BW coefficients 
+*               with extended ranges, such as the filters of 
+*               BQ_CALC_ComputeFilterRange.
+* @param        *pCoefficients: biquads * 5 coefficients, 24 bit, in the order 
+*               of the device RAM.
+* @param        *pRanges: range of each biquad, 1, 2 or 4. NULL if all the 
+*               biquads are in the [-1 1) range.
+* @param        biquads: number of biquads, up to BQ_CALC_RESPONSE_MAX_BIQUADS.
+* @param        Fs: sampling frequency.
+* @param        *pFreq: frequencies in Hz.
+* @param        count: number of frequencies.
+* @param        *pMagDb: magnitude in dB of each frequency.
+* @param        *pPhase: phase in radians of each frequency, NULL if not needed.
+* @retval       BIQUAD_CALCULATOR_OK if correct operations, BIQUAD_CALCULATOR_ERROR otherwise
+*/
+int32_t BQ_CALC_ResponseRange(const uint32_t *pCoefficients, const uint8_t *pRanges, uint32_t biquads, 
+                              uint32_t Fs, const float *pFreq, uint32_t count, float *pMagDb, float *pPhase)
+{
+  BQ_RESP_Biquad_t bq[BQ_CALC_RESPONSE_MAX_BIQUADS];
+  int32_t set[K_NUM];
+  uint32_t range = BIQUAD_RANGE_ONE;
+  uint32_t i, j;
+  
+  if(pCoefficients == NULL || biquads == 0 || biquads > BQ_CALC_RESPONSE_MAX_BIQUADS || pMagDb == NULL)
+  {
+    return BIQUAD_CALCULATOR_ERROR;
+  }
+  for(i = 0; i < biquads; i++)
+  {
+    if(pRanges != NULL)
+    {
+      range = pRanges[i];
+      if(range != BIQUAD_RANGE_ONE && range != BIQUAD_RANGE_TWO && range != BIQUAD_RANGE_FOUR)
+      {
+        return BIQUAD_CALCULATOR_ERROR;
+      }
+    }
+    for(j = 0; j < K_NUM; j++)
+    {
+      /* Sign extension of the 24 bit value */
+      set[j] = (int32_t)(pCoefficients[i * K_NUM + j] << 8) >> 8;
+    }
+    BQ_RESP_FromDevice(set, (float)range * BQ_RESP_Q23_INV, &bq[i]);
+  }
+  BQ_RESP_Evaluate(bq, biquads, BQ_RESP_ProcessingRate(Fs), pFreq, count, pMagDb, pPhase);
+  return BIQUAD_CALCULATOR_OK;
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,81 @@
+/**
+******************************************************************************
+* @file    BiquadResponse.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for BiquadResponse.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BIQUAD_RESPONSE_H
+#define __BIQUAD_RESPONSE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+  
+#include "BiquadCalculator.h"
+  
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+  
+  /** @addtogroup SOUND_TERMINAL_BIQUAD_CALCULATOR
+  * @{
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_RESPONSE_Exported_Constants 
+  * @{
+  */
+#define BQ_CALC_RESPONSE_BLOCK          32      /*!< Frequencies evaluated together, sets the stack use (6 * 2 * 32 floats) */
+#define BQ_CALC_RESPONSE_MAX_BIQUADS    16      /*!< Longest cascade */
+  /**
+  * @}
+  */
+  
+  /** @defgroup  SOUND_TERMINAL_BIQUAD_RESPONSE_Functions 
+  * @{ */  
+  int32_t BQ_CALC_Response(const BIQUAD_Filter_t *pEq, uint32_t filters, const float *pFreq, 
+                           uint32_t count, float *pMagDb, float *pPhase);
+  int32_t BQ_CALC_ResponseFixed(const uint32_t *pCoefficients, uint32_t biquads, uint32_t Fs, 
+                                const float *pFreq, uint32_t count, float *pMagDb, float *pPhase);
+  int32_t BQ_CALC_ResponseRange(const uint32_t *pCoefficients, const uint8_t *pRanges, uint32_t biquads, 
+                                uint32_t Fs, const float *pFreq, uint32_t count, float *pMagDb, float *pPhase);
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+  /**
+  * @}
+  */
+  
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BIQUAD_RESPONSE_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,385 @@
+/**
+******************************************************************************
+* @file    LoudnessMeter.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides a streaming loudness meter after ITU-R BS.1770:
+*          K-weighting with q31 biquads designed by BiquadCalculator,
+*          momentary (400 ms), short-term (3 s) and gated integrated
+*          loudness in LUFS.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "LoudnessMeter.h"
+#include "string.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup LOUDNESS_METER
+* @{
+*/
+
+/** @defgroup LOUDNESS_METER_Private_Defines
+* @{
+*/
+#define LOUDNESS_INPUT_SHIFT      14              /* 16 bit PCM to q31, 12 dB of headroom for the shelf */
+#define LOUDNESS_POWER_SCALE      5.6843419e-14f  /* 2^-44: 16.48 power of the shifted input to full scale */
+#define LOUDNESS_OFFSET           (-0.691f)       /* BS.1770: 0 LUFS for a 0 dBFS 997 Hz sine on two channels */
+#define LOUDNESS_10_LOG2          3.0103000f      /* 10 * log10(2) */
+#define LOUDNESS_HPF_FC           38.135471f      /* BS.1770 high pass, exact */
+#define LOUDNESS_HPF_Q            0.5003270f
+/**
+* @}
+*/
+
+/** @defgroup LOUDNESS_METER_Private_Variables
+* @{
+*/
+/* BS.1770 K-weighting: a +4 dB high shelf with its poles at 1682 Hz, Q 0.707,
+then a 38 Hz high pass with Q 0.5. The shelf of BiquadCalculator has its poles
+at Fc * 10^(Gain / 40), hence 1499 Hz with slope 1. Fs is set by LOUDNESS_Init. */
+static const BIQUAD_Filter_t LOUDNESS_KWeighting[LOUDNESS_STAGES] =
+{
+  {BIQUAD_CALCULATOR_HIGH_SHELF, 0, 1499, 0.0f, 1.0f, 4.0f, {0}},
+  {BIQUAD_CALCULATOR_SO_HPF, 0, 38, 0.5003f, 0.0f, 0.0f, {0}}
+};
+/**
+* @}
+*/
+
+/** @defgroup LOUDNESS_METER_Private_Functions
+* @{
+*/
+
+/**
+* @brief        Loudness of a mean square.
+* @param        energy: sum over the channels of their mean square, 1 for
+*               a full scale sine on two channels.
+* @retval       loudness in LUFS, LOUDNESS_SILENCE at least
+*/
+static float32_t LOUDNESS_Lufs(float32_t energy)
+{
+  float32_t lufs;
+
+  if(energy <= 1.0e-12f)
+  {
+    return LOUDNESS_SILENCE;
+  }
+  lufs = LOUDNESS_OFFSET + LOUDNESS_10_LOG2 * log2f(energy);
+  return (lufs < LOUDNESS_SILENCE) ? LOUDNESS_SILENCE : lufs;
+}
+
+/**
+* @brief        Mean of the last sub-blocks.
+* @param        *pHandler: meter.
+* @param        count: number of sub-blocks, up to LOUDNESS_SHORT_TERM_SUBBLOCKS.
+* @retval       mean energy, 0 without sub-blocks
+*/
+static float32_t LOUDNESS_Mean(LOUDNESS_Handler_t *pHandler, uint32_t count)
+{
+  uint32_t idx = pHandler->Next;
+  float32_t sum = 0.0f;
+  uint32_t i;
+
+  if(count > pHandler->SubBlocks)
+  {
+    count = pHandler->SubBlocks;
+  }
+  for(i = 0; i < count; i++)
+  {
+    idx = (idx == 0) ? LOUDNESS_SHORT_TERM_SUBBLOCKS - 1 : idx - 1;
+    sum += pHandler->SubEnergy[idx];
+  }
+  return (count == 0) ? 0.0f : sum / (float32_t)count;
+}
+
+/**
+* @brief        Gated integrated loudness: mean energy of the blocks above
+*               the absolute gate and within LOUDNESS_RELATIVE_GATE of their
+*               own loudness. The relative gate is applied per bin of the
+*               histogram, to the exact energy of its blocks.
+* @param        *pHandler: meter.
+* @retval       loudness in LUFS, LOUDNESS_SILENCE without gated blocks
+*/
+static float32_t LOUDNESS_Integrated(LOUDNESS_Handler_t *pHandler)
+{
+  float32_t gate;
+  float32_t sum = 0.0f;
+  uint32_t count = 0;
+  int32_t bin;
+
+  if(pHandler->GatedBlocks == 0)
+  {
+    return LOUDNESS_SILENCE;
+  }
+  gate = LOUDNESS_Lufs(pHandler->GatedSum / (float32_t)pHandler->GatedBlocks) + LOUDNESS_RELATIVE_GATE;
+  if(gate < LOUDNESS_ABSOLUTE_GATE)
+  {
+    gate = LOUDNESS_ABSOLUTE_GATE;
+  }
+
+  /* First bin whose center passes the gate */
+  for(bin = (int32_t)((gate - LOUDNESS_ABSOLUTE_GATE) / LOUDNESS_HIST_STEP + 0.5f); bin < LOUDNESS_HIST_BINS; bin++)
+  {
+    sum += pHandler->HistEnergy[bin];
+    count += pHandler->Histogram[bin];
+  }
+  return (count == 0) ? LOUDNESS_SILENCE : LOUDNESS_Lufs(sum / (float32_t)count);
+}
+
+/**
+* @brief        Closes a sub-block: updates the gating and publishes the
+*               readings.
+* @param        *pHandler: meter.
+* @retval       None
+*/
+static void LOUDNESS_SubBlock(LOUDNESS_Handler_t *pHandler)
+{
+  uint32_t next = pHandler->Published ^ 1;
+  LOUDNESS_Readings_t *readings = &pHandler->Readings[next];
+  float32_t momentary;
+
+  if(pHandler->ResetRequest)
+  {
+    /* Windows overlapping the reset are not gated either */
+    pHandler->SubBlocks = 0;
+    pHandler->GatedSum = 0.0f;
+    pHandler->GatedBlocks = 0;
+    memset(pHandler->Histogram, 0, sizeof(pHandler->Histogram));
+    memset(pHandler->HistEnergy, 0, sizeof(pHandler->HistEnergy));
+    pHandler->ResetRequest = 0;
+  }
+
+  pHandler->SubEnergy[pHandler->Next] = pHandler->Energy * pHandler->Scale;
+  pHandler->Next = (pHandler->Next + 1) % LOUDNESS_SHORT_TERM_SUBBLOCKS;
+  if(pHandler->SubBlocks < LOUDNESS_SHORT_TERM_SUBBLOCKS)
+  {
+    pHandler->SubBlocks++;
+  }
+  pHandler->Energy = 0.0f;
+  pHandler->SubBlockFill = 0;
+
+  momentary = LOUDNESS_Mean(pHandler, LOUDNESS_MOMENTARY_SUBBLOCKS);
+  readings->Momentary = LOUDNESS_Lufs(momentary);
+  readings->ShortTerm = LOUDNESS_Lufs(LOUDNESS_Mean(pHandler, LOUDNESS_SHORT_TERM_SUBBLOCKS));
+
+  /* Gating blocks are the 400 ms windows, 75 % overlapped */
+  if(pHandler->SubBlocks >= LOUDNESS_MOMENTARY_SUBBLOCKS && readings->Momentary >= LOUDNESS_ABSOLUTE_GATE)
+  {
+    int32_t bin = (int32_t)((readings->Momentary - LOUDNESS_ABSOLUTE_GATE) / LOUDNESS_HIST_STEP);
+
+    if(bin >= LOUDNESS_HIST_BINS)
+    {
+      bin = LOUDNESS_HIST_BINS - 1;
+    }
+    pHandler->GatedSum += momentary;
+    pHandler->GatedBlocks++;
+    pHandler->Histogram[bin]++;
+    pHandler->HistEnergy[bin] += momentary;
+  }
+  readings->Integrated = LOUDNESS_Integrated(pHandler);
+  readings->GatedBlocks = pHandler->GatedBlocks;
+  readings->Sequence = pHandler->Readings[pHandler->Published].Sequence + 1;
+
+  /* LOUDNESS_GetReadings only reads the published one */
+  pHandler->Published = next;
+}
+
+/**
+* @}
+*/
+
+/** @defgroup LOUDNESS_METER_Functions
+* @{
+*/
+
+/**
+* @brief        Initializes the meter: K-weighting cascade of each channel
+*               and readings.
+* @param        *pHandler: meter.
+* @param        fs: sampling frequency in Hz, even, up to 96000.
+* @param        channels: interleaved channels of the PCM given to
+*               LOUDNESS_Feed, 1 to LOUDNESS_MAX_CHANNELS.
+* @retval       LOUDNESS_OK if correct operations, LOUDNESS_ERROR otherwise
+*/
+int32_t LOUDNESS_Init(LOUDNESS_Handler_t *pHandler, uint32_t fs, uint32_t channels)
+{
+  BIQUAD_Filter_t stage;
+  float32_t k, gain;
+  int32_t range = BIQUAD_RANGE_ONE;
+  int32_t ret;
+  int8_t postShift;
+  uint32_t i;
+
+  if(pHandler == NULL || fs == 0 || fs > 96000 || (fs & 1) || channels == 0 || channels > LOUDNESS_MAX_CHANNELS)
+  {
+    return LOUDNESS_ERROR;
+  }
+  memset(pHandler, 0, sizeof(LOUDNESS_Handler_t));
+  pHandler->Fs = fs;
+  pHandler->Channels = channels;
+  pHandler->SubBlockSize = fs / (1000 / LOUDNESS_SUBBLOCK_MS);
+
+  /* The BS.1770 high pass keeps b = {1, -2, 1} unnormalized: its pass band
+  gain, 1 + K / Q + K^2, is part of the -0.691 offset */
+  k = tanf(PI * LOUDNESS_HPF_FC / (float32_t)fs);
+  gain = 1.0f + k / LOUDNESS_HPF_Q + k * k;
+  pHandler->Scale = LOUDNESS_POWER_SCALE * gain * gain / (float32_t)pHandler->SubBlockSize;
+
+  /* BQ_CALC_ComputeFilter designs for the STA350BW, at twice Fs below 96 KHz:
+  ask for Fs / 2 to get the stream rate */
+  for(i = 0; i < LOUDNESS_STAGES; i++)
+  {
+    stage = LOUDNESS_KWeighting[i];
+    stage.Fs = fs / 2;
+    ret = BQ_CALC_ComputeFilter(&stage);
+    if(ret == BIQUAD_CALCULATOR_ERROR)
+    {
+      return LOUDNESS_ERROR;
+    }
+    if(ret > range)
+    {
+      range = ret;
+    }
+    pHandler->Coefficients[5 * i] = (q31_t)stage.Coefficients[4];       /* b0 / 2 */
+    pHandler->Coefficients[5 * i + 1] = (q31_t)stage.Coefficients[0];   /* b1 / 2 */
+    pHandler->Coefficients[5 * i + 2] = (q31_t)stage.Coefficients[1];   /* b2 */
+    pHandler->Coefficients[5 * i + 3] = (q31_t)stage.Coefficients[2];   /* -a1 / 2 */
+    pHandler->Coefficients[5 * i + 4] = (q31_t)stage.Coefficients[3];   /* -a2 */
+  }
+
+  /* 1.23 to q31 scaled down by 2^postShift, which holds 2 * range */
+  postShift = (range == BIQUAD_RANGE_FOUR) ? 3 : (range == BIQUAD_RANGE_TWO) ? 2 : 1;
+  for(i = 0; i < 5 * LOUDNESS_STAGES; i++)
+  {
+    uint32_t full = ((i % 5) == 2) || ((i % 5) == 4);
+
+    pHandler->Coefficients[i] *= (q31_t)1 << ((full ? 8 : 9) - postShift);
+  }
+  for(i = 0; i < channels; i++)
+  {
+    arm_biquad_cascade_df1_init_q31(&pHandler->Filter[i], LOUDNESS_STAGES, pHandler->Coefficients,
+                                    pHandler->State[i], postShift);
+  }
+
+  pHandler->Readings[0].Momentary = LOUDNESS_SILENCE;
+  pHandler->Readings[0].ShortTerm = LOUDNESS_SILENCE;
+  pHandler->Readings[0].Integrated = LOUDNESS_SILENCE;
+  return LOUDNESS_OK;
+}
+
+/**
+* @brief        Measures a buffer of PCM: the output buffer before it is
+*               played, or the capture after BSP_AUDIO_IN_PDMToPCM. Each
+*               channel goes through the K-weighting cascade block by block
+*               and only the sum of the squares is kept, so this can run in
+*               the DMA interrupt. About 45 cycles per sample and channel
+*               on Cortex-M4F, 3.5 % of the CPU for stereo at 32 KHz.
+* @param        *pHandler: meter.
+* @param        *pPCM: interleaved PCM, Channels samples per instant.
+* @param        samples: number of samples per channel.
+* @retval       None
+*/
+void LOUDNESS_Feed(LOUDNESS_Handler_t *pHandler, const int16_t *pPCM, uint32_t samples)
+{
+  uint32_t channels = pHandler->Channels;
+  uint32_t n, i, c;
+  q63_t power;
+
+  while(samples > 0)
+  {
+    n = pHandler->SubBlockSize - pHandler->SubBlockFill;
+    if(n > samples)
+    {
+      n = samples;
+    }
+    if(n > LOUDNESS_BLOCK_SIZE)
+    {
+      n = LOUDNESS_BLOCK_SIZE;
+    }
+
+    for(c = 0; c < channels; c++)
+    {
+      for(i = 0; i < n; i++)
+      {
+        pHandler->In[i] = (q31_t)pPCM[i * channels + c] << LOUDNESS_INPUT_SHIFT;
+      }
+      arm_biquad_cascade_df1_q31(&pHandler->Filter[c], pHandler->In, pHandler->Out, n);
+      arm_power_q31(pHandler->Out, n, &power);
+      pHandler->Energy += (float32_t)power;
+    }
+
+    pPCM += n * channels;
+    samples -= n;
+    pHandler->SubBlockFill += n;
+    if(pHandler->SubBlockFill == pHandler->SubBlockSize)
+    {
+      LOUDNESS_SubBlock(pHandler);
+    }
+  }
+}
+
+/**
+* @brief        Restarts the measurement, for instance when the program
+*               changes: the momentary and short-term readings build up again
+*               from the next sub-block, the integrated loudness from the
+*               next 400 ms block. Served at the next sub-block by
+*               LOUDNESS_Feed, so it can be called from any context.
+* @param        *pHandler: meter.
+* @retval       None
+*/
+void LOUDNESS_Reset(LOUDNESS_Handler_t *pHandler)
+{
+  pHandler->ResetRequest = 1;
+}
+
+/**
+* @brief        Copies the last readings. Can be called from a context
+*               interrupted by LOUDNESS_Feed, such as the main loop: the
+*               next readings go to the other buffer.
+* @param        *pHandler: meter.
+* @param        *pReadings: copy of the readings.
+* @retval       None
+*/
+void LOUDNESS_GetReadings(LOUDNESS_Handler_t *pHandler, LOUDNESS_Readings_t *pReadings)
+{
+  *pReadings = pHandler->Readings[pHandler->Published];
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
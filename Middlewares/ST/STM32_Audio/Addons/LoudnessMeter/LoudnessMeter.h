@@ -0,0 +1,143 @@
+/**
+******************************************************************************
+* @file    LoudnessMeter.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for LoudnessMeter.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOUDNESS_METER_H
+#define __LOUDNESS_METER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stdint.h"
+#include "arm_math.h"
+#include "BiquadCalculator.h"
+
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+
+  /** @defgroup LOUDNESS_METER
+  * @{
+  */
+
+  /** @defgroup  LOUDNESS_METER_Exported_Constants
+  * @{
+  */
+#define LOUDNESS_MAX_CHANNELS           4                       /*!< Interleaved channels, all weighted 1 */
+#define LOUDNESS_STAGES                 2                       /*!< K-weighting: high shelf, then high pass */
+#define LOUDNESS_BLOCK_SIZE             64                      /*!< Samples per channel filtered at once */
+#define LOUDNESS_SUBBLOCK_MS            100                     /*!< Period of the readings */
+#define LOUDNESS_MOMENTARY_SUBBLOCKS    4                       /*!< 400 ms */
+#define LOUDNESS_SHORT_TERM_SUBBLOCKS   30                      /*!< 3 s */
+#define LOUDNESS_ABSOLUTE_GATE          (-70.0f)                /*!< LUFS */
+#define LOUDNESS_RELATIVE_GATE          (-10.0f)                /*!< LU under the ungated loudness */
+#define LOUDNESS_HIST_STEP              0.5f                    /*!< LU per bin of the gating histogram */
+#define LOUDNESS_HIST_BINS              160                     /*!< -70 to +10 LUFS */
+#define LOUDNESS_SILENCE                (-120.0f)               /*!< Reading without signal or gated blocks */
+
+#define LOUDNESS_OK                     ((int32_t) 0)
+#define LOUDNESS_ERROR                  ((int32_t) -1)
+  /**
+  * @}
+  */
+
+  /** @defgroup LOUDNESS_METER_Exported_Types_Definitions
+  * @{
+  */
+
+  /**
+  * @brief Readings, in LUFS, updated every LOUDNESS_SUBBLOCK_MS.
+  */
+  typedef struct
+  {
+    uint32_t                    Sequence;       /*!< Incremented at each update */
+    float32_t                   Momentary;      /*!< Last 400 ms */
+    float32_t                   ShortTerm;      /*!< Last 3 s */
+    float32_t                   Integrated;     /*!< Gated, since LOUDNESS_Init or LOUDNESS_Reset */
+    uint32_t                    GatedBlocks;    /*!< 400 ms blocks above the absolute gate */
+  }LOUDNESS_Readings_t;
+
+  /**
+  * @brief Meter state. LOUDNESS_Feed runs where the PCM is produced or
+  *        consumed, LOUDNESS_GetReadings anywhere.
+  */
+  typedef struct
+  {
+    uint32_t                    Fs;
+    uint32_t                    Channels;
+    uint32_t                    SubBlockSize;   /*!< Samples per channel in LOUDNESS_SUBBLOCK_MS */
+    uint32_t                    SubBlockFill;
+    float32_t                   Energy;         /*!< Sum of the squares of the current sub-block, 16.48 */
+    float32_t                   Scale;          /*!< Energy to mean square, per sample */
+    q31_t                       Coefficients[5 * LOUDNESS_STAGES];
+    q31_t                       State[LOUDNESS_MAX_CHANNELS][4 * LOUDNESS_STAGES];
+    arm_biquad_casd_df1_inst_q31 Filter[LOUDNESS_MAX_CHANNELS];
+    q31_t                       In[LOUDNESS_BLOCK_SIZE];
+    q31_t                       Out[LOUDNESS_BLOCK_SIZE];
+    float32_t                   SubEnergy[LOUDNESS_SHORT_TERM_SUBBLOCKS]; /*!< Mean square of the last sub-blocks */
+    uint32_t                    SubBlocks;      /*!< Valid entries of SubEnergy */
+    uint32_t                    Next;           /*!< Next entry of SubEnergy */
+    float32_t                   GatedSum;       /*!< Energy of the blocks above the absolute gate */
+    uint32_t                    GatedBlocks;
+    uint32_t                    Histogram[LOUDNESS_HIST_BINS];  /*!< Gated blocks per bin */
+    float32_t                   HistEnergy[LOUDNESS_HIST_BINS]; /*!< Their energy */
+    volatile uint32_t           ResetRequest;   /*!< Set by LOUDNESS_Reset, served by LOUDNESS_Feed */
+    LOUDNESS_Readings_t         Readings[2];
+    volatile uint32_t           Published;      /*!< Readings returned by LOUDNESS_GetReadings */
+  }LOUDNESS_Handler_t;
+
+  /**
+  * @}
+  */
+
+  /** @defgroup  LOUDNESS_METER_Functions
+  * @{ */
+  int32_t LOUDNESS_Init(LOUDNESS_Handler_t *pHandler, uint32_t fs, uint32_t channels);
+  void LOUDNESS_Feed(LOUDNESS_Handler_t *pHandler, const int16_t *pPCM, uint32_t samples);
+  void LOUDNESS_Reset(LOUDNESS_Handler_t *pHandler);
+  void LOUDNESS_GetReadings(LOUDNESS_Handler_t *pHandler, LOUDNESS_Readings_t *pReadings);
+  /**
+  * @}
+  */
+
+  /**
+  * @}
+  */
+
+  /**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOUDNESS_METER_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,387 @@
+/**
+******************************************************************************
+* @file    SpectrumAnalyzer.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file provides a spectrum analyzer of the microphone PCM:
+*          Hann windowed, 50 % overlapped real FFT, averaged into linear
+*          and 1/3 octave band energies at a configurable update rate.
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+/* Includes ------------------------------------------------------------------*/
+#include "SpectrumAnalyzer.h"
+#include "string.h"
+
+#ifndef NULL
+#define NULL      (void *) 0
+#endif
+
+/** @addtogroup MIDDLEWARES
+* @{
+*/
+
+/** @addtogroup SPECTRUM_ANALYZER
+* @{
+*/
+
+/** @defgroup SPECTRUM_ANALYZER_Private_Defines
+* @{
+*/
+#define SPECTRUM_RING_MASK        (SPECTRUM_RING_SIZE - 1)
+#define SPECTRUM_BINS             (SPECTRUM_FFT_SIZE / 2)         /* Nyquist bin is dropped */
+#define SPECTRUM_BINS_PER_LINEAR  (SPECTRUM_BINS / SPECTRUM_LINEAR_BINS)
+#define SPECTRUM_THIRD_FIRST      19.952623f                      /* 1000 * 10^(-17 / 10) Hz */
+#define SPECTRUM_THIRD_RATIO      1.2589254f                      /* 10^(1 / 10) */
+#define SPECTRUM_THIRD_HALF       1.1224620f                      /* 2^(1 / 6), center to edge */
+#define SPECTRUM_10_LOG2          3.0103000f                      /* 10 * log10(2) */
+#define SPECTRUM_FULL_SCALE       32768.0f
+/**
+* @}
+*/
+
+/** @defgroup SPECTRUM_ANALYZER_Private_Functions
+* @{
+*/
+
+/**
+* @brief        Converts an averaged energy to the snapshot format.
+* @param        energy: sum of the scaled bin powers over the frames.
+* @param        scale: bin power to full scale sine, divided by the frames.
+* @retval       level in 0.01 dB, SPECTRUM_FLOOR to 32767
+*/
+static int16_t SPECTRUM_Level(float32_t energy, float32_t scale)
+{
+  float32_t level;
+
+  energy *= scale;
+  if(energy <= 1.0e-12f)
+  {
+    return SPECTRUM_FLOOR;
+  }
+  level = 100.0f * SPECTRUM_10_LOG2 * log2f(energy);
+  if(level <= (float32_t)SPECTRUM_FLOOR)
+  {
+    return SPECTRUM_FLOOR;
+  }
+  if(level >= 32767.0f)
+  {
+    return 32767;
+  }
+  return (int16_t)(level < 0.0f ? level - 0.5f : level + 0.5f);
+}
+
+/**
+* @brief        Publishes the averaged energies in the free snapshot and
+*               restarts the average.
+* @param        *pHandler: analyzer.
+* @retval       None
+*/
+static void SPECTRUM_Publish(SPECTRUM_Handler_t *pHandler)
+{
+  uint32_t next = pHandler->Published ^ 1;
+  SPECTRUM_Snapshot_t *snap = &pHandler->Snapshot[next];
+  float32_t scale = pHandler->Scale / (float32_t)pHandler->Frames;
+  uint32_t k;
+
+  snap->Sequence = pHandler->Snapshot[pHandler->Published].Sequence + 1;
+  snap->Fs = pHandler->Fs;
+  snap->FftSize = SPECTRUM_FFT_SIZE;
+  snap->Frames = (uint16_t)pHandler->Frames;
+  snap->Overruns = (uint16_t)pHandler->Overruns;
+  snap->LinearBins = SPECTRUM_LINEAR_BINS;
+  snap->ThirdBands = SPECTRUM_THIRD_BANDS;
+  for(k = 0; k < SPECTRUM_LINEAR_BINS; k++)
+  {
+    snap->Linear[k] = SPECTRUM_Level(pHandler->LinearAcc[k], scale);
+    pHandler->LinearAcc[k] = 0.0f;
+  }
+  for(k = 0; k < SPECTRUM_THIRD_BANDS; k++)
+  {
+    snap->Third[k] = SPECTRUM_Level(pHandler->ThirdAcc[k], scale);
+    pHandler->ThirdAcc[k] = 0.0f;
+  }
+  snap->Total = SPECTRUM_Level(pHandler->TotalAcc, scale);
+  pHandler->TotalAcc = 0.0f;
+  pHandler->Frames = 0;
+
+  /* SPECTRUM_GetSnapshot only reads the published one */
+  pHandler->Published = next;
+}
+
+/**
+* @}
+*/
+
+/** @defgroup SPECTRUM_ANALYZER_Functions
+* @{
+*/
+
+/**
+* @brief        Initializes the analyzer: window, FFT instance and band edges.
+* @param        *pHandler: analyzer.
+* @param        fs: sampling frequency in Hz.
+* @param        channels: interleaved channels of the PCM given to SPECTRUM_Feed.
+* @param        channel: analyzed channel, or SPECTRUM_CHANNEL_MIX for their average.
+* @param        updateMs: period of the snapshots in ms, rounded to a whole
+*               number of hops (SPECTRUM_HOP_SIZE / fs, 10.7 ms at 48 KHz).
+* @retval       SPECTRUM_OK if correct operations, SPECTRUM_ERROR otherwise
+*/
+int32_t SPECTRUM_Init(SPECTRUM_Handler_t *pHandler, uint32_t fs, uint32_t channels, uint32_t channel,
+                      uint32_t updateMs)
+{
+  float32_t sinVal, cosVal;
+  float32_t power = 0.0f;
+  float32_t fc = SPECTRUM_THIRD_FIRST;
+  float32_t binHz;
+  uint32_t frames;
+  uint32_t n;
+
+  if(pHandler == NULL || fs == 0 || channels == 0 || (channel >= channels && channel != SPECTRUM_CHANNEL_MIX) ||
+     updateMs == 0)
+  {
+    return SPECTRUM_ERROR;
+  }
+
+  memset(pHandler, 0, sizeof(SPECTRUM_Handler_t));
+  if(arm_rfft_fast_init_f32(&pHandler->Fft, SPECTRUM_FFT_SIZE) != ARM_MATH_SUCCESS)
+  {
+    return SPECTRUM_ERROR;
+  }
+  pHandler->Fs = fs;
+  pHandler->Channels = channels;
+  pHandler->Channel = channel;
+  frames = (uint32_t)(((uint64_t)updateMs * fs + 500u * SPECTRUM_HOP_SIZE) / (1000u * SPECTRUM_HOP_SIZE));
+  pHandler->FramesPerUpdate = (frames == 0) ? 1 : frames;
+
+  /* Periodic Hann window, symmetric: w[N - n] = w[n] */
+  for(n = 0; n <= SPECTRUM_FFT_SIZE / 2; n++)
+  {
+    arm_sin_cos_f32(360.0f * (float32_t)n / (float32_t)SPECTRUM_FFT_SIZE - 180.0f, &sinVal, &cosVal);
+    pHandler->Window[n] = 0.5f + 0.5f * cosVal;
+    power += pHandler->Window[n] * pHandler->Window[n] * ((n == 0 || n == SPECTRUM_FFT_SIZE / 2) ? 1.0f : 2.0f);
+  }
+
+  /* A full scale sine puts N * A^2 * sum(w^2) / 4 in the positive bins */
+  pHandler->Scale = 4.0f / ((float32_t)SPECTRUM_FFT_SIZE * power * SPECTRUM_FULL_SCALE * SPECTRUM_FULL_SCALE);
+
+  /* Bin k covers [k - 1/2, k + 1/2], band edges in bins */
+  binHz = (float32_t)fs / (float32_t)SPECTRUM_FFT_SIZE;
+  for(n = 0; n < SPECTRUM_THIRD_BANDS; n++)
+  {
+    float32_t lo = fc / SPECTRUM_THIRD_HALF / binHz;
+    float32_t hi = fc * SPECTRUM_THIRD_HALF / binHz;
+
+    if(hi > (float32_t)SPECTRUM_BINS - 0.5f)
+    {
+      hi = (float32_t)SPECTRUM_BINS - 0.5f;
+    }
+    pHandler->BandLo[n] = lo;
+    pHandler->BandHi[n] = hi;
+    fc *= SPECTRUM_THIRD_RATIO;
+  }
+
+  pHandler->Snapshot[0].Fs = fs;
+  pHandler->Snapshot[0].FftSize = SPECTRUM_FFT_SIZE;
+  pHandler->Snapshot[0].LinearBins = SPECTRUM_LINEAR_BINS;
+  pHandler->Snapshot[0].ThirdBands = SPECTRUM_THIRD_BANDS;
+  for(n = 0; n < SPECTRUM_LINEAR_BINS; n++)
+  {
+    pHandler->Snapshot[0].Linear[n] = SPECTRUM_FLOOR;
+  }
+  for(n = 0; n < SPECTRUM_THIRD_BANDS; n++)
+  {
+    pHandler->Snapshot[0].Third[n] = SPECTRUM_FLOOR;
+  }
+  pHandler->Snapshot[0].Total = SPECTRUM_FLOOR;
+
+  return SPECTRUM_OK;
+}
+
+/**
+* @brief        Stores captured samples, to be called with the output of
+*               BSP_AUDIO_IN_PDMToPCM. Only copies one channel, or the
+*               average of all of them, so it fits in the capture interrupt.
+* @param        *pHandler: analyzer.
+* @param        *pPCM: interleaved PCM, Channels samples per instant.
+* @param        samples: number of samples per channel.
+* @retval       None
+*/
+void SPECTRUM_Feed(SPECTRUM_Handler_t *pHandler, const int16_t *pPCM, uint32_t samples)
+{
+  uint32_t write = pHandler->Write;
+  uint32_t i, c;
+  int32_t sum;
+
+  for(i = 0; i < samples; i++)
+  {
+    if(pHandler->Channel == SPECTRUM_CHANNEL_MIX)
+    {
+      sum = 0;
+      for(c = 0; c < pHandler->Channels; c++)
+      {
+        sum += pPCM[c];
+      }
+      pHandler->Ring[write & SPECTRUM_RING_MASK] = (int16_t)(sum / (int32_t)pHandler->Channels);
+    }
+    else
+    {
+      pHandler->Ring[write & SPECTRUM_RING_MASK] = pPCM[pHandler->Channel];
+    }
+    pPCM += pHandler->Channels;
+    write++;
+
+    if(++pHandler->Fill == SPECTRUM_HOP_SIZE)
+    {
+      pHandler->Fill = 0;
+      pHandler->HopEnd = write;
+      pHandler->Hops++;
+    }
+  }
+  pHandler->Write = write;
+}
+
+/**
+* @brief        Transforms the last completed hop and adds it to the average,
+*               to be called from the main loop at least once per hop.
+*               Hops missed in between are counted in Overruns and skipped.
+*               Its cost on target is timed by Biquad_Bench with BIQUAD_BENCH,
+*               in Spectrum_HopCycles.
+* @param        *pHandler: analyzer.
+* @retval       SPECTRUM_UPDATED when a snapshot is published, SPECTRUM_OK otherwise
+*/
+int32_t SPECTRUM_Process(SPECTRUM_Handler_t *pHandler)
+{
+  float32_t *frame = pHandler->Frame;
+  float32_t *power = pHandler->Frame;
+  float32_t *window = pHandler->Window;
+  uint32_t hops, end, start;
+  uint32_t n, k;
+  float32_t sum;
+
+  /* HopEnd and Hops change together in SPECTRUM_Feed */
+  do
+  {
+    hops = pHandler->Hops;
+    end = pHandler->HopEnd;
+  }
+  while(hops != pHandler->Hops);
+
+  if(hops == pHandler->Done)
+  {
+    return SPECTRUM_OK;
+  }
+  pHandler->Overruns += hops - pHandler->Done - 1;
+  pHandler->Done = hops;
+  if(end < SPECTRUM_FFT_SIZE)
+  {
+    return SPECTRUM_OK;
+  }
+
+  start = end - SPECTRUM_FFT_SIZE;
+  for(n = 0; n < SPECTRUM_FFT_SIZE / 2; n++)
+  {
+    frame[n] = window[n] * (float32_t)pHandler->Ring[(start + n) & SPECTRUM_RING_MASK];
+  }
+  for(; n < SPECTRUM_FFT_SIZE; n++)
+  {
+    frame[n] = window[SPECTRUM_FFT_SIZE - n] * (float32_t)pHandler->Ring[(start + n) & SPECTRUM_RING_MASK];
+  }
+  /* The frame was overwritten while copied */
+  if(pHandler->Write - end > SPECTRUM_RING_SIZE - SPECTRUM_FFT_SIZE)
+  {
+    pHandler->Overruns++;
+    return SPECTRUM_OK;
+  }
+
+  arm_rfft_fast_f32(&pHandler->Fft, frame, pHandler->Spectrum, 0);
+  /* Spectrum[1] holds the Nyquist bin, keep DC alone in power[0] */
+  pHandler->Spectrum[1] = 0.0f;
+  arm_cmplx_mag_squared_f32(pHandler->Spectrum, power, SPECTRUM_BINS);
+
+  for(k = 0; k < SPECTRUM_LINEAR_BINS; k++)
+  {
+    sum = 0.0f;
+    for(n = 0; n < SPECTRUM_BINS_PER_LINEAR; n++)
+    {
+      sum += power[k * SPECTRUM_BINS_PER_LINEAR + n];
+    }
+    pHandler->LinearAcc[k] += sum;
+    pHandler->TotalAcc += sum;
+  }
+
+  /* Bins shared by two bands, or wider than a band, are split by overlap */
+  for(k = 0; k < SPECTRUM_THIRD_BANDS; k++)
+  {
+    float32_t lo = pHandler->BandLo[k];
+    float32_t hi = pHandler->BandHi[k];
+
+    if(hi <= lo)
+    {
+      continue;
+    }
+    sum = 0.0f;
+    for(n = (uint32_t)(lo + 0.5f); n <= (uint32_t)(hi + 0.5f) && n < SPECTRUM_BINS; n++)
+    {
+      float32_t a = ((float32_t)n - 0.5f > lo) ? (float32_t)n - 0.5f : lo;
+      float32_t b = ((float32_t)n + 0.5f < hi) ? (float32_t)n + 0.5f : hi;
+
+      if(b > a)
+      {
+        sum += (b - a) * power[n];
+      }
+    }
+    pHandler->ThirdAcc[k] += sum;
+  }
+
+  if(++pHandler->Frames >= pHandler->FramesPerUpdate)
+  {
+    SPECTRUM_Publish(pHandler);
+    return SPECTRUM_UPDATED;
+  }
+  return SPECTRUM_OK;
+}
+
+/**
+* @brief        Copies the last published snapshot. Can be called from an
+*               interrupt of higher priority than SPECTRUM_Process, such as
+*               the USB one.
+* @param        *pHandler: analyzer.
+* @param        *pSnapshot: copy of the snapshot.
+* @retval       None
+*/
+void SPECTRUM_GetSnapshot(SPECTRUM_Handler_t *pHandler, SPECTRUM_Snapshot_t *pSnapshot)
+{
+  *pSnapshot = pHandler->Snapshot[pHandler->Published];
+}
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/**
+* @}
+*/
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
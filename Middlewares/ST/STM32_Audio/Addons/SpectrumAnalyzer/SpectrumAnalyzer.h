@@ -0,0 +1,150 @@
+/**
+******************************************************************************
+* @file    SpectrumAnalyzer.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   This file contains definitions for SpectrumAnalyzer.c functions
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************************
+*/
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SPECTRUM_ANALYZER_H
+#define __SPECTRUM_ANALYZER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stdint.h"
+#include "arm_math.h"
+
+  /** @addtogroup MIDDLEWARES
+  * @{
+  */
+
+  /** @defgroup SPECTRUM_ANALYZER
+  * @{
+  */
+
+  /** @defgroup  SPECTRUM_ANALYZER_Exported_Constants
+  * @{
+  */
+#define SPECTRUM_FFT_SIZE               1024                    /*!< Samples per transform, Hann window */
+#define SPECTRUM_HOP_SIZE               (SPECTRUM_FFT_SIZE / 2) /*!< New samples per transform, 50 % overlap */
+#define SPECTRUM_RING_SIZE              2048                    /*!< Input ring, power of 2, at least FFT + HOP */
+#define SPECTRUM_LINEAR_BINS            32                      /*!< Equal width bins from 0 to Fs / 2 */
+#define SPECTRUM_THIRD_BANDS            31                      /*!< 1/3 octave bands, 20 Hz to 20 KHz */
+#define SPECTRUM_FLOOR                  ((int16_t) -12000)      /*!< Lowest level and empty bands, 0.01 dB */
+#define SPECTRUM_CHANNEL_MIX            0xFF                    /*!< Analyze the average of all the channels */
+
+#define SPECTRUM_OK                     ((int32_t) 0)
+#define SPECTRUM_ERROR                  ((int32_t) -1)
+#define SPECTRUM_UPDATED                ((int32_t) 1)           /*!< SPECTRUM_Process: a new snapshot is published */
+  /**
+  * @}
+  */
+
+  /** @defgroup SPECTRUM_ANALYZER_Exported_Types_Definitions
+  * @{
+  */
+
+  /**
+  * @brief Band energies averaged over one update period, in 0.01 dB relative
+  *        to a full scale sine. Third[k] is centered on 1000 * 10^((k - 17) / 10) Hz,
+  *        bands above Fs / 2 read SPECTRUM_FLOOR. Sent as is to the USB host.
+  */
+  typedef struct
+  {
+    uint32_t                    Sequence;       /*!< Incremented at each update */
+    uint32_t                    Fs;             /*!< Sampling frequency in Hz */
+    uint16_t                    FftSize;        /*!< SPECTRUM_FFT_SIZE */
+    uint16_t                    Frames;         /*!< Transforms averaged in this update */
+    uint16_t                    Overruns;       /*!< Hops skipped since SPECTRUM_Init, SPECTRUM_Process late */
+    uint8_t                     LinearBins;     /*!< SPECTRUM_LINEAR_BINS */
+    uint8_t                     ThirdBands;     /*!< SPECTRUM_THIRD_BANDS */
+    int16_t                     Linear[SPECTRUM_LINEAR_BINS];
+    int16_t                     Third[SPECTRUM_THIRD_BANDS];
+    int16_t                     Total;          /*!< Level of the whole band */
+  }SPECTRUM_Snapshot_t;
+
+  /**
+  * @brief Analyzer state. SPECTRUM_Feed runs in the capture interrupt,
+  *        SPECTRUM_Process in the main loop.
+  */
+  typedef struct
+  {
+    uint32_t                    Fs;
+    uint32_t                    Channels;       /*!< Interleaved channels of the PCM buffers */
+    uint32_t                    Channel;        /*!< Analyzed channel, or SPECTRUM_CHANNEL_MIX */
+    uint32_t                    FramesPerUpdate;
+    int16_t                     Ring[SPECTRUM_RING_SIZE];
+    volatile uint32_t           Write;          /*!< Samples written, free running */
+    volatile uint32_t           HopEnd;         /*!< Write at the end of the last hop */
+    volatile uint32_t           Hops;           /*!< Hops completed by SPECTRUM_Feed */
+    uint32_t                    Fill;           /*!< Samples of the current hop */
+    uint32_t                    Done;           /*!< Hops processed by SPECTRUM_Process */
+    uint32_t                    Frames;
+    uint32_t                    Overruns;
+    float32_t                   Scale;          /*!< Bin power to full scale sine */
+    float32_t                   Window[SPECTRUM_FFT_SIZE / 2 + 1];
+    float32_t                   Frame[SPECTRUM_FFT_SIZE];
+    float32_t                   Spectrum[SPECTRUM_FFT_SIZE];
+    float32_t                   BandLo[SPECTRUM_THIRD_BANDS];   /*!< Band edges in bins */
+    float32_t                   BandHi[SPECTRUM_THIRD_BANDS];
+    float32_t                   LinearAcc[SPECTRUM_LINEAR_BINS];
+    float32_t                   ThirdAcc[SPECTRUM_THIRD_BANDS];
+    float32_t                   TotalAcc;
+    arm_rfft_fast_instance_f32  Fft;
+    SPECTRUM_Snapshot_t         Snapshot[2];
+    volatile uint32_t           Published;      /*!< Snapshot readable by SPECTRUM_GetSnapshot */
+  }SPECTRUM_Handler_t;
+
+  /**
+  * @}
+  */
+
+  /** @defgroup  SPECTRUM_ANALYZER_Functions
+  * @{ */
+  int32_t SPECTRUM_Init(SPECTRUM_Handler_t *pHandler, uint32_t fs, uint32_t channels, uint32_t channel,
+                        uint32_t updateMs);
+  void SPECTRUM_Feed(SPECTRUM_Handler_t *pHandler, const int16_t *pPCM, uint32_t samples);
+  int32_t SPECTRUM_Process(SPECTRUM_Handler_t *pHandler);
+  void SPECTRUM_GetSnapshot(SPECTRUM_Handler_t *pHandler, SPECTRUM_Snapshot_t *pSnapshot);
+  /**
+  * @}
+  */
+
+  /**
+  * @}
+  */
+
+  /**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPECTRUM_ANALYZER_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
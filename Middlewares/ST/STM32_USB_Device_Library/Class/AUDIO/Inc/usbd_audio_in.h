@@ -97,7 +97,32 @@
 #define VOL_MIN                                       0xDBE0 
 #define VOL_RES                                       0x0023
 #define VOL_MAX                                       0x0000 
-#define AUDIO_IN_PACKET                  (uint32_t)((((48000/1000)+2)*8)*2) 
+/* Feature unit control selectors */
+#define AUDIO_FU_MUTE_CONTROL                         0x01
+#define AUDIO_FU_VOLUME_CONTROL                       0x02
+/* Feature unit digital gain, Q15 with 1.0 = AUDIO_IN_GAIN_UNITY, applied 
+   while copying the samples into the USB ring. Gain changes are ramped 
+   linearly over each block, by at most AUDIO_IN_GAIN_RAMP_STEP per block */
+#define AUDIO_IN_GAIN_UNITY                           32768
+#define AUDIO_IN_GAIN_RAMP_STEP                       4096
+
+/* Full speed isochronous bandwidth planner: the largest configuration the 
+   class is built for must fit in one full speed isochronous packet per frame */
+#define AUDIO_IN_FS_ISOC_MAX_PACKET                   1023
+#define AUDIO_IN_MAX_FREQ                             48000
+#define AUDIO_IN_MAX_CHANNELS                         4
+#define AUDIO_IN_BYTES_PER_SAMPLE                     2
+#define AUDIO_IN_BIT_RESOLUTION                       (AUDIO_IN_BYTES_PER_SAMPLE*8)
+/* One frame of samples plus two samples of margin for the rate adaptation */
+#define AUDIO_IN_PACKET_SIZE(freq, ch)                ((((freq)/1000)+2)*(ch)*AUDIO_IN_BYTES_PER_SAMPLE)
+#define AUDIO_IN_PACKET                  (uint32_t)(AUDIO_IN_PACKET_SIZE(AUDIO_IN_MAX_FREQ, AUDIO_IN_MAX_CHANNELS))
+
+#if AUDIO_IN_PACKET_SIZE(AUDIO_IN_MAX_FREQ, AUDIO_IN_MAX_CHANNELS) > AUDIO_IN_FS_ISOC_MAX_PACKET
+#error "AUDIO_IN_MAX_FREQ x AUDIO_IN_MAX_CHANNELS exceeds the full speed isochronous packet size"
+#endif
+
+/* Alternate settings of the streaming interface: 0 zero bandwidth, 1 operational */
+#define AUDIO_IN_NUM_ALT_SETTINGS                     2
 #define MIC_IN_TERMINAL_ID                            1
 #define MIC_FU_ID                                     2
 #define MIC_OUT_TERMINAL_ID                           3
@@ -105,6 +130,24 @@
 /* Audio Data in endpoint */
 #define AUDIO_IN_EP                                   0x81 
 
+/* Raw PDM vendor interface with a bulk IN endpoint, for microphone qualification */
+#ifndef AUDIO_PDM_BULK_ENABLE
+#define AUDIO_PDM_BULK_ENABLE                         0
+#endif
+#define AUDIO_PDM_EP                                  0x82
+#define AUDIO_PDM_BULK_PACKET                         64
+/* Bytes per frame the planner lets bulk and isochronous IN share: a full 
+   speed host rarely schedules more than 16 bulk packets in a frame */
+#define AUDIO_PDM_FRAME_BUDGET                        (16*AUDIO_PDM_BULK_PACKET)
+
+#if AUDIO_PDM_BULK_ENABLE
+#define AUDIO_PDM_IF_DESC_SIZE                        (9+7)
+#define AUDIO_NUM_INTERFACES                          3
+#else
+#define AUDIO_PDM_IF_DESC_SIZE                        0
+#define AUDIO_NUM_INTERFACES                          2
+#endif
+
 /* Buffering state definitions */
 typedef enum
 {
@@ -121,6 +164,18 @@ AUDIO_StatesTypeDef;
 #define TIMEOUT_VALUE                                   200
 
 
+/* Vendor requests (interface recipient) giving access to the stream telemetry */
+#define AUDIO_REQ_VENDOR_GET_STATS                    0x01
+#define AUDIO_REQ_VENDOR_CLEAR_STATS                  0x02
+/* Vendor request returning the application spectrum, see GetSpectrum */
+#define AUDIO_REQ_VENDOR_GET_SPECTRUM                 0x03
+
+/* Largest spectrum returned by AUDIO_REQ_VENDOR_GET_SPECTRUM, in bytes */
+#define AUDIO_IN_SPECTRUM_MAX_SIZE                    256
+
+/* Number of bins of the ring buffer fill histogram */
+#define AUDIO_IN_FILL_HIST_BINS                       8
+
 /* Audio Commands enmueration */
 typedef enum
 {
@@ -154,6 +209,7 @@ typedef struct
   uint8_t data[USB_MAX_EP0_SIZE];  
   uint8_t len;  
   uint8_t unit;    
+  uint8_t selector;    
 }
 USBD_AUDIO_ControlTypeDef; 
 
@@ -174,21 +230,49 @@ typedef struct
   uint8_t                    lower_treshold;
   USBD_AUDIO_ControlTypeDef control;   
   uint8_t  *                 buffer;
+  __IO uint8_t               pdm_busy;
+  uint8_t  *                 pdm_data;
+  uint8_t                    mute;
+  int32_t                    gain;
+  __IO int32_t               gain_target;
 }
 USBD_AUDIO_HandleTypeDef; 
 
 
+/* Stream telemetry, returned as is by AUDIO_REQ_VENDOR_GET_STATS.
+   72 bytes, sent in two EP0 packets: the host must request a wLength of at
+   least sizeof(USBD_AUDIO_StatsTypeDef), a shorter one truncates the struct */
+typedef struct
+{
+  uint32_t                   packets;          /*!< Audio packets queued on the IN endpoint */
+  uint32_t                   silent_packets;   /*!< Zero packets queued while no audio is available */
+  uint32_t                   short_packets;    /*!< Packets shortened by one sample, ring running empty */
+  uint32_t                   long_packets;     /*!< Packets lengthened by one sample, ring running full */
+  uint32_t                   resets;           /*!< Stream restarts due to a low ring fill */
+  uint32_t                   timeouts;         /*!< Stream stops due to TIMEOUT_VALUE */
+  uint16_t                   fill_min;         /*!< Minimum ring fill seen by DataIn, in bytes */
+  uint16_t                   fill_max;         /*!< Maximum ring fill seen by DataIn, in bytes */
+  uint16_t                   fill_bin_shift;   /*!< Ring fill in bytes >> fill_bin_shift gives the bin */
+  uint16_t                   reserved;
+  uint32_t                   fill_histogram[AUDIO_IN_FILL_HIST_BINS];
+  uint32_t                   pdm_frames;       /*!< Raw PDM buffers sent on the bulk endpoint */
+  uint32_t                   pdm_overruns;     /*!< Raw PDM buffers dropped, bulk endpoint still busy */
+}
+USBD_AUDIO_StatsTypeDef;
+
+
 typedef struct
 {
   int8_t  (*Init)         	(uint32_t  AudioFreq, uint32_t BitRes, uint32_t ChnlNbr);
   int8_t  (*DeInit)       	(uint32_t options);
   int8_t  (*Record)     	(void);
-  int8_t  (*VolumeCtl)    	(int16_t Volume);
-  int8_t  (*MuteCtl)      	(uint8_t cmd);
+  int8_t  (*VolumeCtl)    	(int16_t Volume);   /* Notification only: the class applies the gain */
+  int8_t  (*MuteCtl)      	(uint8_t cmd);      /* Notification only: the class applies the mute */
   int8_t  (*Stop)   		(void);
   int8_t  (*Pause)   		(void);
   int8_t  (*Resume)   		(void);
   int8_t  (*CommandMgr)     (uint8_t cmd);
+  int8_t  (*GetSpectrum)    (uint8_t *pbuf, uint16_t *length); /* Optional, NULL stalls GET_SPECTRUM */
 }USBD_AUDIO_ItfTypeDef;
 /**
 * @}
@@ -215,7 +299,15 @@ extern USBD_ClassTypeDef  USBD_AUDIO;
 * @{
 */ 
 uint8_t  USBD_AUDIO_RegisterInterface  (USBD_HandleTypeDef   *pdev, USBD_AUDIO_ItfTypeDef *fops);
-void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t samplingFrequency, uint8_t Channels);
+uint8_t USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t samplingFrequency, uint8_t Channels);
+uint8_t USBD_AUDIO_CheckBandwidth(uint32_t samplingFrequency, uint8_t Channels);
+void USBD_AUDIO_GetStats(USBD_AUDIO_StatsTypeDef *stats);
+void USBD_AUDIO_ClearStats(void);
+#if AUDIO_PDM_BULK_ENABLE
+uint8_t USBD_AUDIO_PDM_CheckBandwidth(uint32_t bytesPerMs);
+uint8_t USBD_AUDIO_PDM_Transfer(USBD_HandleTypeDef *pdev, uint8_t *pdmData, uint16_t length);
+uint8_t USBD_AUDIO_PDM_IsBusy(USBD_HandleTypeDef *pdev, uint8_t *pdmData);
+#endif
 uint8_t  USBD_AUDIO_Data_Transfer (USBD_HandleTypeDef *pdev, int16_t * audioData, uint16_t dataAmount);
 
 
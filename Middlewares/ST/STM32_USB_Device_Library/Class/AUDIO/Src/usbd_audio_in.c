@@ -65,6 +65,9 @@
 *             - Audio Class-Specific AC Interfaces
 *             - Audio Class-Specific AS Interfaces
 *             - AudioControl Requests: mute and volume control
+*             - Vendor Requests: stream telemetry counters
+*             - Optional vendor interface streaming raw PDM on a bulk endpoint
+*               (AUDIO_PDM_BULK_ENABLE)
 *             - Audio Synchronization type: Asynchronous
 *             - Multiple frequencies and channel number configurable using ad hoc
 *               init function
@@ -125,6 +128,9 @@ static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
 static void AUDIO_REQ_GetMaximum(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
 static void AUDIO_REQ_GetMinimum(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
 static void AUDIO_REQ_GetResolution(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+static uint8_t AUDIO_REQ_Vendor(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+static int32_t AUDIO_IN_VolumeToGain(int16_t volume);
+static void AUDIO_IN_CopyWithGain(USBD_AUDIO_HandleTypeDef *haudio, int16_t *dst, int16_t *src, uint16_t samples);
 
 /**
 * @}
@@ -134,9 +140,36 @@ static void AUDIO_REQ_GetResolution(USBD_HandleTypeDef *pdev, USBD_SetupReqTyped
 * @{
 */ 
 /* This dummy buffer with 0 values will be sent when there is no availble data */
-static uint8_t IsocInBuffDummy[48*4*2]; 
+static uint8_t IsocInBuffDummy[AUDIO_IN_PACKET]; 
 static  int16_t VOL_CUR;
+
+/* Q15 gain of 0..-36 dB in 1 dB steps, and of 0..-15/16 dB in 1/16 dB steps:
+   their product gives the gain within 0.05 dB over the VOL_MIN..VOL_MAX range */
+static const uint16_t AUDIO_GainDb[37] = 
+{
+  32768, 29205, 26029, 23198, 20675, 18427, 16423, 14637, 13045, 11627,
+  10362,  9235,  8231,  7336,  6538,  5827,  5193,  4629,  4125,  3677,
+   3277,  2920,  2603,  2320,  2068,  1843,  1642,  1464,  1305,  1163,
+   1036,   924,   823,   734,   654,   583,   519
+};
+static const uint16_t AUDIO_GainDbFrac[16] = 
+{
+  32768, 32533, 32300, 32068, 31838, 31610, 31383, 31158, 
+  30935, 30713, 30493, 30274, 30057, 29842, 29628, 29415
+};
+
+/* wChannelConfig spatial locations, indexed by number of channels - 1:
+   mono, L R, L R C, L R Ls Rs (quad array), L R C Ls Rs, 5.1, 6.1, 7.1 */
+static const uint16_t AUDIO_ChannelConfig[8] = 
+{
+  0x0000, 0x0003, 0x0007, 0x0033, 0x0037, 0x003F, 0x013F, 0x00FF
+};
 static USBD_AUDIO_HandleTypeDef haudioInstance;
+/* Stream telemetry: updated in the USB ISR, snapshot sent over EP0 */
+static USBD_AUDIO_StatsTypeDef haudioStats;
+static USBD_AUDIO_StatsTypeDef haudioStatsSnapshot;
+/* Application spectrum, copied by GetSpectrum and sent over EP0 */
+static uint8_t haudioSpectrum[AUDIO_IN_SPECTRUM_MAX_SIZE];
 
 USBD_ClassTypeDef  USBD_AUDIO = 
 {
@@ -158,7 +191,7 @@ USBD_ClassTypeDef  USBD_AUDIO =
 
 /* USB AUDIO device Configuration Descriptor */
 /* NOTE: This descriptor has to be filled using the Descriptor Initialization function */
-__ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ + 9] __ALIGN_END;
+__ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ + 9 + AUDIO_PDM_IF_DESC_SIZE] __ALIGN_END;
 
 /* USB Standard Device Descriptor */
 __ALIGN_BEGIN static uint8_t USBD_AUDIO_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END=
@@ -222,6 +255,15 @@ static uint8_t  USBD_AUDIO_Init (USBD_HandleTypeDef *pdev,
                    IsocInBuffDummy,                        
                    packet_dim);      
   
+#if AUDIO_PDM_BULK_ENABLE
+  USBD_LL_OpenEP(pdev,
+                 AUDIO_PDM_EP,
+                 USBD_EP_TYPE_BULK,
+                 AUDIO_PDM_BULK_PACKET);
+  USBD_LL_FlushEP(pdev, AUDIO_PDM_EP);
+  haudio->pdm_busy = 0;
+#endif
+  
   haudio->state=STATE_USB_IDLE;
   return USBD_OK;
 }
@@ -238,6 +280,9 @@ static uint8_t  USBD_AUDIO_DeInit (USBD_HandleTypeDef *pdev,
 {
   /* Close EP IN */
   USBD_LL_CloseEP(pdev,AUDIO_IN_EP);  
+#if AUDIO_PDM_BULK_ENABLE
+  USBD_LL_CloseEP(pdev,AUDIO_PDM_EP);  
+#endif
   /* DeInit  physical Interface components */
   if(pdev->pClassData != NULL)
   {
@@ -295,6 +340,11 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev,
     }
     break; 
     
+    /* Vendor Requests -------------------------------*/
+  case USB_REQ_TYPE_VENDOR:
+    ret = AUDIO_REQ_Vendor(pdev, req);
+    break;
+    
     /* Standard Requests -------------------------------*/
   case USB_REQ_TYPE_STANDARD:
     switch (req->bRequest)
@@ -319,7 +369,7 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev,
       break;
       
     case USB_REQ_SET_INTERFACE :
-      if ((uint8_t)(req->wValue) < USBD_MAX_NUM_INTERFACES)
+      if ((uint8_t)(req->wValue) < AUDIO_IN_NUM_ALT_SETTINGS)
       {
         haudio->alt_setting = (uint8_t)(req->wValue);
       }
@@ -327,6 +377,7 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev,
       {
         /* Call the error management function (command will be nacked */
         USBD_CtlError (pdev, req);
+        ret = USBD_FAIL;
       }
       break;
     }
@@ -342,7 +393,8 @@ static uint8_t  USBD_AUDIO_Setup (USBD_HandleTypeDef *pdev,
 */
 static uint8_t  *USBD_AUDIO_GetCfgDesc (uint16_t *length)
 {
-  *length = sizeof (USBD_AUDIO_CfgDesc);
+  /* wTotalLength depends on the channels number set by the init function */
+  *length = USBD_AUDIO_CfgDesc[2] | (USBD_AUDIO_CfgDesc[3] << 8);
   return USBD_AUDIO_CfgDesc;
 }
 
@@ -361,11 +413,21 @@ static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev,
   haudio = pdev->pClassData;
   uint32_t length_usb_pck;
   uint16_t app;
+  uint16_t bin;
   uint16_t IsocInWr_app = haudio->wr_ptr;
   uint16_t true_dim = haudio->buffer_length;
   uint16_t packet_dim = haudio->paketDimension;
   uint16_t channels = haudio->channels;
   length_usb_pck = packet_dim;  
+#if AUDIO_PDM_BULK_ENABLE
+  if (epnum == (AUDIO_PDM_EP & 0x7F))
+  {
+    /* Raw PDM buffer sent, the next one can be handed over */
+    haudio->pdm_busy = 0;
+    haudioStats.pdm_frames++;
+    return USBD_OK;
+  }
+#endif
   haudio->timeout=0;
   if (epnum == (AUDIO_IN_EP & 0x7F))
   {    
@@ -384,9 +446,28 @@ static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev,
       }        
       if(app >= (packet_dim*haudio->upper_treshold)){       
         length_usb_pck += channels*2;
+        haudioStats.long_packets++;
       }else if(app <= (packet_dim*haudio->lower_treshold)){
         length_usb_pck -= channels*2;
+        haudioStats.short_packets++;
       }     
+      /* Ring fill statistics: compares and a shift only, no division here */
+      haudioStats.packets++;
+      if(app < haudioStats.fill_min)
+      {
+        haudioStats.fill_min = app;
+      }
+      if(app > haudioStats.fill_max)
+      {
+        haudioStats.fill_max = app;
+      }
+      bin = app >> haudioStats.fill_bin_shift;
+      if(bin >= AUDIO_IN_FILL_HIST_BINS)
+      {
+        bin = AUDIO_IN_FILL_HIST_BINS - 1;
+      }
+      haudioStats.fill_histogram[bin]++;
+
       USBD_LL_Transmit (pdev,AUDIO_IN_EP,
                         (uint8_t*)(&haudio->buffer[haudio->rd_ptr]),
                         length_usb_pck);      
@@ -397,6 +478,7 @@ static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev,
         ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->Stop();
         haudio->state = STATE_USB_IDLE; 
         haudio->timeout=0;
+        haudioStats.resets++;
         memset(haudio->buffer,0,(haudio->buffer_length + haudio->dataAmount));
       }       
     }
@@ -405,6 +487,7 @@ static uint8_t USBD_AUDIO_DataIn (USBD_HandleTypeDef *pdev,
       USBD_LL_Transmit (pdev,AUDIO_IN_EP,
                         IsocInBuffDummy,
                         length_usb_pck);      
+      haudioStats.silent_packets++;
     }    
   }
   return USBD_OK;
@@ -423,9 +506,20 @@ static uint8_t  USBD_AUDIO_EP0_RxReady (USBD_HandleTypeDef *pdev)
   haudio = pdev->pClassData;  
   if (haudio->control.cmd == AUDIO_REQ_SET_CUR)
   {    
-    if (haudio->control.unit == AUDIO_OUT_STREAMING_CTRL)
+    if (haudio->control.unit == MIC_FU_ID)
     {
-      ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->VolumeCtl(VOL_CUR);    
+      if (haudio->control.selector == AUDIO_FU_MUTE_CONTROL)
+      {
+        haudio->mute = haudio->control.data[0];
+        ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->MuteCtl(haudio->mute);
+      }
+      else
+      {
+        VOL_CUR = (int16_t)(haudio->control.data[0] | (haudio->control.data[1] << 8));
+        ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->VolumeCtl(VOL_CUR);    
+      }
+      /* Picked up by the next copy into the USB ring */
+      haudio->gain_target = haudio->mute ? 0 : AUDIO_IN_VolumeToGain(VOL_CUR);
       
       haudio->control.cmd = 0;
       haudio->control.len = 0;
@@ -575,6 +669,14 @@ static void AUDIO_REQ_GetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
   USBD_AUDIO_HandleTypeDef   *haudio;
   haudio = pdev->pClassData;
   
+  if (HIBYTE(req->wValue) == AUDIO_FU_MUTE_CONTROL)
+  {
+    (haudio->control.data)[0] = haudio->mute;
+    USBD_CtlSendData (pdev, 
+                      haudio->control.data,
+                      MIN(req->wLength, 1));  
+    return;
+  }
   (haudio->control.data)[0] = (uint16_t)VOL_CUR & 0xFF;
   (haudio->control.data)[1] = ((uint16_t)VOL_CUR & 0xFF00 ) >> 8;
   
@@ -598,16 +700,160 @@ static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef
   {
     /* Prepare the reception of the buffer over EP0 */
     USBD_CtlPrepareRx (pdev,
-                       (uint8_t *)&VOL_CUR,
-                       req->wLength);
+                       haudio->control.data,
+                       MIN(req->wLength, USB_MAX_EP0_SIZE));
     
     haudio->control.cmd = AUDIO_REQ_SET_CUR;     /* Set the request value */
     haudio->control.len = req->wLength;          /* Set the request data length */
     haudio->control.unit = HIBYTE(req->wIndex);  /* Set the request target unit */
+    haudio->control.selector = HIBYTE(req->wValue); /* Set the request control selector */
+  }
+}
+
+/**
+* @brief  AUDIO_REQ_Vendor
+*         Handles the vendor requests giving access to the stream telemetry
+*         and to the spectrum of the application.
+* @param  pdev: instance
+* @param  req: setup vendor request
+* @retval USBD_FAIL if the request was stalled, USBD_OK otherwise
+*/
+static uint8_t AUDIO_REQ_Vendor(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
+{
+  USBD_AUDIO_ItfTypeDef *itf = (USBD_AUDIO_ItfTypeDef *)pdev->pUserData;
+  uint16_t len;
+  
+  switch (req->bRequest)
+  {
+  case AUDIO_REQ_VENDOR_GET_STATS:
+    /* An IN request without data stage is malformed */
+    if(req->wLength == 0)
+    {
+      USBD_CtlError (pdev, req);
+      return USBD_FAIL;
+    }
+    /* Counters keep running while EP0 sends, send a coherent copy */
+    USBD_AUDIO_GetStats(&haudioStatsSnapshot);
+    USBD_CtlSendData (pdev, 
+                      (uint8_t *)&haudioStatsSnapshot,
+                      MIN(sizeof(haudioStatsSnapshot), req->wLength));
+    break;
+    
+  case AUDIO_REQ_VENDOR_CLEAR_STATS:
+    /* No data stage: USBD_StdItfReq sends the status stage on return */
+    if(req->wLength != 0)
+    {
+      USBD_CtlError (pdev, req);
+      return USBD_FAIL;
+    }
+    USBD_AUDIO_ClearStats();
+    break;
+    
+  case AUDIO_REQ_VENDOR_GET_SPECTRUM:
+    /* The application copies its last published spectrum, EP0 sends the copy */
+    len = AUDIO_IN_SPECTRUM_MAX_SIZE;
+    if((req->wLength == 0) || (itf->GetSpectrum == NULL) || (itf->GetSpectrum(haudioSpectrum, &len) != USBD_OK))
+    {
+      USBD_CtlError (pdev, req);
+      return USBD_FAIL;
+    }
+    USBD_CtlSendData (pdev, 
+                      haudioSpectrum,
+                      MIN(MIN(len, AUDIO_IN_SPECTRUM_MAX_SIZE), req->wLength));
+    break;
+    
+  default:
+    USBD_CtlError (pdev, req);
+    return USBD_FAIL;
   }
+  return USBD_OK;
 }
 
 
+/**
+* @brief  AUDIO_IN_VolumeToGain
+*         Converts a feature unit volume to the Q15 digital gain.
+* @param  volume: volume in 1/256 dB, VOL_MIN..VOL_MAX, 0x8000 is silence
+* @retval Gain, AUDIO_IN_GAIN_UNITY is 0 dB
+*/
+static int32_t AUDIO_IN_VolumeToGain(int16_t volume)
+{
+  uint32_t attenuation;
+  uint32_t index;
+  
+  if (volume == (int16_t)0x8000)
+  {
+    return 0;
+  }
+  if (volume >= (int16_t)VOL_MAX)
+  {
+    return AUDIO_IN_GAIN_UNITY;
+  }
+  if (volume < (int16_t)VOL_MIN)
+  {
+    volume = (int16_t)VOL_MIN;
+  }
+  /* Attenuation rounded to 1/16 dB: integer dB in bits 7:4, 1/16 dB in bits 3:0 */
+  attenuation = (uint32_t)(-(int32_t)volume);
+  index = (attenuation + 8) >> 4;
+  return ((int32_t)AUDIO_GainDb[index >> 4] * AUDIO_GainDbFrac[index & 0x0F] + (1 << 14)) >> 15;
+}
+
+/**
+* @brief  AUDIO_IN_CopyWithGain
+*         Copies a block of samples into the USB ring applying the feature 
+*         unit gain, ramped linearly over the block towards its target.
+* @param  haudio: class handle
+* @param  dst: destination in the USB ring
+* @param  src: interleaved PCM samples
+* @param  samples: number of samples, all the channels included
+* @retval None
+*/
+static void AUDIO_IN_CopyWithGain(USBD_AUDIO_HandleTypeDef *haudio, int16_t *dst, int16_t *src, uint16_t samples)
+{
+  int32_t gain = haudio->gain;
+  int32_t target = haudio->gain_target;
+  int32_t step;
+  uint16_t frames = samples / haudio->channels;
+  uint16_t index;
+  uint8_t ch;
+  
+  if (gain == target)
+  {
+    if (gain == AUDIO_IN_GAIN_UNITY)
+    {
+      memcpy(dst, src, samples * 2);
+    }
+    else
+    {
+      for (index = 0; index < samples; index++)
+      {
+        dst[index] = (int16_t)((src[index] * gain) >> 15);
+      }
+    }
+    return;
+  }
+  
+  if (target - gain > AUDIO_IN_GAIN_RAMP_STEP)
+  {
+    target = gain + AUDIO_IN_GAIN_RAMP_STEP;
+  }
+  else if (gain - target > AUDIO_IN_GAIN_RAMP_STEP)
+  {
+    target = gain - AUDIO_IN_GAIN_RAMP_STEP;
+  }
+  step = (target - gain) / frames;
+  for (index = 0; index < frames; index++)
+  {
+    for (ch = 0; ch < haudio->channels; ch++)
+    {
+      *dst++ = (int16_t)((*src++ * gain) >> 15);
+    }
+    gain += step;
+  }
+  haudio->gain = target;
+}
+
 /**
 * @}
 */ 
@@ -653,6 +899,13 @@ uint8_t  USBD_AUDIO_Data_Transfer(USBD_HandleTypeDef *pdev, int16_t * audioData,
     haudio->lower_treshold = wr_rd_offset - 1;
     haudio->buffer_length = (packet_dim * (dataAmount / packet_dim) * AUDIO_IN_PACKET_NUM);
     
+    /*Histogram bin width, chosen here so that DataIn only has to shift*/
+    haudioStats.fill_bin_shift = 0;
+    while(((haudio->buffer_length - 1) >> haudioStats.fill_bin_shift) >= AUDIO_IN_FILL_HIST_BINS)
+    {
+      haudioStats.fill_bin_shift++;
+    }
+    
     /*Memory allocation for data buffer, depending (also) on data amount passed to the transfer function*/
     if(haudio->buffer != NULL)
     {
@@ -672,8 +925,9 @@ uint8_t  USBD_AUDIO_Data_Transfer(USBD_HandleTypeDef *pdev, int16_t * audioData,
       haudio->state=STATE_USB_IDLE;
       ((USBD_AUDIO_ItfTypeDef *)pdev->pUserData)->Stop();   
      haudio->timeout=0;
+     haudioStats.timeouts++;
     }
-    memcpy((uint8_t * )&haudio->buffer[haudio->wr_ptr], (uint8_t *)(audioData), dataAmount);    
+    AUDIO_IN_CopyWithGain(haudio, (int16_t *)&haudio->buffer[haudio->wr_ptr], audioData, PCMSamples);    
     haudio->wr_ptr += dataAmount;
     haudio->wr_ptr = haudio->wr_ptr % (true_dim);    
     if((haudio->wr_ptr-dataAmount) == 0){
@@ -698,23 +952,152 @@ uint8_t  USBD_AUDIO_RegisterInterface  (USBD_HandleTypeDef   *pdev,
   }
   return 0;}
 
+#if AUDIO_PDM_BULK_ENABLE
+/**
+* @brief  Checks that a raw PDM stream fits, together with the isochronous
+*         audio stream set by USBD_AUDIO_Init_Microphone_Descriptor, in the 
+*         bulk budget of a full speed frame.
+* @param  bytesPerMs: raw PDM bytes produced each millisecond, all the 
+*         microphones included (3072 KHz PDM clock: 384 bytes per microphone)
+* @retval USBD_OK if the stream fits, USBD_FAIL otherwise
+*/
+uint8_t USBD_AUDIO_PDM_CheckBandwidth(uint32_t bytesPerMs)
+{
+  uint32_t isoc = AUDIO_IN_PACKET_SIZE(haudioInstance.frequency, haudioInstance.channels);
+  
+  if(bytesPerMs + isoc > AUDIO_PDM_FRAME_BUDGET)
+  {
+    return USBD_FAIL;
+  }
+  return USBD_OK;
+}
+
+/**
+* @brief  USBD_AUDIO_PDM_Transfer
+*         Sends a raw PDM buffer on the bulk endpoint. The buffer is sent in 
+*         place: it must not be written until the transfer is over, which the
+*         BSP double buffer mode (BSP_AUDIO_IN_SetPDMDoubleBuffer) guarantees
+*         when BSP_AUDIO_IN_PDMBufferBusy returns USBD_AUDIO_PDM_IsBusy.
+* @param pdev: device instance
+* @param pdmData: byte-interleaved PDM data, as returned by BSP_AUDIO_IN_GetPDMBuffer(),
+*         NULL for a frame dropped by the BSP
+* @param length: number of bytes to be sent
+* @retval USBD_OK, USBD_BUSY if the previous buffer is still being sent or
+*         the frame was dropped: both count as pdm_overruns
+*/
+uint8_t USBD_AUDIO_PDM_Transfer(USBD_HandleTypeDef *pdev, uint8_t *pdmData, uint16_t length)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef *)pdev->pClassData;
+  
+  if(haudioInstance.state==STATE_USB_WAITING_FOR_INIT){    
+    return USBD_BUSY;    
+  }  
+  if((pdmData == NULL) || haudio->pdm_busy)
+  {
+    haudioStats.pdm_overruns++;
+    return USBD_BUSY;
+  }
+  haudio->pdm_busy = 1;
+  haudio->pdm_data = pdmData;
+  USBD_LL_Transmit(pdev, AUDIO_PDM_EP, pdmData, length);
+  return USBD_OK;
+}
+
+/**
+* @brief  USBD_AUDIO_PDM_IsBusy
+*         Tells whether a raw PDM buffer is still being sent on the bulk endpoint.
+* @param pdev: device instance
+* @param pdmData: buffer passed to USBD_AUDIO_PDM_Transfer
+* @retval 1 if the buffer must not be written yet, 0 otherwise
+*/
+uint8_t USBD_AUDIO_PDM_IsBusy(USBD_HandleTypeDef *pdev, uint8_t *pdmData)
+{
+  USBD_AUDIO_HandleTypeDef   *haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef *)pdev->pClassData;
+  
+  if(haudio == NULL)
+  {
+    return 0;
+  }
+  return (haudio->pdm_busy && (haudio->pdm_data == pdmData)) ? 1 : 0;
+}
+#endif
+
+/**
+* @brief  Copies the stream telemetry counters.
+* @param  stats: destination of the copy
+* @retval None
+*/
+void USBD_AUDIO_GetStats(USBD_AUDIO_StatsTypeDef *stats)
+{
+  memcpy(stats, &haudioStats, sizeof(USBD_AUDIO_StatsTypeDef));
+}
+
+/**
+* @brief  Clears the stream telemetry counters. The histogram bin width is kept.
+* @param  None
+* @retval None
+*/
+void USBD_AUDIO_ClearStats(void)
+{
+  uint16_t shift = haudioStats.fill_bin_shift;
+  memset(&haudioStats, 0, sizeof(USBD_AUDIO_StatsTypeDef));
+  haudioStats.fill_min = 0xFFFF;
+  haudioStats.fill_bin_shift = shift;
+}
+
+/**
+* @brief  Checks that a sampling frequency and channels number pair can be 
+*         streamed on the full speed isochronous endpoint.
+* @param  samplingFrequency: sampling frequency, multiple of 1 KHz
+* @param  Channels: number of channels
+* @retval USBD_OK if the configuration fits, USBD_FAIL otherwise
+*/
+uint8_t USBD_AUDIO_CheckBandwidth(uint32_t samplingFrequency, uint8_t Channels)
+{
+  if((Channels == 0) || (Channels > AUDIO_IN_MAX_CHANNELS))
+  {
+    return USBD_FAIL;
+  }
+  /* Packets carry an integer number of samples per frame */
+  if((samplingFrequency == 0) || (samplingFrequency % 1000 != 0) || 
+     (samplingFrequency > AUDIO_IN_MAX_FREQ))
+  {
+    return USBD_FAIL;
+  }
+  if(AUDIO_IN_PACKET_SIZE(samplingFrequency, Channels) > AUDIO_IN_PACKET)
+  {
+    return USBD_FAIL;
+  }
+  return USBD_OK;
+}
+
 /**
 * @brief  Configures the microphone descriptor on the base of the frequency 
 *         and channels number informations. These parameters will be used to
 *         init the audio engine, trough the USB interface functions.
 * @param  samplingFrequency: sampling frequency
 * @param  Channels: number of channels
-* @retval status
+* @retval USBD_OK, USBD_FAIL if the configuration exceeds the bandwidth planner
 */
-void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t samplingFrequency, uint8_t Channels)
+uint8_t USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t samplingFrequency, uint8_t Channels)
 {
   uint16_t index;
   uint8_t AUDIO_CONTROLS;   
+  uint16_t wMaxPacketSize;
+  
+  if(USBD_AUDIO_CheckBandwidth(samplingFrequency, Channels) != USBD_OK)
+  {
+    return USBD_FAIL;
+  }
+  wMaxPacketSize = AUDIO_IN_PACKET_SIZE(samplingFrequency, Channels);
+  
   USBD_AUDIO_CfgDesc[0] = 0x09;                                                /* bLength */
   USBD_AUDIO_CfgDesc[1] = 0x02;                                                /* bDescriptorType */
-  USBD_AUDIO_CfgDesc[2] = ((USB_AUDIO_CONFIG_DESC_SIZ+Channels-1)&0xff);       /* wTotalLength */
-  USBD_AUDIO_CfgDesc[3] = ((USB_AUDIO_CONFIG_DESC_SIZ+Channels-1)>>8);
-  USBD_AUDIO_CfgDesc[4] = 0x02;                                                /* bNumInterfaces */
+  USBD_AUDIO_CfgDesc[2] = ((USB_AUDIO_CONFIG_DESC_SIZ+Channels-1+AUDIO_PDM_IF_DESC_SIZE)&0xff); /* wTotalLength */
+  USBD_AUDIO_CfgDesc[3] = ((USB_AUDIO_CONFIG_DESC_SIZ+Channels-1+AUDIO_PDM_IF_DESC_SIZE)>>8);
+  USBD_AUDIO_CfgDesc[4] = AUDIO_NUM_INTERFACES;                                /* bNumInterfaces */
   USBD_AUDIO_CfgDesc[5] = 0x01;                                                /* bConfigurationValue */
   USBD_AUDIO_CfgDesc[6] = 0x00;                                                /* iConfiguration */
   USBD_AUDIO_CfgDesc[7] = 0x80;                                                /* bmAttributes  BUS Powered*/
@@ -748,16 +1131,8 @@ void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t
   USBD_AUDIO_CfgDesc[32] = 0x02;
   USBD_AUDIO_CfgDesc[33] = 0x00;                                               /* bAssocTerminal */
   USBD_AUDIO_CfgDesc[34] = Channels;                                           /* bNrChannels */   
-  if(Channels != 2)
-  {
-    USBD_AUDIO_CfgDesc[35] = 0x00;                                             /* wChannelConfig 0x0000  Mono */
-    USBD_AUDIO_CfgDesc[36] = 0x00;
-  }
-  else
-  {
-    USBD_AUDIO_CfgDesc[35] = 0x03;                                             /* wChannelConfig 0x0003  Stereo */
-    USBD_AUDIO_CfgDesc[36] = 0x00;
-  }   
+  USBD_AUDIO_CfgDesc[35] = AUDIO_ChannelConfig[Channels-1]&0xFF;              /* wChannelConfig */
+  USBD_AUDIO_CfgDesc[36] = AUDIO_ChannelConfig[Channels-1]>>8;
   USBD_AUDIO_CfgDesc[37] = 0x00;                                               /* iChannelNames */
   USBD_AUDIO_CfgDesc[38] = 0x00;                                               /* iTerminal */   
   /* USB Microphone Audio Feature Unit Descriptor */
@@ -860,8 +1235,8 @@ void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t
   USBD_AUDIO_CfgDesc[index++] = AUDIO_STREAMING_FORMAT_TYPE;                   /* bDescriptorSubtype */
   USBD_AUDIO_CfgDesc[index++] = AUDIO_FORMAT_TYPE_I;                           /* bFormatType */
   USBD_AUDIO_CfgDesc[index++] = Channels;                                      /* bNrChannels */
-  USBD_AUDIO_CfgDesc[index++] = 0x02;                                          /* bSubFrameSize */
-  USBD_AUDIO_CfgDesc[index++] = 16;                                            /* bBitResolution */
+  USBD_AUDIO_CfgDesc[index++] = AUDIO_IN_BYTES_PER_SAMPLE;                     /* bSubFrameSize */
+  USBD_AUDIO_CfgDesc[index++] = AUDIO_IN_BIT_RESOLUTION;                       /* bBitResolution */
   USBD_AUDIO_CfgDesc[index++] = 0x01;                                           /* bSamFreqType */
   USBD_AUDIO_CfgDesc[index++] = samplingFrequency&0xff;                        /* tSamFreq 8000 = 0x1F40 */
   USBD_AUDIO_CfgDesc[index++] = (samplingFrequency>>8)&0xff;
@@ -871,8 +1246,8 @@ void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t
   USBD_AUDIO_CfgDesc[index++] = 0x05;                                          /* bDescriptorType */
   USBD_AUDIO_CfgDesc[index++] = AUDIO_IN_EP;                                   /* bEndpointAddress 1 in endpoint*/
   USBD_AUDIO_CfgDesc[index++] = 0x05;                                          /* bmAttributes */
-  USBD_AUDIO_CfgDesc[index++] = ((samplingFrequency/1000+2)*Channels*2)&0xFF;  /* wMaxPacketSize */ 
-  USBD_AUDIO_CfgDesc[index++] = ((samplingFrequency/1000+2)*Channels*2)>>8; 
+  USBD_AUDIO_CfgDesc[index++] = wMaxPacketSize&0xFF;                           /* wMaxPacketSize */ 
+  USBD_AUDIO_CfgDesc[index++] = wMaxPacketSize>>8; 
   USBD_AUDIO_CfgDesc[index++] = 0x01;                                          /* bInterval */
   USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bRefresh */
   USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bSynchAddress */   
@@ -884,8 +1259,29 @@ void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t
   USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bLockDelayUnits */
   USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* wLockDelay */
   USBD_AUDIO_CfgDesc[index++] = 0x00;    
+#if AUDIO_PDM_BULK_ENABLE
+  /* Raw PDM Standard Interface Descriptor - Vendor specific */
+  /* Interface 2, Alternate Setting 0                       */
+  USBD_AUDIO_CfgDesc[index++] = 9;                                             /* bLength */
+  USBD_AUDIO_CfgDesc[index++] = USB_INTERFACE_DESCRIPTOR_TYPE;                 /* bDescriptorType */
+  USBD_AUDIO_CfgDesc[index++] = 0x02;                                          /* bInterfaceNumber */
+  USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bAlternateSetting */
+  USBD_AUDIO_CfgDesc[index++] = 0x01;                                          /* bNumEndpoints */
+  USBD_AUDIO_CfgDesc[index++] = 0xFF;                                          /* bInterfaceClass Vendor specific */
+  USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bInterfaceSubClass */
+  USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bInterfaceProtocol */
+  USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* iInterface */   
+  /* Endpoint 2 - Bulk IN Standard Descriptor */
+  USBD_AUDIO_CfgDesc[index++] = 0x07;                                          /* bLength */
+  USBD_AUDIO_CfgDesc[index++] = 0x05;                                          /* bDescriptorType */
+  USBD_AUDIO_CfgDesc[index++] = AUDIO_PDM_EP;                                  /* bEndpointAddress 2 in endpoint*/
+  USBD_AUDIO_CfgDesc[index++] = 0x02;                                          /* bmAttributes Bulk */
+  USBD_AUDIO_CfgDesc[index++] = AUDIO_PDM_BULK_PACKET&0xFF;                    /* wMaxPacketSize */
+  USBD_AUDIO_CfgDesc[index++] = AUDIO_PDM_BULK_PACKET>>8;
+  USBD_AUDIO_CfgDesc[index++] = 0x00;                                          /* bInterval */
+#endif
     
-  haudioInstance.paketDimension = (samplingFrequency/1000*Channels*2);
+  haudioInstance.paketDimension = (samplingFrequency/1000*Channels*AUDIO_IN_BYTES_PER_SAMPLE);
   haudioInstance.frequency=samplingFrequency;
   haudioInstance.buffer_length = haudioInstance.paketDimension * AUDIO_IN_PACKET_NUM;
   haudioInstance.channels=Channels;  
@@ -896,6 +1292,12 @@ void USBD_AUDIO_Init_Microphone_Descriptor(USBD_HandleTypeDef   *pdev, uint32_t
   haudioInstance.rd_ptr = 0;  
   haudioInstance.dataAmount=0;
   haudioInstance.buffer = 0;
+  haudioInstance.pdm_busy = 0;
+  haudioInstance.mute = 0;
+  haudioInstance.gain = AUDIO_IN_VolumeToGain(VOL_CUR);
+  haudioInstance.gain_target = haudioInstance.gain;
+  USBD_AUDIO_ClearStats();
+  return USBD_OK;
 }
 
 /**
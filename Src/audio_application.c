@@ -44,6 +44,11 @@
 /* Includes ------------------------------------------------------------------*/
 #include "audio_application.h"
 #include "BiquadPresets.h"
+#include "BiquadFit.h"
+#include "BiquadMorph.h"
+#ifdef BIQUAD_BENCH
+#include "SpectrumAnalyzer.h"
+#endif
 
 /** @addtogroup X_CUBE_SOUNDTER1_Applications
 * @{
@@ -60,6 +65,18 @@
 /** @defgroup AUDIO_APPLICATION_Exported_Variables 
 * @{
 */
+#ifdef BIQUAD_BENCH
+/*CPU cycles of BQ_CALC_ComputeFilter for each filter type, to be read with the debugger*/
+uint32_t Biquad_BenchCycles[BIQUAD_CALCULATOR_PEAK + 1];
+/*CPU cycles of a four biquads BQ_CALC_Fit on Biquad_FitMagDb*/
+uint32_t Biquad_FitCycles;
+/*CPU cycles of LOUDNESS_Feed on one output half-buffer*/
+uint32_t Loudness_FeedCycles;
+/*CPU cycles of SPECTRUM_Process on one hop, the FFT and the band averages*/
+uint32_t Spectrum_HopCycles;
+#endif
+/*Preset uploads the I2C write queue could not take whole, retried by Preset_Task*/
+uint32_t Preset_UploadErrors;
 
 /**
 * @}
@@ -68,11 +85,39 @@
 /** @defgroup AUDIO_APPLICATION_Private_Variables 
 * @{
 */
-#define DEMO_NUMBER 5
+#define DEMO_NUMBER 6
 static int16_t Audio_output_buffer[AUDIO_OUTPUT_BUFF_SIZE * 2];
 static uint32_t song_position = 0;
+#ifdef BIQUAD_BENCH
+/*Room measure for the fit timing: a 60 Hz mode, a 150 Hz dip and a rising top*/
+static const float Biquad_FitFreq[] = { 20, 30, 45, 60, 80, 110, 150, 200, 300, 500, 1000, 2000, 5000, 10000 };
+static const float Biquad_FitMagDb[] = { -6, 0, 5, 9, 4, 0, -7, -2, 1, 0, 0, 1, 3, 4 };
+/*Analyzer of the hop timing, fed with the output buffer as stereo PCM*/
+static SPECTRUM_Handler_t Spectrum_Bench;
+#endif
 
 void *STA350BW_X_handle = NULL;
+
+/*Presets are preloaded once in their own RAM bank, then selected with a single EQCFG write*/
+static EQ_Preset_t EQ_Presets[PRESET_NUMBER] =
+{
+  {HPF_1K_EQ_PRESET,      STA350BW_RAM_BANK_FIRST,  0, HPF_1K_EQ_PRESET_DESIGN},
+  {BASS_BOOST2_EQ_PRESET, STA350BW_RAM_BANK_SECOND, 0, NULL},
+  {VOCAL_EQ_PRESET,       STA350BW_RAM_BANK_THIRD,  0, NULL},
+  {LOUDNESS_EQ_PRESET,    STA350BW_RAM_BANK_FIRST,  0, LOUDNESS_EQ_PRESET_DESIGN},
+};
+static __IO uint8_t Active_Preset = PRESET_HPF;
+static __IO uint8_t Preset_Uploading = 0;
+
+/*Morph of the active bank toward Preset_MorphTarget, advanced by Preset_Task 
+at most once per output half-buffer*/
+static BQ_CALC_Morph_t Preset_Morph;
+static __IO uint8_t Preset_Morphing = 0;
+static __IO uint8_t Preset_MorphTarget = PRESET_HPF;
+static __IO uint8_t Preset_BlockElapsed = 0;
+
+/*Loudness of the stream sent to the amplifier, before its EQ and volume*/
+static LOUDNESS_Handler_t Output_Loudness;
 /**
 * @}
 */
@@ -88,8 +133,398 @@ void *STA350BW_X_handle = NULL;
 */
 uint32_t Init_AudioOut_Device(void)
 {
-return BSP_AUDIO_OUT_Init(STA350BW_1, &STA350BW_X_handle, (uint16_t)1, DEFAULT_VOLUME, DEFAULT_SAMPLING_FREQUENCY);
+  if(BSP_AUDIO_OUT_Init(STA350BW_1, &STA350BW_X_handle, (uint16_t)1, DEFAULT_VOLUME, DEFAULT_SAMPLING_FREQUENCY) != COMPONENT_OK)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  /*Soft volume is on after reset: volume changes are ramped over 
+  VOLUME_RAMP_BLOCKS by BSP_AUDIO_OUT_SetVolumeRamp instead*/
+  if(BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_SVE, STA350BW_DISABLE) != COMPONENT_OK)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  /*From now on control writes are queued and sent by the I2C interrupt, so
+  Switch_Demo can run from the button interrupt without waiting for the bus*/
+  if(Sensor_IO_EnableQueue(1) != COMPONENT_OK)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  /*Amplifier faults are reported on the fault line and handled by Fault_Task*/
+  if(BSP_AUDIO_OUT_FaultInit(STA350BW_X_handle) != COMPONENT_OK)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  /*Metered in the DMA callbacks, as each half-buffer is filled*/
+  if(LOUDNESS_Init(&Output_Loudness, DEFAULT_SAMPLING_FREQUENCY, 2) != LOUDNESS_OK)
+  {
+    return COMPONENT_ERROR;
+  }
+  
+  return Init_Presets();
+}
+
+/**
+* @brief  Prepares the EQ presets. Their upload to the device RAM banks is 
+*         deferred to Preset_Task, called from the main loop.
+* @param  None
+* @retval AUDIO_OK if no problem during initialization, AUDIO_ERROR otherwise
+*/
+uint32_t Init_Presets(void)
+{
+  uint32_t i = 0;
+  
+  /*The Second Order High Pass with Fc = 1 KHz (HPF_1K_EQ_PRESET) is designed 
+  at build time, see BiquadPresets_Spec.h*/
+#ifdef BIQUAD_BENCH
+  Biquad_Bench();
+#endif
+  
+  for(i = 0; i < PRESET_NUMBER; i++)
+  {
+    EQ_Presets[i].Loaded = 0;
+  }
+  return AUDIO_OK;
+}
+
+#ifdef BIQUAD_BENCH
+/**
+* @brief  Measures the CPU cycles of BQ_CALC_ComputeFilter for each filter 
+*         type, of a room correction fit, of the output loudness meter and
+*         of a spectrum analyzer hop with the DWT cycle counter. Results are
+*         in Biquad_BenchCycles, Biquad_FitCycles, Loudness_FeedCycles and
+*         Spectrum_HopCycles.
+* @param  None
+* @retval None
+*/
+void Biquad_Bench(void)
+{
+  BIQUAD_Filter_t Biquad_filter;
+  BIQUAD_Filter_t Fit_filters[BQ_CALC_FIT_MAX_BIQUADS];
+  BQ_CALC_Fit_t Fit;
+  uint32_t start = 0;
+  uint32_t type = 0;
+  
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  
+  Biquad_filter.Fs = DEFAULT_SAMPLING_FREQUENCY;
+  Biquad_filter.Fc = 1000;
+  Biquad_filter.Q = 0.80;
+  Biquad_filter.Slope = 1.0;
+  Biquad_filter.Gain = 6.0;
+  
+  for(type = 0; type <= BIQUAD_CALCULATOR_PEAK; type++)
+  {
+    Biquad_filter.Type = type;
+    start = DWT->CYCCNT;
+    BQ_CALC_ComputeFilter(&Biquad_filter);
+    Biquad_BenchCycles[type] = DWT->CYCCNT - start;
+  }
+  
+  Fit.Fs = DEFAULT_SAMPLING_FREQUENCY;
+  Fit.pFreq = Biquad_FitFreq;
+  Fit.pMagDb = Biquad_FitMagDb;
+  Fit.pTargetDb = NULL;
+  Fit.Count = sizeof(Biquad_FitFreq) / sizeof(Biquad_FitFreq[0]);
+  Fit.FreqLow = 25.0f;
+  Fit.FreqHigh = 4000.0f;
+  Fit.MaxBoost = 6.0f;
+  Fit.MaxCut = 15.0f;
+  Fit.Biquads = BQ_CALC_FIT_MAX_BIQUADS;
+  start = DWT->CYCCNT;
+  BQ_CALC_Fit(&Fit, Fit_filters);
+  Biquad_FitCycles = DWT->CYCCNT - start;
+  
+  start = DWT->CYCCNT;
+  LOUDNESS_Feed(&Output_Loudness, Audio_output_buffer, AUDIO_OUTPUT_BUFF_SIZE/2);
+  Loudness_FeedCycles = DWT->CYCCNT - start;
+  LOUDNESS_Init(&Output_Loudness, DEFAULT_SAMPLING_FREQUENCY, 2);
+  
+  /*The first hop only fills the FFT frame, the second one is transformed*/
+  SPECTRUM_Init(&Spectrum_Bench, DEFAULT_SAMPLING_FREQUENCY, 2, SPECTRUM_CHANNEL_MIX, 100);
+  for(type = 0; type < SPECTRUM_FFT_SIZE / SPECTRUM_HOP_SIZE; type++)
+  {
+    SPECTRUM_Feed(&Spectrum_Bench, Audio_output_buffer, SPECTRUM_HOP_SIZE);
+    start = DWT->CYCCNT;
+    SPECTRUM_Process(&Spectrum_Bench);
+    Spectrum_HopCycles = DWT->CYCCNT - start;
+  }
+}
+#endif
+
+/**
+* @brief  Reads the amplifier status after a fault line change and protects
+*         the output while a fault is reported, see BSP_AUDIO_OUT_FaultTask.
+* @param  None
+* @retval None
+*/
+void Fault_Task(void)
+{
+  if(STA350BW_X_handle != NULL)
+  {
+    BSP_AUDIO_OUT_FaultTask(STA350BW_X_handle);
+  }
+}
+
+/**
+* @brief  Writes the volumes reached by the ramps started with 
+*         BSP_AUDIO_OUT_SetVolumeRamp, see BSP_AUDIO_OUT_VolumeTask.
+* @param  None
+* @retval None
+*/
+void Volume_Task(void)
+{
+  if(STA350BW_X_handle != NULL)
+  {
+    BSP_AUDIO_OUT_VolumeTask(STA350BW_X_handle);
+  }
+}
+
+/**
+* @brief  Queues the upload of a preset to its RAM bank. The presets that 
+*         shared the bank are no longer in it, nor is this one if the upload 
+*         fails part way: the bank then holds a mix of coefficient sets.
+* @param  preset: preset index, from PRESET_HPF to PRESET_NUMBER - 1
+* @retval AUDIO_OK if no problem during execution, AUDIO_ERROR otherwise
+*/
+static uint32_t Preset_Upload(uint8_t preset)
+{
+  uint32_t i = 0;
+  
+  for(i = 0; i < PRESET_NUMBER; i++)
+  {
+    if(EQ_Presets[i].Bank == EQ_Presets[preset].Bank)
+    {
+      EQ_Presets[i].Loaded = 0;
+    }
+  }
+  if(BSP_AUDIO_OUT_SetEqBank(STA350BW_X_handle, EQ_Presets[preset].Bank, STA350BW_CHANNEL_MASTER, EQ_Presets[preset].Coefficients) != COMPONENT_OK)
+  {
+    return AUDIO_ERROR;
+  }
+  EQ_Presets[preset].Loaded = 1;
+  return AUDIO_OK;
+}
+
+/**
+* @brief  Tells whether the RAM bank of a preset holds another preset.
+* @param  preset: preset index, from PRESET_HPF to PRESET_NUMBER - 1
+* @retval 1 if another preset of the bank is loaded, 0 otherwise
+*/
+static uint8_t Preset_BankUsed(uint8_t preset)
+{
+  uint32_t i = 0;
+  
+  for(i = 0; i < PRESET_NUMBER; i++)
+  {
+    if(i != preset && EQ_Presets[i].Bank == EQ_Presets[preset].Bank && EQ_Presets[i].Loaded)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+* @brief  Writes the next update of a preset morph, at most one per output 
+*         half-buffer and only when the I2C write queue can take it: the 
+*         same biquad of both channels, MORPH_QUEUE_ENTRIES writes. A 
+*         biquad is written in one burst, so the device never runs half 
+*         old and half new coefficients.
+* @param  None
+* @retval None
+*/
+static void Preset_MorphStep(void)
+{
+  Sensor_IO_QueueStatsTypeDef stats;
+  uint32_t set[K_NUM];
+  uint32_t biquad = 0;
+  uint32_t primask = 0;
+  int32_t ret = BIQUAD_CALCULATOR_ERROR;
+  uint8_t bank = EQ_Presets[Preset_MorphTarget].Bank;
+  
+  if(!Preset_BlockElapsed)
+  {
+    return;
+  }
+  Sensor_IO_GetQueueStats(&stats);
+  if(stats.Pending + MORPH_QUEUE_ENTRIES > NUCLEO_I2C_EXPBD_QUEUE_DEPTH)
+  {
+    return;
+  }
+  Preset_BlockElapsed = 0;
+  
+  /*As for the preload, Preset_Select only records its choice meanwhile*/
+  Preset_Uploading = 1;
+  if(Preset_Morphing)
+  {
+    ret = BQ_CALC_MorphNext(&Preset_Morph, &biquad, set);
+  }
+  if(ret == BIQUAD_CALCULATOR_OK)
+  {
+    BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, bank, STA350BW_CH1_BQ1 + biquad, set);
+    BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, bank, STA350BW_CH2_BQ1 + biquad, set);
+  }
+  
+  primask = __get_PRIMASK();
+  __disable_irq();
+  Preset_Uploading = 0;
+  if(ret != BIQUAD_CALCULATOR_OK)
+  {
+    Preset_Morphing = 0;
+  }
+  if(Active_Preset != Preset_MorphTarget)
+  {
+    /*Another preset was chosen meanwhile, the bank holds neither end. A 
+    preset of another bank is selected now, one of this bank is uploaded 
+    again by the preload*/
+    Preset_Morphing = 0;
+    EQ_Presets[Preset_MorphTarget].Loaded = 0;
+    if(EQ_Presets[Active_Preset].Loaded)
+    {
+      BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT, EQ_Presets[Active_Preset].Bank);
+    }
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+* @brief  Background preload of the EQ presets, one RAM bank per call and
+*         only when the I2C write queue can take the whole bank, so that it
+*         never competes with control writes for queue room. Writing a bank
+*         also makes it the processing one, so the active bank is selected
+*         again after each upload. A bank that already holds a preset is 
+*         left alone, and nothing is preloaded while a morph is running.
+* @param  None
+* @retval None
+*/
+void Preset_Task(void)
+{
+  Sensor_IO_QueueStatsTypeDef stats;
+  uint32_t primask = 0;
+  uint32_t i = 0;
+  
+  if(STA350BW_X_handle == NULL)
+  {
+    return;
+  }
+  
+  if(Preset_Morphing)
+  {
+    Preset_MorphStep();
+    return;
+  }
+  
+  Sensor_IO_GetQueueStats(&stats);
+  if(stats.Pending + PRESET_QUEUE_ENTRIES > NUCLEO_I2C_EXPBD_QUEUE_DEPTH)
+  {
+    return;
+  }
+  
+  /*Preset_Select from the button interrupt only records its choice while
+  the upload is being queued, a bank select in between would redirect it*/
+  Preset_Uploading = 1;
+  
+  i = Active_Preset;
+  if(EQ_Presets[i].Loaded)
+  {
+    for(i = 0; i < PRESET_NUMBER; i++)
+    {
+      if(!EQ_Presets[i].Loaded && !Preset_BankUsed(i))
+      {
+        break;
+      }
+    }
+  }
+  if(i == PRESET_NUMBER)
+  {
+    Preset_Uploading = 0;
+    return;
+  }
+  
+  if(Preset_Upload(i) != AUDIO_OK)
+  {
+    /*Left not loaded, the next call uploads the bank again*/
+    Preset_UploadErrors++;
+  }
+  
+  primask = __get_PRIMASK();
+  __disable_irq();
+  Preset_Uploading = 0;
+  BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT, EQ_Presets[Active_Preset].Bank);
+  __set_PRIMASK(primask);
+}
+
+/**
+* @brief  Makes a preset the processing one. Once preloaded this is a single
+*         register write, otherwise the upload is left to Preset_Task, which 
+*         waits for room in the I2C write queue and selects the bank once it 
+*         is queued. Between 
+*         two presets of the same bank that both have a design, the filters 
+*         of the bank are morphed from one to the other instead, over 
+*         MORPH_STEPS steps written by Preset_Task.
+* @param  preset: preset index, from PRESET_HPF to PRESET_NUMBER - 1
+* @retval AUDIO_OK if no problem during execution, AUDIO_ERROR otherwise
+*/
+uint32_t Preset_Select(uint8_t preset)
+{
+  uint8_t from = Active_Preset;
+  
+  if(preset >= PRESET_NUMBER)
+  {
+    return AUDIO_ERROR;
+  }
+  
+  Active_Preset = preset;
+  if(Preset_Uploading)
+  {
+    /*Applied by Preset_Task once its upload is queued*/
+    return AUDIO_OK;
+  }
+  if(Preset_Morphing)
+  {
+    if(preset == Preset_MorphTarget)
+    {
+      return AUDIO_OK;
+    }
+    /*Stopped half way, the bank holds neither end*/
+    Preset_Morphing = 0;
+    EQ_Presets[Preset_MorphTarget].Loaded = 0;
+  }
+  else if(preset != from && EQ_Presets[preset].Bank == EQ_Presets[from].Bank && EQ_Presets[from].Loaded &&
+          EQ_Presets[preset].Design != NULL && EQ_Presets[from].Design != NULL &&
+          BQ_CALC_MorphInit(&Preset_Morph, EQ_Presets[from].Design, EQ_Presets[preset].Design, 
+                            STA350BW_BIQUADS_PER_CHANNEL, MORPH_STEPS) == BIQUAD_CALCULATOR_OK)
+  {
+    /*The bank is the processing one, its filters move to the new preset*/
+    EQ_Presets[from].Loaded = 0;
+    EQ_Presets[preset].Loaded = 1;
+    Preset_MorphTarget = preset;
+    Preset_Morphing = 1;
+    return AUDIO_OK;
+  }
+  if(!EQ_Presets[preset].Loaded)
+  {
+    /*A bank takes most of the queue: not from the button interrupt*/
+    return AUDIO_OK;
+  }
+  return BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT, EQ_Presets[preset].Bank);
+}
 
+/**
+* @brief  Gives the loudness of the output stream, updated every 100 ms, for 
+*         level decisions in the main loop such as the volume or the preset.
+* @param  pReadings: momentary, short-term and integrated loudness in LUFS
+* @retval None
+*/
+void Loudness_Read(LOUDNESS_Readings_t *pReadings)
+{
+  LOUDNESS_GetReadings(&Output_Loudness, pReadings);
 }
 
 /**
@@ -119,32 +554,21 @@ uint32_t Stop_AudioOut_Device(void)
 */
 uint32_t Switch_Demo(void)
 {  
-  BIQUAD_Filter_t Biquad_filter;
   uint8_t ret = 0;    
   static uint8_t current_demo = 0;
   
+  /*Changes of each demo step are merged and written together on commit*/
+  BSP_AUDIO_OUT_BeginUpdate(STA350BW_X_handle);
+  
   switch(current_demo)
   {
   case 0:
     { 
       /*Setup Default Master Volume (in case this has been change during demos*/
-      BSP_AUDIO_OUT_SetVolume(STA350BW_X_handle,  STA350BW_CHANNEL_MASTER ,DEFAULT_VOLUME);      
-      
-      /*Setup a Second Order High Pass with Fc = 1 KHz using the first biq filter for each channel. Coefficients are stored in BANK 1*/
-      /*When coefficients are written to RAM, EQ is automatically activated
-      It's possible to switch between different pre-stores presets switching RAM banks using SetDSPOptions with the STA350BW_RAM_BANK_SELECT
-      parameter, for example:
-      BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT,STA350BW_RAM_BANK_FIRST);*/
+      BSP_AUDIO_OUT_SetVolumeRamp(STA350BW_X_handle,  STA350BW_CHANNEL_MASTER ,DEFAULT_VOLUME, VOLUME_RAMP_BLOCKS);      
       
-      Biquad_filter.Type = BIQUAD_CALCULATOR_SO_HPF;
-      Biquad_filter.Fs = DEFAULT_SAMPLING_FREQUENCY;
-      Biquad_filter.Fc = 1000;
-      Biquad_filter.Q = 0.80;
-      Biquad_filter.Slope = 0; /*Not used for this kind of filter*/
-      Biquad_filter.Gain = 0; /*Not used for this kind of filter*/    
-      BQ_CALC_ComputeFilter(&Biquad_filter);      
-      BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_FIRST, STA350BW_CH1_BQ1, Biquad_filter.Coefficients);
-      BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_FIRST, STA350BW_CH2_BQ1, Biquad_filter.Coefficients); 
+      /*Second Order High Pass with Fc = 1 KHz on the first biquad of each channel, preloaded in BANK 1*/
+      Preset_Select(PRESET_HPF);
       
       /*Remove EQ and Tone bypass  (in case this has been change during demos)*/
       BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_C1EQBP, STA350BW_DISABLE);
@@ -155,46 +579,28 @@ uint32_t Switch_Demo(void)
       break;
     }
   case 1:
-    {      
-      /*Setup a preset for Bass Boost using 4 biquads for each channel. Coefficients are stored in BANK 2*/
-      /*When coefficients are written to RAM, EQ is automatically activated
-      It's possible to switch between different pre-stores presets switching RAM banks using SetDSPOptions with the STA350BW_RAM_BANK_SELECT
-      parameter, for example:
-      BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT,STA350BW_RAM_BANK_FIRST);*/
-      
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ1, (uint32_t *)&BASS_BOOST2_EQ_PRESET[0]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ2, (uint32_t *)&BASS_BOOST2_EQ_PRESET[5]);  
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ3, (uint32_t *)&BASS_BOOST2_EQ_PRESET[10]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ4, (uint32_t *)&BASS_BOOST2_EQ_PRESET[15]);
+    {
+      /*Loudness preset in BANK 1 as well: the filters morph from the high 
+      pass over MORPH_STEPS steps, one biquad per half-buffer*/
+      ret = Preset_Select(PRESET_LOUDNESS);
       
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH2_BQ1, (uint32_t *)&BASS_BOOST2_EQ_PRESET[0]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH2_BQ2, (uint32_t *)&BASS_BOOST2_EQ_PRESET[5]);  
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH2_BQ3, (uint32_t *)&BASS_BOOST2_EQ_PRESET[10]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH2_BQ4, (uint32_t *)&BASS_BOOST2_EQ_PRESET[15]);    
+      break; 
+    }
+  case 2:
+    {      
+      /*Bass Boost preset using 4 biquads for each channel, preloaded in BANK 2*/
+      ret = Preset_Select(PRESET_BASS_BOOST);
       
       break; 
     }    
-  case 2:
+  case 3:
     {
-      /*Setup a preset for Vocal using 4 biquads for each channel. Coefficients are stored in BANK 3*/
-      /*When coefficients are written to RAM, EQ is automatically activated
-      It's possible to switch between different pre-stores presets switching RAM banks using SetDSPOptions with the STA350BW_RAM_BANK_SELECT
-      parameter, for example:
-      BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_RAM_BANK_SELECT,STA350BW_RAM_BANK_FIRST);*/
-      
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH1_BQ1, (uint32_t *)&VOCAL_EQ_PRESET[0]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH1_BQ2, (uint32_t *)&VOCAL_EQ_PRESET[5]);  
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH1_BQ3, (uint32_t *)&VOCAL_EQ_PRESET[10]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH1_BQ4, (uint32_t *)&VOCAL_EQ_PRESET[15]);
-      
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH2_BQ1, (uint32_t *)&VOCAL_EQ_PRESET[0]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH2_BQ2, (uint32_t *)&VOCAL_EQ_PRESET[5]);  
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH2_BQ3, (uint32_t *)&VOCAL_EQ_PRESET[10]);
-      ret = BSP_AUDIO_OUT_SetEq(STA350BW_X_handle, STA350BW_RAM_BANK_THIRD, STA350BW_CH2_BQ4, (uint32_t *)&VOCAL_EQ_PRESET[15]);
+      /*Vocal preset using 4 biquads for each channel, preloaded in BANK 3*/
+      ret = Preset_Select(PRESET_VOCAL);
       
       break; 
     }     
-  case 3:
+  case 4:
     {
       /*Bypass BIQ Filters for both channels*/ 
       BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_C1EQBP,STA350BW_ENABLE);
@@ -205,17 +611,21 @@ uint32_t Switch_Demo(void)
       
       break; 
     }  
-  case 4:
+  case 5:
     {
       /*Bypass tone control for both channels*/
       BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_C1TCB,STA350BW_ENABLE);
       BSP_AUDIO_OUT_SetDSPOption(STA350BW_X_handle, STA350BW_C2TCB,STA350BW_ENABLE);
       
       /*Modify master volume*/
-      BSP_AUDIO_OUT_SetVolume(STA350BW_X_handle,  STA350BW_CHANNEL_MASTER ,0X60);      
+      BSP_AUDIO_OUT_SetVolumeRamp(STA350BW_X_handle,  STA350BW_CHANNEL_MASTER ,0X60, VOLUME_RAMP_BLOCKS);      
       break; 
     }  
   }
+  if(BSP_AUDIO_OUT_CommitUpdate(STA350BW_X_handle) != COMPONENT_OK)
+  {
+    ret = COMPONENT_ERROR;
+  }
   current_demo = (current_demo + 1) % DEMO_NUMBER;
   return ret;
 }
@@ -230,12 +640,16 @@ void BSP_AUDIO_OUT_HalfTransfer_CallBack(uint16_t OutputDevice)
 { 
   uint32_t i = 0;
 
+  /*Paces the preset morph*/
+  Preset_BlockElapsed = 1;
+  
   /*Copy song fragment to Audio Output buffer*/
   for(i=0; i<AUDIO_OUTPUT_BUFF_SIZE/2; i++){    
     Audio_output_buffer[2*i]= Fragment1[song_position]; /*Left Channel*/
     Audio_output_buffer[2*i + 1]= Fragment1[song_position]; /*Right Channel*/
     song_position = (song_position +1) % Fragment1_size;
   }
+  LOUDNESS_Feed(&Output_Loudness, &Audio_output_buffer[0], AUDIO_OUTPUT_BUFF_SIZE/2);
   
 }
 
@@ -249,6 +663,10 @@ void BSP_AUDIO_OUT_TransferComplete_CallBack(uint16_t OutputDevice)
 {
 
   uint32_t i = 0;
+  
+  /*Paces the preset morph*/
+  Preset_BlockElapsed = 1;
+  
   /*Copy song fragment to Audio Output buffer*/
   for(i=AUDIO_OUTPUT_BUFF_SIZE/2; i<AUDIO_OUTPUT_BUFF_SIZE; i++)
   {    
@@ -256,6 +674,7 @@ void BSP_AUDIO_OUT_TransferComplete_CallBack(uint16_t OutputDevice)
     Audio_output_buffer[2*i + 1]= Fragment1[song_position]; /*Right Channel*/
     song_position = (song_position +1) % Fragment1_size;
   }  
+  LOUDNESS_Feed(&Output_Loudness, &Audio_output_buffer[AUDIO_OUTPUT_BUFF_SIZE], AUDIO_OUTPUT_BUFF_SIZE/2);
 }
 
 /**
@@ -271,6 +690,10 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
     BSP_LED_Toggle(LED2);
     Switch_Demo();    
   }
+  else
+  {
+    BSP_AUDIO_OUT_FaultCallback(GPIO_Pin);
+  }
 }
 /**
 * @}
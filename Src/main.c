@@ -133,7 +133,14 @@ int main(void)
   /* USER CODE END WHILE */
 
   /* USER CODE BEGIN 3 */
-
+    /* I2C bus recovery and retries of the queued control writes */
+    Sensor_IO_Task();
+    /* Amplifier fault handling, deferred from the fault line interrupt */
+    Fault_Task();
+    /* Volume ramps, counted by the output interrupts */
+    Volume_Task();
+    /* Preload EQ presets in the STA350BW RAM banks */
+    Preset_Task();
   }
   /* USER CODE END 3 */
 
@@ -36,9 +36,15 @@
 #include "stm32f4xx_it.h"
 
 /* USER CODE BEGIN 0 */
+#include "x_nucleo_cca01m1_audio_f4.h"
 extern I2S_HandleTypeDef hAudioOutI2s[];  
 #define AUDIO_OUT1_IRQHandler                 	DMA1_Stream4_IRQHandler
 #define AUDIO_OUT2_IRQHandler                   DMA1_Stream7_IRQHandler
+extern I2C_HandleTypeDef I2C_EXPBD_Handle;
+#define NUCLEO_I2C_EXPBD_EV_IRQHandler          I2C1_EV_IRQHandler
+#define NUCLEO_I2C_EXPBD_ER_IRQHandler          I2C1_ER_IRQHandler
+#define AUDIO_OUT1_INT_IRQHandler               EXTI1_IRQHandler
+#define AUDIO_OUT2_INT_IRQHandler               EXTI0_IRQHandler
 
 /* USER CODE END 0 */
 
@@ -122,5 +128,45 @@ void AUDIO_OUT2_IRQHandler(void)
   HAL_DMA_IRQHandler(hAudioOutI2s[1].hdmatx);
 }
 
+/**
+  * @brief  This function handles I2C event interrupt request for the expansion board bus.
+  * @param  None
+  * @retval None
+  */
+void NUCLEO_I2C_EXPBD_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&I2C_EXPBD_Handle);
+}
+
+/**
+  * @brief  This function handles I2C error interrupt request for the expansion board bus.
+  * @param  None
+  * @retval None
+  */
+void NUCLEO_I2C_EXPBD_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&I2C_EXPBD_Handle);
+}
+
+/**
+  * @brief  This function handles the fault line interrupt of the First Device.
+  * @param  None
+  * @retval None
+  */
+void AUDIO_OUT1_INT_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(AUDIO_OUT1_INT_PIN);
+}
+
+/**
+  * @brief  This function handles the fault line interrupt of the Second Device.
+  * @param  None
+  * @retval None
+  */
+void AUDIO_OUT2_INT_IRQHandler(void)
+{
+  HAL_GPIO_EXTI_IRQHandler(AUDIO_OUT2_INT_PIN);
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,668 @@
+/**
+******************************************************************************
+* @file    bq_calc_bench.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host bench of BQ_CALC_ComputeFilter against the former libm based
+*          computation, kept here as the reference.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadCalc_Bench/bq_calc_bench.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    -lm -o bq_calc_bench
+*
+*          Every filter type is swept over the sampling frequencies of the
+*          demo, Fc from 20 Hz to Fs / 2, Q from 0.5 to 10 and gains from -15
+*          to +15 dB. The bench prints, per type, the largest coefficient
+*          difference in LSB of the 1.23 format, the range changes and the
+*          time per call of both versions, and fails when the difference goes
+*          over BQ_CALC_MAX_ERROR_LSB. A second sweep, from 5 Hz and up to Q 20
+*          and +/-24 dB, checks the range and stability of the filters of
+*          BQ_CALC_ComputeFilterRange.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "BiquadCalculator.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_TYPES               10
+#define BENCH_FC_STEPS            48
+#define BENCH_TIMING_LOOPS        200
+#define BENCH_BANK_BANDS          8
+#define RANGE_FC_STEPS            64
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Filters;
+  uint32_t RangeChanges;
+  int32_t MaxError;
+  double RefNs;
+  double NewNs;
+}
+Bench_Result_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TypeName[BENCH_TYPES] =
+{
+  "FO_LPF", "FO_HPF", "SO_LPF", "SO_HPF", "LOW_SHELF",
+  "HIGH_SHELF", "NOTCH", "ALL_PASS", "BAND_PASS", "PEAK"
+};
+static const uint32_t BenchFs[] = { 32000, 44100, 48000, 96000 };
+static const float BenchQ[] = { 0.5f, 0.707f, 1.0f, 2.0f, 5.0f, 10.0f };
+static const float BenchGain[] = { -15.0f, -9.0f, -3.0f, -1.0f, 0.0f, 1.0f, 3.0f, 9.0f, 15.0f };
+static const float BenchSlope[] = { 0.5f, 1.0f };
+static const float RangeQ[] = { 0.3f, 0.707f, 2.0f, 5.0f, 10.0f, 20.0f };
+static const float RangeGain[] = { -24.0f, -12.0f, -6.0f, 0.0f, 6.0f, 12.0f, 18.0f, 24.0f };
+static Bench_Result_t Result[BENCH_TYPES];
+static volatile uint32_t Sink;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Former implementation, unchanged */
+static int32_t Ref_ComputeFilter(BIQUAD_Filter_t *pEq)
+{  
+  
+  float omega_c = 0, K = 0, W = 0, DE = 0, alpha = 0, beta = 0, a0 = 0, a1 = 0, a2 = 0,
+  b0 = 0, b1 = 0, b2 = 0;
+  float CoeffSTA350BW[K_NUM];
+  int32_t ret = 0;
+  
+  if(pEq->Fs != 96000)
+  {
+    omega_c = 2.0f * PI * (float) (pEq->Fc) / (float) (pEq->Fs * 2);
+  }
+  else
+  {
+    omega_c = 2.0f * PI * (float) (pEq->Fc) / (float) (pEq->Fs);
+    
+  }
+  K = tanf(omega_c / 2.0f);
+  alpha = 1 + K;
+  W = K * K;
+  DE = 1.0f + (1 / pEq->Q) * K + W;
+  
+  switch (pEq->Type) {
+  case BIQUAD_CALCULATOR_FO_LPF:
+    {
+      a0 = 1;
+      a1 = -((1.0f - K) / alpha);
+      b0 = K / alpha;
+      b1 = K / alpha;
+      a2 = 0;
+      b2 = 0;
+      break;
+    }
+  case BIQUAD_CALCULATOR_FO_HPF:
+    {
+      a0 = 1;
+      a1 = -((1.0f - K) / alpha);
+      b0 = 1 / alpha;
+      b1 = -b0;
+      a2 = 0;
+      b2 = 0;
+      break;
+    }
+  case BIQUAD_CALCULATOR_SO_LPF:
+    {
+      a0 = 1.0f;
+      a1 = 2.0f * (W - 1) / DE;
+      a2 = ((1 - (K / pEq->Q) + W) / DE);
+      b0 = W / DE;
+      b1 = 2.0f * b0;
+      b2 = b0;
+      break;
+    }
+  case BIQUAD_CALCULATOR_SO_HPF:
+    {
+      a0 = 1.0f;
+      a1 = 2.0f * (W - 1) / DE;
+      a2 = ((1 - (K / pEq->Q) + W) / DE);
+      b0 = 1.0f / DE;
+      b1 = -2.0f / DE;
+      b2 = b0;
+      break;
+    }
+  case (BIQUAD_CALCULATOR_PEAK):
+    {
+      float gain = expf((float)(pEq->Gain) * 0.115129254f);
+      if (gain < 1.0f)
+      {
+        float cutValue = 1.0f + K * (1/gain/pEq->Q) + W;
+        a0 = 1.0f;
+        a1 = 2.0f * (W - 1) / cutValue;
+        a2 = ((1 - (1/gain/pEq->Q) * K + W) / cutValue);
+        b0 = (1 + K/pEq->Q + W) / cutValue;
+        b1 = (2.0f * (W - 1)) / cutValue;
+        b2 = (1 - K/pEq->Q + W) / cutValue;
+      }
+      else
+      {
+        float boostValue = 1 + 1/pEq->Q * K + W;
+        a0 = 1;
+        a1 = (2.0f * (W - 1)) / boostValue;
+        a2 = ((1 - (K / pEq->Q) + W) / boostValue);
+        b0 = (1 + K * gain / pEq->Q + W) / boostValue;
+        b1 = 2.0f * (W - 1) / boostValue;
+        b2 = (1 - K * gain / pEq->Q + W) / boostValue;
+      }
+      break;
+    }
+  case BIQUAD_CALCULATOR_LOW_SHELF:
+    {
+      float gain = powf(10.0f, pEq->Gain/40.0f);
+      alpha = (sinf(omega_c) / 2.0f) * sqrtf((gain + (1.0f / gain)) * (1.0f / pEq->Slope - 1.0f) + 2.0f);
+      beta = 2.0f * alpha * sqrtf(gain);
+      a0 = (gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) + beta;
+      a1 = -2.0 * ((gain - 1.0f) + (gain + 1.0f) * cosf(omega_c));
+      a2 = (gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) - beta;
+      b0 = gain * ((gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) + beta);
+      b1 = 2.0f * gain * ((gain - 1.0f) - (gain + 1.0f) * cosf(omega_c));
+      b2 = gain * ((gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) - beta);
+      break;
+    }
+  case BIQUAD_CALCULATOR_HIGH_SHELF:
+    {
+      float gain = powf(10.0f, pEq->Gain/40.0f);
+      alpha = (sinf(omega_c) / 2.0f) * sqrtf((gain + (1.0f / gain)) * (1.0f / pEq->Slope - 1.0f) + 2.0f);
+      beta = 2.0f * alpha * sqrtf(gain);
+      a0 = (gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) + beta;
+      a1 = 2.0f * ((gain - 1.0f) - (gain + 1.0f) * cosf(omega_c));
+      a2 = (gain + 1.0f) - (gain - 1.0f) * cosf(omega_c) - beta;
+      b0 = gain * ((gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) + beta);
+      b1 = -2.0f * gain * ((gain - 1.0f) + (gain + 1.0f) * cosf(omega_c));
+      b2 = gain * ((gain + 1.0f) + (gain - 1.0f) * cosf(omega_c) - beta);
+      break;
+    }
+  case BIQUAD_CALCULATOR_NOTCH:
+    {
+      alpha = sinf(omega_c)/(2*pEq->Q);
+      a0 = 1.0f + alpha;
+      a1 = -2.0f * cosf(omega_c);
+      a2 = 1.0f - alpha;
+      b0 = 1.0f;
+      b1 = -2.0f * cos(omega_c);
+      b2 = 1.0f;
+      break;
+    }
+  case BIQUAD_CALCULATOR_ALL_PASS:
+    {
+      alpha = sinf(omega_c)/(2*pEq->Q);
+      a0 = 1.0f + alpha;
+      a1 = -2.0f * cosf(omega_c);
+      a2 = 1.0f - alpha;
+      b0 = 1.0f - alpha;
+      b1 = -2.0f * cos(omega_c);
+      b2 = 1.0f + alpha;
+      break;
+    }
+  case BIQUAD_CALCULATOR_BAND_PASS:
+    {
+      alpha = sinf(omega_c) / (2*pEq->Q);
+      float gain = powf(10.0, pEq->Gain / 20.0f);
+      a0 = 1.0f + alpha;
+      a1 = -2.0f * cosf(omega_c);
+      a2 = 1.0f - alpha;
+      b0 = alpha * gain;
+      b1 = 0;
+      b2 = -b0;
+      break;
+    }
+    
+  default:
+    break;
+  }
+  
+  CoeffSTA350BW[0] = (b1 / 2.0f)/a0;
+  CoeffSTA350BW[1] = b2/a0;
+  CoeffSTA350BW[2] = (-a1 / 2.0f)/a0;  
+  CoeffSTA350BW[3] = -a2/a0;
+  CoeffSTA350BW[4] = (b0 / 2.0f)/a0;
+  
+  float max_value = 0.0f;
+  float mult;
+  uint16_t i = 0;
+  
+  for (i = 0; i < K_NUM ; i++)
+  {
+    if(fabs(CoeffSTA350BW[i]) > max_value)
+    {
+      max_value = fabs(CoeffSTA350BW[i]);
+    }
+  }  
+  
+  if (max_value > 4.0f)
+  {
+    ret = BIQUAD_CALCULATOR_ERROR;
+  }
+  else if(max_value > 2.0f)
+  {
+    ret = BIQUAD_RANGE_FOUR;
+  }
+  else if(max_value > 1.0f)
+  {
+    ret = BIQUAD_RANGE_TWO;
+  }
+  else
+  {
+    ret = BIQUAD_RANGE_ONE;
+  }
+  
+  mult = powf(2 , 23);
+  
+  for (i = 0; i < K_NUM ; i++)
+  {        
+    pEq->Coefficients[i]= (int32_t)((float)CoeffSTA350BW[i] * (float)mult);
+  } 
+  
+  return ret;  
+}
+
+static double Bench_Now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+* @brief  Runs one filter through both versions and records the difference.
+* @param  f: filter parameters
+* @retval None
+*/
+static void Bench_Filter(BIQUAD_Filter_t *f)
+{
+  BIQUAD_Filter_t ref = *f;
+  BIQUAD_Filter_t cur = *f;
+  Bench_Result_t *res = &Result[f->Type];
+  int32_t refRange = Ref_ComputeFilter(&ref);
+  int32_t curRange = BQ_CALC_ComputeFilter(&cur);
+  double t0;
+  uint32_t i;
+
+  /* Filters out of the device range are rejected by both, values ignored */
+  if(refRange == BIQUAD_CALCULATOR_ERROR && curRange == BIQUAD_CALCULATOR_ERROR)
+  {
+    return;
+  }
+  res->Filters++;
+  if(refRange != curRange)
+  {
+    res->RangeChanges++;
+  }
+  for(i = 0; i < K_NUM; i++)
+  {
+    int32_t d = (int32_t)cur.Coefficients[i] - (int32_t)ref.Coefficients[i];
+    if(d < 0)
+    {
+      d = -d;
+    }
+    if(d > res->MaxError)
+    {
+      res->MaxError = d;
+    }
+  }
+
+  t0 = Bench_Now();
+  for(i = 0; i < BENCH_TIMING_LOOPS; i++)
+  {
+    Ref_ComputeFilter(&ref);
+    Sink += ref.Coefficients[0];
+  }
+  res->RefNs += Bench_Now() - t0;
+  t0 = Bench_Now();
+  for(i = 0; i < BENCH_TIMING_LOOPS; i++)
+  {
+    BQ_CALC_ComputeFilter(&cur);
+    Sink += cur.Coefficients[0];
+  }
+  res->NewNs += Bench_Now() - t0;
+}
+
+/**
+* @brief  Checks BQ_CALC_ComputeFilters on a two channel bank against one 
+*         BQ_CALC_ComputeFilter per band and compares their timings.
+* @retval 0 if the results match, 1 otherwise
+*/
+static int Bench_Bank(void)
+{
+  static const BIQUAD_Filter_t Band[BENCH_BANK_BANDS / 2] =
+  {
+    { BIQUAD_CALCULATOR_SO_HPF,     48000, 40,    0.71f, 0.0f, 0.0f,  { 0 } },
+    { BIQUAD_CALCULATOR_LOW_SHELF,  48000, 120,   0.0f,  1.0f, 4.0f,  { 0 } },
+    { BIQUAD_CALCULATOR_PEAK,       48000, 2500,  1.4f,  0.0f, -3.0f, { 0 } },
+    { BIQUAD_CALCULATOR_HIGH_SHELF, 48000, 9000,  0.0f,  1.0f, 4.0f,  { 0 } },
+  };
+  BIQUAD_Filter_t bank[BENCH_BANK_BANDS];
+  BIQUAD_Filter_t single;
+  uint32_t coeffs[BENCH_BANK_BANDS * K_NUM];
+  double t0, batchNs, singleNs;
+  uint32_t b, i, loop;
+  int fail = 0;
+
+  /* Channel 1 and 2 of each band next to each other */
+  for(b = 0; b < BENCH_BANK_BANDS; b++)
+  {
+    bank[b] = Band[b / 2];
+  }
+  if(BQ_CALC_ComputeFilters(bank, BENCH_BANK_BANDS, coeffs) != BIQUAD_RANGE_ONE)
+  {
+    fail = 1;
+  }
+  for(b = 0; b < BENCH_BANK_BANDS; b++)
+  {
+    single = Band[b / 2];
+    BQ_CALC_ComputeFilter(&single);
+    for(i = 0; i < K_NUM; i++)
+    {
+      if(coeffs[b * K_NUM + i] != (single.Coefficients[i] & 0xFFFFFF) ||
+         bank[b].Coefficients[i] != single.Coefficients[i])
+      {
+        fail = 1;
+      }
+    }
+  }
+
+  t0 = Bench_Now();
+  for(loop = 0; loop < BENCH_TIMING_LOOPS; loop++)
+  {
+    BQ_CALC_ComputeFilters(bank, BENCH_BANK_BANDS, coeffs);
+    Sink += coeffs[0];
+  }
+  batchNs = (Bench_Now() - t0) / BENCH_TIMING_LOOPS;
+  t0 = Bench_Now();
+  for(loop = 0; loop < BENCH_TIMING_LOOPS; loop++)
+  {
+    for(b = 0; b < BENCH_BANK_BANDS; b++)
+    {
+      BQ_CALC_ComputeFilter(&bank[b]);
+      Sink += bank[b].Coefficients[0];
+    }
+  }
+  singleNs = (Bench_Now() - t0) / BENCH_TIMING_LOOPS;
+
+  printf("%u band bank: %.1f ns with BQ_CALC_ComputeFilters, %.1f ns band by band%s\n",
+         (unsigned)BENCH_BANK_BANDS, batchNs, singleNs, fail ? ", MISMATCH" : "");
+  return fail;
+}
+
+static int32_t Range_Coeff(uint32_t c)
+{
+  return (int32_t)(c << 8) >> 8;
+}
+
+/**
+* @brief  Double precision radius of the largest pole of a quantized biquad.
+* @param  c: K_NUM 24 bit coefficients in the device order
+* @param  range: coefficient range
+* @retval pole radius
+*/
+static double Range_PoleRadius(const uint32_t *c, int32_t range)
+{
+  double a1 = -2.0 * Range_Coeff(c[2]) * range / 8388608.0;
+  double a2 = -(double)Range_Coeff(c[3]) * range / 8388608.0;
+  double disc = a1 * a1 - 4.0 * a2;
+
+  if(disc < 0.0)
+  {
+    return sqrt(a2);
+  }
+  return (fabs(a1) + sqrt(disc)) / 2.0;
+}
+
+/**
+* @brief  Sweeps BQ_CALC_ComputeFilterRange over low Fc, high Q and high gain 
+*         designs. Checks that the range is the smallest that holds the 
+*         rounded filter, that the error against the former computation 
+*         stays within BQ_CALC_MAX_ERROR_LSB steps of that range, that the integer 
+*         BQ_CALC_CheckStability agrees with the pole radius in every range, 
+*         and that only filters with poles on or out of the unit circle are 
+*         rejected. The former truncation with BQ_CALC_ShiftCoefficients is 
+*         measured on the same designs.
+* @retval 0 if every check passes, 1 otherwise
+*/
+static int Bench_Range(void)
+{
+  BIQUAD_Filter_t f, cur, ref, old;
+  uint32_t counts[5] = { 0 };
+  uint32_t designs = 0, outOfRange = 0, unstable = 0, oldUnstable = 0, oldWrapped = 0, errors = 0;
+  int32_t maxError[5] = { 0 };
+  int32_t maxOldError = 0;
+  uint32_t type, fs, step, q, g, s, i;
+  int32_t r, refRange, oldRange;
+
+  memset(&f, 0, sizeof(f));
+  for(type = 0; type < BENCH_TYPES; type++)
+  {
+    f.Type = type;
+    for(fs = 0; fs < sizeof(BenchFs) / sizeof(BenchFs[0]); fs++)
+    {
+      f.Fs = BenchFs[fs];
+      for(step = 0; step < RANGE_FC_STEPS; step++)
+      {
+        /* Log spaced from 5 Hz to just below Fs / 2 */
+        f.Fc = (uint32_t)(5.0 * pow((f.Fs / 2.0) / 5.0, step / (double)RANGE_FC_STEPS));
+        for(q = 0; q < sizeof(RangeQ) / sizeof(RangeQ[0]); q++)
+        {
+          f.Q = RangeQ[q];
+          for(g = 0; g < sizeof(RangeGain) / sizeof(RangeGain[0]); g++)
+          {
+            f.Gain = RangeGain[g];
+            for(s = 0; s < sizeof(BenchSlope) / sizeof(BenchSlope[0]); s++)
+            {
+              int32_t maxCoeff = 0;
+
+              f.Slope = BenchSlope[s];
+              cur = f;
+              ref = f;
+              old = f;
+              memset(cur.Coefficients, 0xFF, sizeof(cur.Coefficients));
+              refRange = Ref_ComputeFilter(&ref);
+              r = BQ_CALC_ComputeFilterRange(&cur, BIQUAD_RANGE_ONE);
+              designs++;
+
+              /* Coefficients are written before the stability check */
+              if(cur.Coefficients[0] != 0xFFFFFFFF)
+              {
+                for(i = BIQUAD_RANGE_ONE; i <= BIQUAD_RANGE_FOUR; i <<= 1)
+                {
+                  if((BQ_CALC_CheckStability(cur.Coefficients, i) == BIQUAD_CALCULATOR_OK) !=
+                     (Range_PoleRadius(cur.Coefficients, i) < 1.0))
+                  {
+                    errors++;
+                  }
+                }
+              }
+              if(r == BIQUAD_CALCULATOR_ERROR)
+              {
+                if(cur.Coefficients[0] == 0xFFFFFFFF)
+                {
+                  outOfRange++;
+                }
+                else
+                {
+                  unstable++;
+                }
+                /* Either out of [-4 4) or poles on the unit circle */
+                if(cur.Coefficients[0] == 0xFFFFFFFF ? refRange != BIQUAD_CALCULATOR_ERROR :
+                   BQ_CALC_CheckStability(cur.Coefficients, BIQUAD_RANGE_ONE) == BIQUAD_CALCULATOR_OK &&
+                   BQ_CALC_CheckStability(cur.Coefficients, BIQUAD_RANGE_TWO) == BIQUAD_CALCULATOR_OK &&
+                   BQ_CALC_CheckStability(cur.Coefficients, BIQUAD_RANGE_FOUR) == BIQUAD_CALCULATOR_OK)
+                {
+                  errors++;
+                }
+                continue;
+              }
+              counts[r]++;
+              if(Range_PoleRadius(cur.Coefficients, r) >= 1.0)
+              {
+                errors++;
+              }
+              for(i = 0; i < K_NUM; i++)
+              {
+                int32_t c = Range_Coeff(cur.Coefficients[i]);
+                int32_t d = c * r - (int32_t)ref.Coefficients[i];
+
+                d = (d < 0) ? -d : d;
+                maxError[r] = (d > maxError[r]) ? d : maxError[r];
+                c = (c < 0) ? -c : c;
+                maxCoeff = (c > maxCoeff) ? c : maxCoeff;
+              }
+              /* A narrower range would have held every coefficient */
+              if(r > BIQUAD_RANGE_ONE && maxCoeff < 0x3FFFFF)
+              {
+                errors++;
+              }
+
+              oldRange = BQ_CALC_ComputeFilter(&old);
+              if(oldRange != BIQUAD_CALCULATOR_ERROR)
+              {
+                int32_t wrapped = 0;
+
+                BQ_CALC_ShiftCoefficients(&old, (uint8_t)oldRange);
+                if(BQ_CALC_CheckStability(old.Coefficients, oldRange) != BIQUAD_CALCULATOR_OK)
+                {
+                  oldUnstable++;
+                }
+                for(i = 0; i < K_NUM; i++)
+                {
+                  int32_t d = Range_Coeff(old.Coefficients[i]) * oldRange - (int32_t)ref.Coefficients[i];
+
+                  d = (d < 0) ? -d : d;
+                  /* A coefficient of exactly 1, 2 or 4 wraps to the opposite sign */
+                  if(d >= 0x800000)
+                  {
+                    wrapped = 1;
+                  }
+                  else
+                  {
+                    maxOldError = (d > maxOldError) ? d : maxOldError;
+                  }
+                }
+                oldWrapped += wrapped;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf("Range sweep: %u designs, range 1/2/4 %u/%u/%u, %u out of range, %u unstable\n",
+         (unsigned)designs, (unsigned)counts[BIQUAD_RANGE_ONE], (unsigned)counts[BIQUAD_RANGE_TWO],
+         (unsigned)counts[BIQUAD_RANGE_FOUR], (unsigned)outOfRange, (unsigned)unstable);
+  printf("Range sweep: max error range 1/2/4 %d/%d/%d LSB, %u check failures\n",
+         (int)maxError[BIQUAD_RANGE_ONE], (int)maxError[BIQUAD_RANGE_TWO],
+         (int)maxError[BIQUAD_RANGE_FOUR], (unsigned)errors);
+  printf("Range sweep: former truncation %d LSB, %u wrapped, %u unstable\n",
+         (int)maxOldError, (unsigned)oldWrapped, (unsigned)oldUnstable);
+  /* The float design error grows with the coefficients, so the limit is 
+     BQ_CALC_MAX_ERROR_LSB steps of each range */
+  for(i = BIQUAD_RANGE_ONE; i <= BIQUAD_RANGE_FOUR; i <<= 1)
+  {
+    if(maxError[i] > (int32_t)i * BQ_CALC_MAX_ERROR_LSB)
+    {
+      errors++;
+    }
+  }
+  return (errors != 0) ? 1 : 0;
+}
+
+int main(void)
+{
+  BIQUAD_Filter_t f;
+  uint32_t type, fs, step, q, g, s;
+  int fail = 0;
+
+  memset(&f, 0, sizeof(f));
+  for(type = 0; type < BENCH_TYPES; type++)
+  {
+    f.Type = type;
+    for(fs = 0; fs < sizeof(BenchFs) / sizeof(BenchFs[0]); fs++)
+    {
+      f.Fs = BenchFs[fs];
+      for(step = 0; step < BENCH_FC_STEPS; step++)
+      {
+        /* Log spaced from 20 Hz to just below Fs / 2 */
+        f.Fc = (uint32_t)(20.0 * pow((f.Fs / 2.0) / 20.0, step / (double)BENCH_FC_STEPS));
+        for(q = 0; q < sizeof(BenchQ) / sizeof(BenchQ[0]); q++)
+        {
+          f.Q = BenchQ[q];
+          for(g = 0; g < sizeof(BenchGain) / sizeof(BenchGain[0]); g++)
+          {
+            f.Gain = BenchGain[g];
+            for(s = 0; s < sizeof(BenchSlope) / sizeof(BenchSlope[0]); s++)
+            {
+              f.Slope = BenchSlope[s];
+              Bench_Filter(&f);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  printf("%-12s %8s %8s %8s %10s %10s\n", "type", "filters", "ranges", "max LSB", "ref ns", "new ns");
+  for(type = 0; type < BENCH_TYPES; type++)
+  {
+    Bench_Result_t *res = &Result[type];
+    double calls = (double)res->Filters * BENCH_TIMING_LOOPS;
+
+    printf("%-12s %8u %8u %8d %10.1f %10.1f\n", TypeName[type], (unsigned)res->Filters,
+           (unsigned)res->RangeChanges, (int)res->MaxError,
+           calls ? res->RefNs / calls : 0.0, calls ? res->NewNs / calls : 0.0);
+    if(res->MaxError > BQ_CALC_MAX_ERROR_LSB)
+    {
+      fail = 1;
+    }
+  }
+  fail |= Bench_Bank();
+  fail |= Bench_Range();
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
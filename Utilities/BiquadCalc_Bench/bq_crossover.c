@@ -0,0 +1,223 @@
+/**
+******************************************************************************
+* @file    bq_crossover.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host check of the Linkwitz-Riley crossovers of BQ_CALC_ComputeCrossover.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadCalc_Bench/bq_crossover.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCrossover.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadResponse.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_scale_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_add_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_*_f32.c
+*                    -lm -o bq_crossover
+*
+*          LR2 and LR4 crossovers are designed over the sampling frequencies of
+*          the demo and Fc from 40 Hz to 8 KHz. For each one the sum of the two
+*          sides is evaluated with BQ_CALC_CrossoverSum and, in double precision,
+*          straight from the quantized coefficients: it must stay within
+*          XO_MAX_SUM_DB of 0 dB from 20 Hz to 20 KHz, and each side must be
+*          within XO_MAX_SUM_DB of -6 dB at Fc and XO_MIN_REJECT_DB down two
+*          octaves away in its stop band. Below rate / XO_LOW_FC_RATIO the
+*          low pass numerator is only a few LSB of the 1.23 format: those
+*          designs are reported apart, against XO_MAX_SUM_LOW_DB.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include "BiquadCrossover.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define XO_POINTS                 256
+#define XO_FC_STEPS               24
+#define XO_MAX_SUM_DB             0.1           /* Flatness of the sum and -6.02 dB at Fc */
+#define XO_MAX_SUM_LOW_DB         0.6           /* The same below XO_LOW_FC_RATIO */
+#define XO_LOW_FC_RATIO           1000.0        /* Fc under rate / 1000: b0 is only a few LSB */
+#define XO_MIN_REJECT_DB          20.0          /* LR2 stop band, two octaves from Fc; LR4 gets twice that */
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Designs;
+  double MaxSum;
+  double MaxRef;
+  double MaxFc;
+  double MinReject;
+}
+Xo_Result_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t XoFs[] = { 32000, 44100, 48000, 96000 };
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Double precision response of one side of a crossover.
+* @param  pSet: biquads * K_NUM 24 bit coefficients
+* @param  pRanges: range of each biquad
+* @param  biquads: number of biquads
+* @param  rate: processing rate in Hz
+* @param  f: frequency in Hz
+* @retval complex response
+*/
+static double complex Xo_Side(const uint32_t *pSet, const uint8_t *pRanges, uint32_t biquads, 
+                              double rate, double f)
+{
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / rate);
+  double complex h = 1.0;
+  uint32_t b;
+
+  for(b = 0; b < biquads; b++)
+  {
+    const uint32_t *c = &pSet[b * K_NUM];
+    double lsb = pRanges[b] / 8388608.0;
+    double v[K_NUM];
+    uint32_t i;
+
+    for(i = 0; i < K_NUM; i++)
+    {
+      v[i] = ((int32_t)(c[i] << 8) >> 8) * lsb;
+    }
+    h *= (2.0 * v[4] + 2.0 * v[0] * z1 + v[1] * z1 * z1) / (1.0 - 2.0 * v[2] * z1 - v[3] * z1 * z1);
+  }
+  return h;
+}
+
+int main(void)
+{
+  BQ_CALC_Crossover_t xo;
+  float freq[XO_POINTS];
+  float sum[XO_POINTS];
+  uint32_t type, fs, step, k;
+  int fail = 0;
+
+  for(k = 0; k < XO_POINTS; k++)
+  {
+    freq[k] = (float)(20.0 * pow(1000.0, k / (double)(XO_POINTS - 1)));
+  }
+
+  printf("%-4s %-6s %8s %10s %10s %10s %10s\n", "type", "Fc", "designs", "sum dB", "ref dB", "Fc dB", "reject dB");
+  for(type = BQ_CALC_CROSSOVER_LR2; type <= BQ_CALC_CROSSOVER_LR4; type += 2)
+  {
+    Xo_Result_t res[2];
+    uint32_t low;
+
+    memset(res, 0, sizeof(res));
+    res[0].MinReject = res[1].MinReject = 1e9;
+    for(fs = 0; fs < sizeof(XoFs) / sizeof(XoFs[0]); fs++)
+    {
+      double rate = (XoFs[fs] != 96000) ? 2.0 * XoFs[fs] : XoFs[fs];
+
+      for(step = 0; step < XO_FC_STEPS; step++)
+      {
+        Xo_Result_t *r;
+        double fc;
+        double side[4];
+        uint32_t i;
+
+        memset(&xo, 0, sizeof(xo));
+        xo.Type = type;
+        xo.Fs = XoFs[fs];
+        /* Log spaced from 40 Hz to 8 KHz */
+        xo.Fc = (uint32_t)(40.0 * pow(200.0, step / (double)(XO_FC_STEPS - 1)));
+        fc = xo.Fc;
+        r = &res[(fc * XO_LOW_FC_RATIO < rate) ? 1 : 0];
+        if(BQ_CALC_ComputeCrossover(&xo) != BIQUAD_CALCULATOR_OK ||
+           xo.Biquads != type / 2 ||
+           BQ_CALC_CrossoverSum(&xo, freq, XO_POINTS, sum) != BIQUAD_CALCULATOR_OK)
+        {
+          printf("LR%u Fs %u Fc %u: design failed\n", (unsigned)type, (unsigned)xo.Fs, (unsigned)xo.Fc);
+          fail = 1;
+          continue;
+        }
+        r->Designs++;
+
+        for(k = 0; k < XO_POINTS; k++)
+        {
+          double ref = 20.0 * log10(cabs(Xo_Side(xo.Low, xo.Ranges, xo.Biquads, rate, freq[k]) +
+                                         Xo_Side(xo.High, xo.Ranges, xo.Biquads, rate, freq[k])));
+
+          r->MaxSum = fmax(r->MaxSum, fabs(sum[k]));
+          r->MaxRef = fmax(r->MaxRef, fabs(ref));
+        }
+
+        /* -6 dB at Fc, stop band two octaves away */
+        side[0] = 20.0 * log10(cabs(Xo_Side(xo.Low, xo.Ranges, xo.Biquads, rate, fc)));
+        side[1] = 20.0 * log10(cabs(Xo_Side(xo.High, xo.Ranges, xo.Biquads, rate, fc)));
+        side[2] = -20.0 * log10(cabs(Xo_Side(xo.Low, xo.Ranges, xo.Biquads, rate, fmin(4.0 * fc, rate / 2.0))));
+        side[3] = -20.0 * log10(cabs(Xo_Side(xo.High, xo.Ranges, xo.Biquads, rate, fc / 4.0)));
+        for(i = 0; i < 2; i++)
+        {
+          r->MaxFc = fmax(r->MaxFc, fabs(side[i] + 20.0 * log10(2.0)));
+        }
+        for(i = 2; i < 4; i++)
+        {
+          r->MinReject = fmin(r->MinReject, side[i] * 2.0 / type);
+        }
+      }
+    }
+
+    for(low = 0; low < 2; low++)
+    {
+      Xo_Result_t *r = &res[low];
+      double limit = low ? XO_MAX_SUM_LOW_DB : XO_MAX_SUM_DB;
+
+      printf("LR%-2u %-6s %8u %10.4f %10.4f %10.4f %10.2f\n", (unsigned)type, low ? "low" : "normal",
+             (unsigned)r->Designs, r->MaxSum, r->MaxRef, r->MaxFc, r->MinReject * type / 2.0);
+      if(r->MaxSum > limit || r->MaxRef > limit || r->MaxFc > limit ||
+         r->MinReject < XO_MIN_REJECT_DB)
+      {
+        fail = 1;
+      }
+    }
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
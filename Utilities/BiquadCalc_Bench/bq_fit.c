@@ -0,0 +1,256 @@
+/**
+******************************************************************************
+* @file    bq_fit.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host check of the room correction fit of BQ_CALC_Fit.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadCalc_Bench/bq_fit.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadFit.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadResponse.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_scale_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_add_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_*_f32.c
+*                    -lm -o bq_fit
+*          Usage:  bq_fit
+*
+*          Synthetic rooms, a few random modes and dips over a low shelf with 
+*          some measurement noise, are corrected with BQ_CALC_Fit. The error 
+*          left is computed again in double precision from the returned 
+*          coefficients on the measurement points, and the bench fails if a 
+*          fit makes a room worse, does not lower the error on average or 
+*          goes over the evaluation budget, which bounds the run time on 
+*          target.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+#include "BiquadFit.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define FIT_ROOMS                 200
+#define FIT_POINTS                240           /* Measurement points, 20 Hz to 20 KHz */
+#define FIT_MODES                 4             /* Peaks and dips of a room */
+#define FIT_NOISE_DB              0.3           /* Peak measurement noise */
+#define FIT_MIN_IMPROVEMENT       0.4           /* Error removed on average, fraction of the initial one */
+#define FIT_MAX_ERROR_DIFF_DB     0.3           /* Fit error against the double precision one */
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t FitFs[] = { 32000, 44100, 48000, 96000 };
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Uniform random number.
+* @param  lo: lowest value
+* @param  hi: highest value
+* @retval random number in [lo, hi)
+*/
+static double Fit_Random(double lo, double hi)
+{
+  return lo + (hi - lo) * (rand() / ((double)RAND_MAX + 1.0));
+}
+
+/**
+* @brief  Double precision response in dB of the fitted filters, from the 
+*         coefficients of BQ_CALC_ComputeFilter.
+* @param  pEq: filters
+* @param  biquads: number of filters
+* @param  f: frequency in Hz
+* @retval magnitude in dB
+*/
+static double Fit_Response(const BIQUAD_Filter_t *pEq, uint32_t biquads, double f)
+{
+  double rate = (pEq[0].Fs != 96000) ? 2.0 * pEq[0].Fs : pEq[0].Fs;
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / rate);
+  double complex h = 1.0;
+  uint32_t b;
+
+  for(b = 0; b < biquads; b++)
+  {
+    double v[K_NUM];
+    uint32_t i;
+
+    for(i = 0; i < K_NUM; i++)
+    {
+      v[i] = (int32_t)pEq[b].Coefficients[i] / 8388608.0;
+    }
+    h *= (2.0 * v[4] + 2.0 * v[0] * z1 + v[1] * z1 * z1) / (1.0 - 2.0 * v[2] * z1 - v[3] * z1 * z1);
+  }
+  return 20.0 * log10(cabs(h));
+}
+
+int main(void)
+{
+  BQ_CALC_Fit_t fit;
+  BIQUAD_Filter_t eq[BQ_CALC_FIT_MAX_BIQUADS];
+  float freq[FIT_POINTS];
+  float mag[FIT_POINTS];
+  double sumInitial[BQ_CALC_FIT_MAX_BIQUADS], sumError[BQ_CALC_FIT_MAX_BIQUADS];
+  double initial = 0.0, error = 0.0, maxDiff = 0.0, seconds = 0.0;
+  uint32_t maxEvaluations = 0, worse = 0, failed = 0;
+  uint32_t room, k;
+  int fail = 0;
+
+  srand(1);
+  memset(sumInitial, 0, sizeof(sumInitial));
+  memset(sumError, 0, sizeof(sumError));
+  for(k = 0; k < FIT_POINTS; k++)
+  {
+    freq[k] = (float)(20.0 * pow(1000.0, k / (double)(FIT_POINTS - 1)));
+  }
+
+  for(room = 0; room < FIT_ROOMS; room++)
+  {
+    double shelfFc = Fit_Random(60.0, 300.0), shelfDb = Fit_Random(-6.0, 6.0);
+    double modeFc[FIT_MODES], modeDb[FIT_MODES], modeOct[FIT_MODES];
+    double e = 0.0;
+    uint32_t m, n = 0;
+    clock_t start;
+    int32_t ret;
+
+    for(m = 0; m < FIT_MODES; m++)
+    {
+      modeFc[m] = 30.0 * pow(2.0, Fit_Random(0.0, 6.0));
+      modeDb[m] = Fit_Random(-12.0, 10.0);
+      modeOct[m] = Fit_Random(0.1, 0.6);
+    }
+    for(k = 0; k < FIT_POINTS; k++)
+    {
+      double lf = log2(freq[k]);
+      double y = shelfDb / (1.0 + pow(freq[k] / shelfFc, 2.0)) + Fit_Random(-FIT_NOISE_DB, FIT_NOISE_DB);
+
+      for(m = 0; m < FIT_MODES; m++)
+      {
+        double x = (lf - log2(modeFc[m])) / modeOct[m];
+
+        y += modeDb[m] * exp(-0.5 * x * x);
+      }
+      mag[k] = (float)y;
+    }
+
+    memset(&fit, 0, sizeof(fit));
+    fit.Fs = FitFs[room % (sizeof(FitFs) / sizeof(FitFs[0]))];
+    fit.pFreq = freq;
+    fit.pMagDb = mag;
+    fit.Count = FIT_POINTS;
+    fit.FreqLow = 25.0f;
+    fit.FreqHigh = (room & 1) ? 500.0f : 4000.0f;
+    fit.MaxBoost = 6.0f;
+    fit.MaxCut = 15.0f;
+    fit.Biquads = 1 + room % BQ_CALC_FIT_MAX_BIQUADS;
+
+    start = clock();
+    ret = BQ_CALC_Fit(&fit, eq);
+    seconds += (double)(clock() - start) / CLOCKS_PER_SEC;
+    if(ret == BIQUAD_CALCULATOR_ERROR)
+    {
+      printf("room %u: fit failed\n", (unsigned)room);
+      failed++;
+      continue;
+    }
+
+    /* Error left on the measurement points of the band, flat target at the mean level */
+    {
+      double mean = 0.0;
+
+      for(k = 0; k < FIT_POINTS; k++)
+      {
+        if(freq[k] >= fit.FreqLow && freq[k] <= fit.FreqHigh)
+        {
+          mean += mag[k];
+          n++;
+        }
+      }
+      mean /= n;
+      for(k = 0; k < FIT_POINTS; k++)
+      {
+        if(freq[k] >= fit.FreqLow && freq[k] <= fit.FreqHigh)
+        {
+          double d = mag[k] + Fit_Response(eq, fit.Biquads, freq[k]) - mean;
+
+          e += d * d;
+        }
+      }
+      e = sqrt(e / n);
+    }
+
+    maxDiff = fmax(maxDiff, fabs(e - fit.ErrorDb));
+    if(fit.Evaluations > maxEvaluations)
+    {
+      maxEvaluations = fit.Evaluations;
+    }
+    if(fit.ErrorDb > fit.InitialErrorDb)
+    {
+      worse++;
+    }
+    sumInitial[fit.Biquads - 1] += fit.InitialErrorDb;
+    sumError[fit.Biquads - 1] += fit.ErrorDb;
+  }
+
+  printf("%u rooms, %u failed, %u made worse\n", (unsigned)FIT_ROOMS, (unsigned)failed, (unsigned)worse);
+  for(k = 0; k < BQ_CALC_FIT_MAX_BIQUADS; k++)
+  {
+    printf("%u biquads: mean RMS error %.3f dB -> %.3f dB\n", (unsigned)(k + 1),
+           sumInitial[k] * BQ_CALC_FIT_MAX_BIQUADS / FIT_ROOMS, sumError[k] * BQ_CALC_FIT_MAX_BIQUADS / FIT_ROOMS);
+    initial += sumInitial[k];
+    error += sumError[k];
+  }
+  printf("largest difference with double %.3f dB\n", maxDiff);
+  printf("evaluations %u (max %u), %.3f ms per fit on host\n", (unsigned)maxEvaluations,
+         (unsigned)BQ_CALC_FIT_MAX_EVALUATIONS, 1000.0 * seconds / FIT_ROOMS);
+  if(failed || worse || error > (1.0 - FIT_MIN_IMPROVEMENT) * initial ||
+     maxDiff > FIT_MAX_ERROR_DIFF_DB || maxEvaluations > BQ_CALC_FIT_MAX_EVALUATIONS)
+  {
+    fail = 1;
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,239 @@
+/**
+******************************************************************************
+* @file    bq_morph.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host check of the preset transitions of BQ_CALC_MorphNext.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadCalc_Bench/bq_morph.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadMorph.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadPresetsGen.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    -lm -o bq_morph
+*          Usage:  bq_morph
+*
+*          Each transition is played on a copy of the device RAM, one biquad 
+*          update at a time as the firmware does once per output block. After 
+*          every update the cascade must be stable, and the change of its 
+*          response, the largest |H_new - H_old| over the audio band, must 
+*          stay a small part of that of switching at once. A peak that moves 
+*          in frequency changes the response locally, so this is not 
+*          1 / MORPH_STEPS. The last update must leave exactly the 
+*          coefficients of the target.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include "BiquadMorph.h"
+#include "BiquadPresets.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define MORPH_BIQUADS             4
+#define MORPH_STEPS               32            /* As the demo */
+#define MORPH_POINTS              200
+#define MORPH_MAX_UPDATE_RATIO    0.4           /* Largest update against switching at once */
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  const char *Name;
+  const BIQUAD_Filter_t *From;
+  const BIQUAD_Filter_t *To;
+}
+Morph_Case_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const BIQUAD_Filter_t PeakLow[MORPH_BIQUADS] =
+{
+  {BIQUAD_CALCULATOR_PEAK, 48000, 80, 2.0f, 0.0f, 9.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 48000, 1000, 1.0f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_SO_LPF, 48000, 16000, 0.71f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_HIGH_SHELF, 48000, 4000, 0.0f, 1.0f, -6.0f, {0}}
+};
+static const BIQUAD_Filter_t PeakHigh[MORPH_BIQUADS] =
+{
+  {BIQUAD_CALCULATOR_PEAK, 48000, 3000, 6.0f, 0.0f, -12.0f, {0}},
+  {BIQUAD_CALCULATOR_LOW_SHELF, 48000, 200, 0.0f, 0.7f, -4.0f, {0}},
+  {BIQUAD_CALCULATOR_SO_LPF, 48000, 5000, 0.71f, 0.0f, 0.0f, {0}},
+  {BIQUAD_CALCULATOR_PEAK, 48000, 6000, 0.7f, 0.0f, 5.0f, {0}}
+};
+
+static const Morph_Case_t Cases[] =
+{
+  { "HPF_1K -> LOUDNESS", HPF_1K_EQ_PRESET_DESIGN, LOUDNESS_EQ_PRESET_DESIGN },
+  { "LOUDNESS -> HPF_1K", LOUDNESS_EQ_PRESET_DESIGN, HPF_1K_EQ_PRESET_DESIGN },
+  { "peaks and shelves", PeakLow, PeakHigh },
+  { "peaks and shelves back", PeakHigh, PeakLow },
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Double precision response of a cascade in the device format.
+* @param  pSets: MORPH_BIQUADS * K_NUM 24 bit coefficients
+* @param  rate: processing rate in Hz
+* @param  f: frequency in Hz
+* @retval complex response
+*/
+static double complex Morph_Response(const uint32_t *pSets, double rate, double f)
+{
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / rate);
+  double complex h = 1.0;
+  uint32_t b;
+
+  for(b = 0; b < MORPH_BIQUADS; b++)
+  {
+    double v[K_NUM];
+    uint32_t i;
+
+    for(i = 0; i < K_NUM; i++)
+    {
+      v[i] = ((int32_t)(pSets[b * K_NUM + i] << 8) >> 8) / 8388608.0;
+    }
+    h *= (2.0 * v[4] + 2.0 * v[0] * z1 + v[1] * z1 * z1) / (1.0 - 2.0 * v[2] * z1 - v[3] * z1 * z1);
+  }
+  return h;
+}
+
+/**
+* @brief  Coefficients of a set of designs, as BQ_CALC_ComputeFilter.
+* @param  pEq: MORPH_BIQUADS designs
+* @param  pSets: MORPH_BIQUADS * K_NUM 24 bit coefficients
+* @retval None
+*/
+static void Morph_Compute(const BIQUAD_Filter_t *pEq, uint32_t *pSets)
+{
+  uint32_t b, i;
+
+  for(b = 0; b < MORPH_BIQUADS; b++)
+  {
+    BIQUAD_Filter_t f = pEq[b];
+
+    BQ_CALC_ComputeFilter(&f);
+    for(i = 0; i < K_NUM; i++)
+    {
+      pSets[b * K_NUM + i] = f.Coefficients[i] & 0xFFFFFF;
+    }
+  }
+}
+
+int main(void)
+{
+  double freq[MORPH_POINTS];
+  uint32_t c, k;
+  int fail = 0;
+
+  for(k = 0; k < MORPH_POINTS; k++)
+  {
+    freq[k] = 20.0 * pow(1000.0, k / (double)(MORPH_POINTS - 1));
+  }
+
+  printf("%-24s %8s %10s %10s %8s\n", "transition", "updates", "at once", "largest", "ratio");
+  for(c = 0; c < sizeof(Cases) / sizeof(Cases[0]); c++)
+  {
+    const Morph_Case_t *mc = &Cases[c];
+    double rate = (mc->From[0].Fs != 96000) ? 2.0 * mc->From[0].Fs : mc->From[0].Fs;
+    uint32_t device[MORPH_BIQUADS * K_NUM];
+    uint32_t target[MORPH_BIQUADS * K_NUM];
+    double complex h[MORPH_POINTS];
+    double once = 0.0, largest = 0.0;
+    BQ_CALC_Morph_t morph;
+    uint32_t biquad, updates = 0;
+    int32_t ret;
+
+    Morph_Compute(mc->From, device);
+    Morph_Compute(mc->To, target);
+    for(k = 0; k < MORPH_POINTS; k++)
+    {
+      h[k] = Morph_Response(device, rate, freq[k]);
+      once = fmax(once, cabs(Morph_Response(target, rate, freq[k]) - h[k]));
+    }
+
+    if(BQ_CALC_MorphInit(&morph, mc->From, mc->To, MORPH_BIQUADS, MORPH_STEPS) != BIQUAD_CALCULATOR_OK)
+    {
+      printf("%s: init failed\n", mc->Name);
+      fail = 1;
+      continue;
+    }
+    /* Each update is written in place of its biquad, as in the device RAM */
+    for(;;)
+    {
+      uint32_t set[K_NUM];
+
+      ret = BQ_CALC_MorphNext(&morph, &biquad, set);
+      if(ret != BIQUAD_CALCULATOR_OK)
+      {
+        break;
+      }
+      memcpy(&device[biquad * K_NUM], set, sizeof(set));
+      updates++;
+      if(BQ_CALC_CheckStability(set, BIQUAD_RANGE_ONE) != BIQUAD_CALCULATOR_OK)
+      {
+        printf("%s: unstable update of BQ%u\n", mc->Name, (unsigned)biquad + 1);
+        fail = 1;
+      }
+      for(k = 0; k < MORPH_POINTS; k++)
+      {
+        double complex n = Morph_Response(device, rate, freq[k]);
+
+        largest = fmax(largest, cabs(n - h[k]));
+        h[k] = n;
+      }
+    }
+
+    printf("%-24s %8u %10.4f %10.4f %8.2f\n", mc->Name, (unsigned)updates, once, largest,
+           largest / once);
+    if(ret != BQ_CALC_MORPH_DONE || memcmp(device, target, sizeof(device)) != 0 ||
+       largest > MORPH_MAX_UPDATE_RATIO * once)
+    {
+      fail = 1;
+    }
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,228 @@
+/**
+******************************************************************************
+* @file    bq_response.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host regression of the EQ presets through BQ_CALC_ResponseFixed.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadCalc_Bench/bq_response.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadResponse.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadPresets.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadPresetsGen.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_scale_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_add_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_*_f32.c
+*                    -lm -o bq_response
+*          Usage:  bq_response [-s fs] [-v]
+*
+*          Every preset of BiquadPresets.c and BiquadPresetsGen.c is evaluated
+*          at RESP_POINTS log spaced frequencies from 20 Hz to 20 KHz and checked
+*          against a double precision evaluation of the same coefficients. The
+*          bench prints the range of each curve, the largest difference and the
+*          time per curve, and with -v the curves themselves.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+#include "BiquadResponse.h"
+#include "BiquadPresets.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define RESP_POINTS               256
+#define RESP_MAX_ERROR_DB         0.01          /* Against double precision */
+#define RESP_LOOPS                100
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  const char *Name;
+  const uint32_t *Coefficients;
+  uint32_t Biquads;
+}
+Resp_Preset_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const Resp_Preset_t Presets[] =
+{
+  { "FLAT",        FLAT_EQ_PRESET,        5 },
+  { "ROCK",        ROCK_EQ_PRESET,        5 },
+  { "SOFT_ROCK",   SOFT_ROCK_EQ_PRESET,   5 },
+  { "JAZZ",        JAZZ_EQ_PRESET,        5 },
+  { "CLASSICAL",   CLASSICAL_EQ_PRESET,   5 },
+  { "DANCE",       DANCE_EQ_PRESET,       5 },
+  { "POP",         POP_EQ_PRESET,         5 },
+  { "SOFT",        SOFT_EQ_PRESET,        5 },
+  { "HARD",        HARD_EQ_PRESET,        5 },
+  { "PARTY",       PARTY_EQ_PRESET,       5 },
+  { "VOCAL",       VOCAL_EQ_PRESET,       5 },
+  { "HIPHOP",      HIPHOP_EQ_PRESET,      5 },
+  { "DIALOG",      DIALOG_EQ_PRESET,      5 },
+  { "BASS_BOOST1", BASS_BOOST1_EQ_PRESET, 5 },
+  { "BASS_BOOST2", BASS_BOOST2_EQ_PRESET, 5 },
+  { "BASS_BOOST3", BASS_BOOST3_EQ_PRESET, 5 },
+  { "HPF_1K",      HPF_1K_EQ_PRESET,      4 },
+  { "LOUDNESS",    LOUDNESS_EQ_PRESET,    4 },
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+static double Resp_Now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double Resp_Coeff(uint32_t c)
+{
+  return (double)((int32_t)(c << 8) >> 8) / 8388608.0;
+}
+
+/**
+* @brief  Double precision magnitude of a preset, straight from the transfer 
+*         function.
+* @param  preset: preset to evaluate
+* @param  rate: processing rate in Hz
+* @param  f: frequency in Hz
+* @retval magnitude in dB
+*/
+static double Resp_Reference(const Resp_Preset_t *preset, double rate, double f)
+{
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / rate);
+  double complex h = 1.0;
+  uint32_t b;
+
+  for(b = 0; b < preset->Biquads; b++)
+  {
+    const uint32_t *c = &preset->Coefficients[b * K_NUM];
+    double complex num = 2.0 * Resp_Coeff(c[4]) + 2.0 * Resp_Coeff(c[0]) * z1 + Resp_Coeff(c[1]) * z1 * z1;
+    double complex den = 1.0 - 2.0 * Resp_Coeff(c[2]) * z1 - Resp_Coeff(c[3]) * z1 * z1;
+    h *= num / den;
+  }
+  return 20.0 * log10(cabs(h));
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t fs = 48000;
+  int verbose = 0;
+  int arg = 1;
+  float freq[RESP_POINTS];
+  float mag[RESP_POINTS];
+  float phase[RESP_POINTS];
+  double rate;
+  uint32_t p, k, loop;
+  int fail = 0;
+
+  while(arg < argc)
+  {
+    if(strcmp(argv[arg], "-v") == 0)
+    {
+      verbose = 1;
+      arg++;
+    }
+    else if(arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+    {
+      fs = (uint32_t)atoi(argv[arg + 1]);
+      arg += 2;
+    }
+    else
+    {
+      fprintf(stderr, "usage: bq_response [-s fs] [-v]\n");
+      return 1;
+    }
+  }
+  rate = (fs != 96000) ? 2.0 * fs : fs;
+
+  for(k = 0; k < RESP_POINTS; k++)
+  {
+    freq[k] = (float)(20.0 * pow(1000.0, k / (double)(RESP_POINTS - 1)));
+  }
+
+  printf("Fs %u Hz, %u points from 20 Hz to 20 KHz\n", (unsigned)fs, (unsigned)RESP_POINTS);
+  printf("%-12s %8s %8s %10s %8s\n", "preset", "min dB", "max dB", "error dB", "us");
+  for(p = 0; p < sizeof(Presets) / sizeof(Presets[0]); p++)
+  {
+    const Resp_Preset_t *preset = &Presets[p];
+    double lo = 1e9, hi = -1e9, err = 0.0;
+    double t0;
+
+    if(BQ_CALC_ResponseFixed(preset->Coefficients, preset->Biquads, fs, freq, RESP_POINTS, mag, phase) != BIQUAD_CALCULATOR_OK)
+    {
+      fail = 1;
+      continue;
+    }
+    t0 = Resp_Now();
+    for(loop = 0; loop < RESP_LOOPS; loop++)
+    {
+      BQ_CALC_ResponseFixed(preset->Coefficients, preset->Biquads, fs, freq, RESP_POINTS, mag, phase);
+    }
+    t0 = (Resp_Now() - t0) / RESP_LOOPS;
+
+    for(k = 0; k < RESP_POINTS; k++)
+    {
+      double d = fabs(mag[k] - Resp_Reference(preset, rate, freq[k]));
+      lo = (mag[k] < lo) ? mag[k] : lo;
+      hi = (mag[k] > hi) ? mag[k] : hi;
+      err = (d > err) ? d : err;
+      if(verbose)
+      {
+        printf("  %8.1f Hz %+7.2f dB %+7.1f deg\n", freq[k], mag[k], phase[k] * 180.0 / M_PI);
+      }
+    }
+    printf("%-12s %+8.2f %+8.2f %10.4f %8.1f\n", preset->Name, lo, hi, err, t0 / 1000.0);
+    if(err > RESP_MAX_ERROR_DB)
+    {
+      fail = 1;
+    }
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,315 @@
+/**
+******************************************************************************
+* @file    bq_preset_gen.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host tool: builds the EQ preset tables in STA350BW format from the
+*          declarative band list in BiquadPresets_Spec.h.
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/BiquadPreset_Gen/bq_preset_gen.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    -lm -o bq_preset_gen
+*          Usage:  bq_preset_gen [-s fs] [-n biquads]
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadPresetsGen.c
+*
+*          The coefficients come from the same BQ_CALC_ComputeFilter used on
+*          target, so a generated preset matches what the firmware would compute
+*          at run time. -s retargets every band to another sampling frequency,
+*          -n sets the biquads per preset (default 4, as the STA350BW banks).
+*          A band whose coefficients need more than the [-1 1) range is rejected.
+*          Each table comes with its design parameters, <name>_DESIGN, padded
+*          with 0 dB peaks, so that presets can be morphed (BiquadMorph.c).
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BiquadCalculator.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define GEN_BIQUADS               4
+#define GEN_MAX_BIQUADS           7
+#define GEN_FLOAT_SIZE            24
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  const char *Name;
+  const char *Brief;
+  uint32_t Type;
+  uint32_t Fs;
+  uint32_t Fc;
+  float Q;
+  float Slope;
+  float Gain;
+}
+Gen_Entry_t;
+
+/* Private variables ---------------------------------------------------------*/
+#define PRESET(name, brief)                     { #name, brief, 0, 0, 0, 0.0f, 0.0f, 0.0f },
+#define BAND(type, fs, fc, q, slope, gain)      { NULL, NULL, type, fs, fc, q, slope, gain },
+static const Gen_Entry_t Spec[] =
+{
+#include "BiquadPresets_Spec.h"
+};
+#undef PRESET
+#undef BAND
+
+static const char *TypeName[] =
+{
+  "FO_LPF", "FO_HPF", "SO_LPF", "SO_HPF", "LOW_SHELF",
+  "HIGH_SHELF", "NOTCH", "ALL_PASS", "BAND_PASS", "PEAK"
+};
+
+/* Flat biquad: b0 / 2 = 0.5 */
+static const uint32_t FlatBiquad[K_NUM] = { 0x000000, 0x000000, 0x000000, 0x000000, 0x400000 };
+
+/* Design of the flat biquad: a 0 dB peak, morphs into any peak or shelf */
+static const BIQUAD_Filter_t FlatDesign = { BIQUAD_CALCULATOR_PEAK, 0, 1000, 1.0f, 0.0f, 0.0f, { 0 } };
+
+/* Private functions ---------------------------------------------------------*/
+
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: bq_preset_gen [-s fs] [-n biquads] out.c\n"
+          "  -s  sampling frequency of every band (default as in the spec)\n"
+          "  -n  biquads per preset, 1 to %d (default %d)\n", GEN_MAX_BIQUADS, GEN_BIQUADS);
+}
+
+/**
+* @brief  Formats a float as the shortest C literal that reads back the same.
+* @param  buf: GEN_FLOAT_SIZE characters
+* @param  v: value
+* @retval buf
+*/
+static char *Gen_Float(char *buf, float v)
+{
+  int digits;
+
+  for(digits = 1; digits < 9; digits++)
+  {
+    snprintf(buf, GEN_FLOAT_SIZE, "%.*f", digits, v);
+    if(strtof(buf, NULL) == v)
+    {
+      break;
+    }
+  }
+  strcat(buf, "f");
+  return buf;
+}
+
+/**
+* @brief  Writes the file header of the generated source.
+* @param  f: output file
+* @param  fs: sampling frequency override, 0 if none
+* @retval None
+*/
+static void Gen_WriteHeader(FILE *f, uint32_t fs)
+{
+  fprintf(f,
+          "/**\n"
+          "******************************************************************************\n"
+          "* @file    BiquadPresetsGen.c\n"
+          "* @author  Central Labs\n"
+          "* @version V1.0.0\n"
+          "* @brief   EQ presets generated by Utilities/BiquadPreset_Gen from\n"
+          "*          BiquadPresets_Spec.h%s. Do not edit, change the spec and\n"
+          "*          run the generator again.\n"
+          "******************************************************************************\n",
+          fs ? " with every band retargeted" : "");
+  if(fs)
+  {
+    fprintf(f, "* @note    Sampling frequency forced to %u Hz\n", (unsigned)fs);
+  }
+  fprintf(f,
+          "* @attention\n"
+          "*\n"
+          "* <h2><center>&copy; COPYRIGHT 2013 STMicroelectronics</center></h2>\n"
+          "*\n"
+          "* Licensed under MCD-ST Liberty SW License Agreement V2, (the \"License\");\n"
+          "* You may not use this file except in compliance with the License.\n"
+          "* You may obtain a copy of the License at:\n"
+          "*\n"
+          "*        http://www.st.com/software_license_agreement_liberty_v2\n"
+          "*\n"
+          "* Unless required by applicable law or agreed to in writing, software\n"
+          "* distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+          "* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+          "* See the License for the specific language governing permissions and\n"
+          "* limitations under the License.\n"
+          "*\n"
+          "******************************************************************************\n"
+          "*/\n"
+          "\n"
+          "#include \"BiquadPresets.h\"\n"
+          "\n");
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t fs = 0;
+  uint32_t biquads = GEN_BIQUADS;
+  int arg = 1;
+  size_t e = 0;
+  FILE *out;
+  int presets = 0;
+
+  while(arg + 1 < argc && argv[arg][0] == '-')
+  {
+    if(strcmp(argv[arg], "-s") == 0)
+    {
+      fs = (uint32_t)atoi(argv[arg + 1]);
+    }
+    else if(strcmp(argv[arg], "-n") == 0)
+    {
+      biquads = (uint32_t)atoi(argv[arg + 1]);
+    }
+    else
+    {
+      Usage();
+      return 1;
+    }
+    arg += 2;
+  }
+  if(argc - arg != 1 || biquads == 0 || biquads > GEN_MAX_BIQUADS)
+  {
+    Usage();
+    return 1;
+  }
+
+  out = fopen(argv[arg], "w");
+  if(out == NULL)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+  Gen_WriteHeader(out, fs);
+
+  while(e < sizeof(Spec) / sizeof(Spec[0]))
+  {
+    const Gen_Entry_t *preset = &Spec[e++];
+    uint32_t table[GEN_MAX_BIQUADS][K_NUM];
+    BIQUAD_Filter_t design[GEN_MAX_BIQUADS];
+    uint32_t band = 0;
+    uint32_t i;
+
+    if(preset->Name == NULL)
+    {
+      fprintf(stderr, "BAND before the first PRESET\n");
+      fclose(out);
+      return 1;
+    }
+
+    fprintf(out, "/*!< %s\n", preset->Brief);
+    for(; e < sizeof(Spec) / sizeof(Spec[0]) && Spec[e].Name == NULL; e++)
+    {
+      BIQUAD_Filter_t filter;
+
+      if(band == biquads)
+      {
+        fprintf(stderr, "%s: more than %u bands\n", preset->Name, (unsigned)biquads);
+        fclose(out);
+        return 1;
+      }
+      filter.Type = Spec[e].Type;
+      filter.Fs = fs ? fs : Spec[e].Fs;
+      filter.Fc = Spec[e].Fc;
+      filter.Q = Spec[e].Q;
+      filter.Slope = Spec[e].Slope;
+      filter.Gain = Spec[e].Gain;
+      if(filter.Type > BIQUAD_CALCULATOR_PEAK ||
+         BQ_CALC_ComputeFilter(&filter) != BIQUAD_RANGE_ONE)
+      {
+        fprintf(stderr, "%s: band %u out of the [-1 1) coefficient range\n",
+                preset->Name, (unsigned)band + 1);
+        fclose(out);
+        return 1;
+      }
+      for(i = 0; i < K_NUM; i++)
+      {
+        table[band][i] = filter.Coefficients[i] & 0xFFFFFF;
+      }
+      design[band] = filter;
+      fprintf(out, "    BQ%u %-10s Fs %5u Fc %5u Q %5.2f Slope %4.2f Gain %+5.1f dB\n",
+              (unsigned)band + 1, TypeName[filter.Type], (unsigned)filter.Fs, (unsigned)filter.Fc,
+              filter.Q, filter.Slope, filter.Gain);
+      band++;
+    }
+    fprintf(out, "*/\nuint32_t %s[] = \n{ \n", preset->Name);
+    for(; band < biquads; band++)
+    {
+      memcpy(table[band], FlatBiquad, sizeof(FlatBiquad));
+      design[band] = FlatDesign;
+      design[band].Fs = design[0].Fs;
+    }
+    for(band = 0; band < biquads; band++)
+    {
+      fprintf(out, "  0x%06X, 0x%06X, 0x%06X, 0x%06X, 0x%06X%s\n",
+              (unsigned)table[band][0], (unsigned)table[band][1], (unsigned)table[band][2],
+              (unsigned)table[band][3], (unsigned)table[band][4], (band + 1 < biquads) ? "," : "");
+    }
+    fprintf(out, "};\n\n");
+
+    /* Design parameters of the same biquads, for BQ_CALC_MorphInit */
+    fprintf(out, "const BIQUAD_Filter_t %s_DESIGN[] = \n{ \n", preset->Name);
+    for(band = 0; band < biquads; band++)
+    {
+      char q[GEN_FLOAT_SIZE], slope[GEN_FLOAT_SIZE], gain[GEN_FLOAT_SIZE];
+
+      fprintf(out, "  {BIQUAD_CALCULATOR_%s, %u, %u, %s, %s, %s, {0}}%s\n",
+              TypeName[design[band].Type], (unsigned)design[band].Fs, (unsigned)design[band].Fc,
+              Gen_Float(q, design[band].Q), Gen_Float(slope, design[band].Slope),
+              Gen_Float(gain, design[band].Gain), (band + 1 < biquads) ? "," : "");
+    }
+    fprintf(out, "};\n\n");
+    presets++;
+  }
+
+  fprintf(out, "/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/\n");
+  fclose(out);
+  fprintf(stderr, "%d presets of %u biquads\n", presets, (unsigned)biquads);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
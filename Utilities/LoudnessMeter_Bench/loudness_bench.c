@@ -0,0 +1,314 @@
+/**
+******************************************************************************
+* @file    loudness_bench.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host check of the loudness meter (LoudnessMeter.c).
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/LoudnessMeter
+*                    -IMiddlewares/ST/STM32_Audio/Addons/BiquadCalculator
+*                    Utilities/LoudnessMeter_Bench/loudness_bench.c
+*                    Middlewares/ST/STM32_Audio/Addons/LoudnessMeter/LoudnessMeter.c
+*                    Middlewares/ST/STM32_Audio/Addons/BiquadCalculator/BiquadCalculator.c
+*                    Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_biquad_cascade_df1_q31.c
+*                    Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_biquad_cascade_df1_init_q31.c
+*                    Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_power_q31.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    -lm -o loudness_bench
+*          Usage:  loudness_bench
+*
+*          The K-weighting cascade built from BQ_CALC_ComputeFilter is
+*          compared with the BS.1770 filter at each rate. Cases 1 to 4 of
+*          EBU Tech 3341 (1 KHz sines, with the absolute and relative gates)
+*          are then played 8 ms at a time, as the demo output buffer, and
+*          the readings must be within 0.1 LU. The bench also checks the
+*          channel sum of a four microphone capture and LOUDNESS_Reset, and
+*          times the meter on the demo stream.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <time.h>
+#include "LoudnessMeter.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define LOUD_MS_PER_CALL          8             /* Half of the demo output buffer at 32 KHz */
+#define LOUD_MAX_LEVEL_ERROR      0.1           /* LU, EBU Tech 3341 tolerance */
+#define LOUD_MAX_WEIGHT_ERROR     0.2           /* dB, K-weighting against BS.1770, 20 Hz to 16 KHz: the 1.23
+                                                   coefficients of the 38 Hz high pass cost 0.12 dB at 20 Hz
+                                                   and 48 KHz */
+#define LOUD_POINTS               200
+
+/* Private types -------------------------------------------------------------*/
+/* Sine segment of a test signal, on all the channels */
+typedef struct
+{
+  double Seconds;
+  double Dbfs;
+}
+Loud_Segment_t;
+
+typedef struct
+{
+  const char *Name;
+  uint32_t Channels;
+  const Loud_Segment_t *Segments;
+  uint32_t Count;
+  double Expected;               /* Integrated loudness in LUFS */
+}
+Loud_Case_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t LoudFs[] = { 16000, 32000, 44100, 48000 };
+static LOUDNESS_Handler_t Meter;
+static int16_t Pcm[48 * LOUD_MS_PER_CALL * LOUDNESS_MAX_CHANNELS];
+
+/* EBU Tech 3341 cases 1 to 4, 1 KHz sine */
+static const Loud_Segment_t Case1[] = { { 20.0, -23.0 } };
+static const Loud_Segment_t Case2[] = { { 20.0, -33.0 } };
+static const Loud_Segment_t Case3[] = { { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 } };
+static const Loud_Segment_t Case4[] = { { 10.0, -72.0 }, { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 },
+                                        { 10.0, -72.0 } };
+static const Loud_Case_t Cases[] =
+{
+  { "stereo -23 dBFS", 2, Case1, 1, -23.0 },
+  { "stereo -33 dBFS", 2, Case2, 1, -33.0 },
+  { "relative gate", 2, Case3, 3, -23.0 },
+  { "absolute gate", 2, Case4, 5, -23.0 },
+  { "four mics -23 dBFS", 4, Case1, 1, -23.0 + 3.0103 },
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  BS.1770 K-weighting magnitude at any rate, from the 48 KHz analog
+*         prototypes (same derivation as the reference implementations).
+* @param  fs: sampling frequency in Hz
+* @param  f: frequency in Hz
+* @retval gain in dB
+*/
+static double Loud_Reference(double fs, double f)
+{
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / fs);
+  double K, Vh, Vb, a0, Q;
+  double complex h;
+
+  K = tan(M_PI * 1681.974450955533 / fs);
+  Q = 0.7071752369554196;
+  Vh = pow(10.0, 3.999843853973347 / 20.0);
+  Vb = pow(Vh, 0.4996667741545416);
+  a0 = 1.0 + K / Q + K * K;
+  h = ((Vh + Vb * K / Q + K * K) + 2.0 * (K * K - Vh) * z1 + (Vh - Vb * K / Q + K * K) * z1 * z1) /
+      (a0 + 2.0 * (K * K - 1.0) * z1 + (1.0 - K / Q + K * K) * z1 * z1);
+
+  K = tan(M_PI * 38.13547087602444 / fs);
+  Q = 0.5003270373238773;
+  a0 = 1.0 + K / Q + K * K;
+  h *= a0 * (1.0 - 2.0 * z1 + z1 * z1) / (a0 + 2.0 * (K * K - 1.0) * z1 + (1.0 - K / Q + K * K) * z1 * z1);
+  return 20.0 * log10(cabs(h));
+}
+
+/**
+* @brief  Magnitude of the q31 cascade set up by LOUDNESS_Init, with the pass
+*         band gain it applies to the energy.
+* @param  pMeter: initialized meter
+* @param  fs: sampling frequency in Hz
+* @param  f: frequency in Hz
+* @retval gain in dB
+*/
+static double Loud_Cascade(const LOUDNESS_Handler_t *pMeter, double fs, double f)
+{
+  double complex z1 = cexp(-I * 2.0 * M_PI * f / fs);
+  double complex h = 1.0;
+  double scale = ldexp(1.0, pMeter->Filter[0].postShift - 31);
+  uint32_t s;
+
+  for(s = 0; s < LOUDNESS_STAGES; s++)
+  {
+    const q31_t *c = &pMeter->Coefficients[5 * s];
+
+    h *= (c[0] + c[1] * z1 + c[2] * z1 * z1) * scale / (1.0 - (c[3] * z1 + c[4] * z1 * z1) * scale);
+  }
+  return 20.0 * log10(cabs(h)) + 10.0 * log10(ldexp(pMeter->Scale * pMeter->SubBlockSize, 44));
+}
+
+/**
+* @brief  Plays a test case through the meter, LOUD_MS_PER_CALL at a time.
+* @param  fs: sampling frequency in Hz
+* @param  pCase: test case
+* @param  pReadings: readings at the end
+* @param  pShortTerm: spread of the short-term loudness over the last segment, once 3 s in
+* @retval None
+*/
+static void Loud_Play(uint32_t fs, const Loud_Case_t *pCase, LOUDNESS_Readings_t *pReadings, double *pShortTerm)
+{
+  uint32_t perCall = fs * LOUD_MS_PER_CALL / 1000;
+  double phase = 0.0;
+  double lo = 1000.0, hi = -1000.0;
+  uint32_t seg, c;
+
+  LOUDNESS_Init(&Meter, fs, pCase->Channels);
+  for(seg = 0; seg < pCase->Count; seg++)
+  {
+    double amp = 32768.0 * pow(10.0, pCase->Segments[seg].Dbfs / 20.0);
+    uint32_t calls = (uint32_t)(pCase->Segments[seg].Seconds * 1000.0 / LOUD_MS_PER_CALL);
+    uint32_t call, i;
+
+    for(call = 0; call < calls; call++)
+    {
+      for(i = 0; i < perCall; i++)
+      {
+        int16_t x = (int16_t)lrint(fmin(amp * sin(phase), 32767.0));
+
+        for(c = 0; c < pCase->Channels; c++)
+        {
+          Pcm[i * pCase->Channels + c] = x;
+        }
+        phase = fmod(phase + 2.0 * M_PI * 1000.0 / fs, 2.0 * M_PI);
+      }
+      LOUDNESS_Feed(&Meter, Pcm, perCall);
+      if(seg == pCase->Count - 1 && (call + 1) * LOUD_MS_PER_CALL >= 3000 + LOUDNESS_SUBBLOCK_MS)
+      {
+        LOUDNESS_GetReadings(&Meter, pReadings);
+        lo = fmin(lo, pReadings->ShortTerm);
+        hi = fmax(hi, pReadings->ShortTerm);
+      }
+    }
+  }
+  LOUDNESS_GetReadings(&Meter, pReadings);
+  *pShortTerm = hi - lo;
+}
+
+int main(void)
+{
+  LOUDNESS_Readings_t readings;
+  double worstWeight = 0.0, worstLevel = 0.0, worstSpread = 0.0;
+  uint32_t f, k, errors = 0;
+  clock_t start;
+  double seconds;
+  int fail = 0;
+
+  for(f = 0; f < sizeof(LoudFs) / sizeof(LoudFs[0]); f++)
+  {
+    uint32_t fs = LoudFs[f];
+    double top = fmin(16000.0, 0.45 * fs);
+    double weight = 0.0;
+
+    if(LOUDNESS_Init(&Meter, fs, 2) != LOUDNESS_OK)
+    {
+      printf("%u Hz: init failed\n", (unsigned)fs);
+      errors++;
+      continue;
+    }
+    for(k = 0; k < LOUD_POINTS; k++)
+    {
+      double freq = 20.0 * pow(top / 20.0, k / (double)(LOUD_POINTS - 1));
+
+      weight = fmax(weight, fabs(Loud_Cascade(&Meter, fs, freq) - Loud_Reference(fs, freq)));
+    }
+    printf("%u Hz: K-weighting within %.3f dB of BS.1770, post shift %d\n", (unsigned)fs, weight,
+           (int)Meter.Filter[0].postShift);
+    worstWeight = fmax(worstWeight, weight);
+
+    for(k = 0; k < sizeof(Cases) / sizeof(Cases[0]); k++)
+    {
+      double spread;
+      double err;
+
+      Loud_Play(fs, &Cases[k], &readings, &spread);
+      err = fabs(readings.Integrated - Cases[k].Expected);
+      /* Steady last segment: momentary and short-term read the same level */
+      err = fmax(err, fabs(readings.ShortTerm - Cases[k].Expected) * (Cases[k].Count == 1));
+      err = fmax(err, fabs(readings.Momentary - readings.ShortTerm) * (Cases[k].Count == 1));
+      worstLevel = fmax(worstLevel, err);
+      worstSpread = fmax(worstSpread, spread);
+      if(err > LOUD_MAX_LEVEL_ERROR)
+      {
+        printf("  %s: integrated %.2f short-term %.2f momentary %.2f LUFS, expected %.2f\n", Cases[k].Name,
+               readings.Integrated, readings.ShortTerm, readings.Momentary, Cases[k].Expected);
+        errors++;
+      }
+    }
+  }
+  printf("largest level error %.3f LU, short-term spread on steady tones %.3f LU\n", worstLevel, worstSpread);
+
+  /* Reset restarts the integration at the next sub-block */
+  Loud_Play(48000, &Cases[2], &readings, &seconds);
+  LOUDNESS_Reset(&Meter);
+  memset(Pcm, 0, sizeof(Pcm));
+  for(k = 0; k < 1000 / LOUD_MS_PER_CALL; k++)
+  {
+    LOUDNESS_Feed(&Meter, Pcm, 48 * LOUD_MS_PER_CALL);
+  }
+  LOUDNESS_GetReadings(&Meter, &readings);
+  printf("after reset and 1 s of silence: integrated %.1f LUFS, %u gated blocks\n", readings.Integrated,
+         (unsigned)readings.GatedBlocks);
+  if(readings.Integrated != LOUDNESS_SILENCE || readings.GatedBlocks != 0)
+  {
+    errors++;
+  }
+
+  /* Host time for the demo stream, stereo at 32 KHz */
+  LOUDNESS_Init(&Meter, 32000, 2);
+  for(k = 0; k < sizeof(Pcm) / sizeof(Pcm[0]); k++)
+  {
+    Pcm[k] = (int16_t)(rand() % 2000 - 1000);
+  }
+  start = clock();
+  for(k = 0; k < 60 * 1000 / LOUD_MS_PER_CALL; k++)
+  {
+    LOUDNESS_Feed(&Meter, Pcm, 32 * LOUD_MS_PER_CALL);
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("%.3f ms of host time per second of stereo 32 KHz\n", 1000.0 * seconds / 60.0);
+
+  if(errors || worstWeight > LOUD_MAX_WEIGHT_ERROR || worstSpread > LOUD_MAX_LEVEL_ERROR)
+  {
+    fail = 1;
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
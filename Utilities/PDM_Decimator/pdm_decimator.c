@@ -0,0 +1,284 @@
+/**
+******************************************************************************
+* @file    pdm_decimator.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host tool: offline PDM to PCM decimator for the raw PDM stream
+*          captured from the vendor bulk endpoint (AUDIO_PDM_BULK_ENABLE).
+*
+*          Build:  cc -O2 -o pdm_decimator Utilities/PDM_Decimator/pdm_decimator.c -lm
+*          Usage:  pdm_decimator [-c channels] [-f pdm_khz] [-d decimation]
+*                                [-m] capture.raw out.wav
+*
+*          The capture is the byte-interleaved stream produced by the
+*          X-NUCLEO-CCA02M1 demux: byte k*channels + m holds 8 PDM bits of
+*          microphone m. Each channel goes through a 5th order CIC (sinc^5)
+*          decimator followed by a 10 Hz DC blocker, like the HP_HZ of the
+*          on target PDM filter, and is written as 16 bit PCM.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define MAX_CHANNELS          4
+#define CIC_ORDER             5
+#define DC_BLOCK_HZ           10.0
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  int64_t integrator[CIC_ORDER];
+  int64_t comb[CIC_ORDER];
+  uint32_t phase;
+  double dc_x;
+  double dc_y;
+}
+Decimator_t;
+
+/* Private variables ---------------------------------------------------------*/
+static Decimator_t Decimator[MAX_CHANNELS];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Feeds one PDM bit to a CIC decimator.
+* @param  dec: decimator state
+* @param  bit: PDM bit, 0 or 1
+* @param  factor: decimation factor
+* @param  out: decimated CIC output, valid when 1 is returned
+* @retval 1 when an output sample is available, 0 otherwise
+*/
+static int CIC_Push(Decimator_t *dec, int bit, uint32_t factor, int64_t *out)
+{
+  int64_t x = bit ? 1 : -1;
+  int i;
+
+  for(i = 0; i < CIC_ORDER; i++)
+  {
+    dec->integrator[i] += x;
+    x = dec->integrator[i];
+  }
+  if(++dec->phase < factor)
+  {
+    return 0;
+  }
+  dec->phase = 0;
+  for(i = 0; i < CIC_ORDER; i++)
+  {
+    int64_t y = x - dec->comb[i];
+    dec->comb[i] = x;
+    x = y;
+  }
+  *out = x;
+  return 1;
+}
+
+/**
+* @brief  Writes a 16 bit PCM WAV header.
+* @param  f: output file
+* @param  channels: number of channels
+* @param  fs: sampling frequency in Hz
+* @param  samples: number of samples per channel
+* @retval None
+*/
+static void WAV_WriteHeader(FILE *f, uint16_t channels, uint32_t fs, uint32_t samples)
+{
+  uint32_t data = samples * channels * 2;
+  uint8_t h[44];
+
+  memcpy(h, "RIFF", 4);
+  h[4] = (36 + data) & 0xFF; h[5] = ((36 + data) >> 8) & 0xFF;
+  h[6] = ((36 + data) >> 16) & 0xFF; h[7] = (36 + data) >> 24;
+  memcpy(h + 8, "WAVEfmt ", 8);
+  h[16] = 16; h[17] = 0; h[18] = 0; h[19] = 0;
+  h[20] = 1; h[21] = 0;                                   /* PCM */
+  h[22] = channels; h[23] = 0;
+  h[24] = fs & 0xFF; h[25] = (fs >> 8) & 0xFF; h[26] = (fs >> 16) & 0xFF; h[27] = fs >> 24;
+  h[28] = (fs * channels * 2) & 0xFF; h[29] = ((fs * channels * 2) >> 8) & 0xFF;
+  h[30] = ((fs * channels * 2) >> 16) & 0xFF; h[31] = (fs * channels * 2) >> 24;
+  h[32] = channels * 2; h[33] = 0;
+  h[34] = 16; h[35] = 0;
+  memcpy(h + 36, "data", 4);
+  h[40] = data & 0xFF; h[41] = (data >> 8) & 0xFF; h[42] = (data >> 16) & 0xFF; h[43] = data >> 24;
+  fwrite(h, 1, sizeof(h), f);
+}
+
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: pdm_decimator [-c channels] [-f pdm_khz] [-d decimation] [-m] capture.raw out.wav\n"
+          "  -c  microphones in the capture, 1, 2 or 4 (default 2)\n"
+          "  -f  PDM clock in KHz (default 3072)\n"
+          "  -d  decimation factor (default 64)\n"
+          "  -m  first PDM bit in the MSB of each byte (default LSB, as the PDM_Filter_xx_LSB used on target)\n");
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t channels = 2;
+  uint32_t pdm_khz = 3072;
+  uint32_t factor = 64;
+  int msb_first = 0;
+  int arg = 1;
+  FILE *in;
+  FILE *out;
+  uint32_t fs;
+  uint32_t samples = 0;
+  double gain;
+  double dc_r;
+  uint8_t frame[MAX_CHANNELS];
+  int16_t pcm[MAX_CHANNELS];
+  uint32_t ready = 0;
+
+  while(arg < argc && argv[arg][0] == '-')
+  {
+    if(strcmp(argv[arg], "-m") == 0)
+    {
+      msb_first = 1;
+      arg++;
+    }
+    else if(arg + 1 < argc && strcmp(argv[arg], "-c") == 0)
+    {
+      channels = (uint32_t)atoi(argv[arg + 1]);
+      arg += 2;
+    }
+    else if(arg + 1 < argc && strcmp(argv[arg], "-f") == 0)
+    {
+      pdm_khz = (uint32_t)atoi(argv[arg + 1]);
+      arg += 2;
+    }
+    else if(arg + 1 < argc && strcmp(argv[arg], "-d") == 0)
+    {
+      factor = (uint32_t)atoi(argv[arg + 1]);
+      arg += 2;
+    }
+    else
+    {
+      Usage();
+      return 1;
+    }
+  }
+  if(argc - arg != 2 || channels == 0 || channels > MAX_CHANNELS || channels == 3 || factor < 8 || pdm_khz == 0)
+  {
+    Usage();
+    return 1;
+  }
+
+  in = fopen(argv[arg], "rb");
+  if(in == NULL)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+  out = fopen(argv[arg + 1], "wb");
+  if(out == NULL)
+  {
+    perror(argv[arg + 1]);
+    fclose(in);
+    return 1;
+  }
+
+  fs = (pdm_khz * 1000) / factor;
+  /* CIC DC gain is factor^order, map full scale to 16 bits */
+  gain = 32767.0 / pow((double)factor, CIC_ORDER);
+  dc_r = 1.0 - (2.0 * 3.14159265358979 * DC_BLOCK_HZ / fs);
+
+  /* Header is rewritten with the final length once the capture is processed */
+  WAV_WriteHeader(out, (uint16_t)channels, fs, 0);
+
+  while(fread(frame, 1, channels, in) == channels)
+  {
+    int b;
+    for(b = 0; b < 8; b++)
+    {
+      uint32_t ch;
+      int bit_pos = msb_first ? (7 - b) : b;
+      for(ch = 0; ch < channels; ch++)
+      {
+        Decimator_t *dec = &Decimator[ch];
+        int64_t cic;
+        if(CIC_Push(dec, (frame[ch] >> bit_pos) & 1, factor, &cic))
+        {
+          double x = (double)cic * gain;
+          double y = x - dec->dc_x + dc_r * dec->dc_y;
+          dec->dc_x = x;
+          dec->dc_y = y;
+          if(y > 32767.0)
+          {
+            y = 32767.0;
+          }
+          else if(y < -32768.0)
+          {
+            y = -32768.0;
+          }
+          pcm[ch] = (int16_t)lrint(y);
+          ready++;
+        }
+      }
+      /* All the channels decimate in lockstep */
+      if(ready == channels)
+      {
+        uint32_t i;
+        for(i = 0; i < channels; i++)
+        {
+          uint8_t le[2];
+          le[0] = (uint16_t)pcm[i] & 0xFF;
+          le[1] = (uint16_t)pcm[i] >> 8;
+          fwrite(le, 1, 2, out);
+        }
+        samples++;
+        ready = 0;
+      }
+    }
+  }
+
+  fseek(out, 0, SEEK_SET);
+  WAV_WriteHeader(out, (uint16_t)channels, fs, samples);
+  fclose(out);
+  fclose(in);
+
+  fprintf(stderr, "%u samples per channel at %u Hz\n", (unsigned)samples, (unsigned)fs);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
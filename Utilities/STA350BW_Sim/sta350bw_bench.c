@@ -0,0 +1,479 @@
+/**
+******************************************************************************
+* @file    sta350bw_bench.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host regression test and I2C cost bench of the STA350BW driver on
+*          the register-level simulator (sta350bw_sim.c). Each case makes the
+*          driver calls of one BSP_AUDIO_OUT_* function, through the same
+*          STA350BW_Drv and STA350BW_ExtDrv tables and with the same context
+*          as x_nucleo_cca01m1_audio_f4.c, checks the resulting device state,
+*          its I2C transaction and byte counts and prints them. It exits with
+*          1 on the first mismatch.
+*
+*          Build (from the repository root):
+*            cc -O2 -DUSE_STM32F4XX_NUCLEO -IUtilities/STA350BW_Sim
+*               -IDrivers/BSP/Components/sta350bw
+*               -IDrivers/BSP/Components/Common
+*               -IDrivers/BSP/X-NUCLEO-CCA01M1
+*               Utilities/STA350BW_Sim/sta350bw_bench.c
+*               Utilities/STA350BW_Sim/sta350bw_sim.c
+*               Utilities/STA350BW_Sim/hal_sim.c
+*               Drivers/BSP/X-NUCLEO-CCA01M1/x_nucleo_cca01m1_audio_f4.c
+*               Drivers/BSP/Components/sta350bw/STA350BW_Driver.c
+*               -o sta350bw_bench
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "x_nucleo_cca01m1_audio_f4.h"
+#include "sta350bw_sim.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_VOLUME              0x20
+#define BENCH_FREQ                STA350BW_Fs_48000
+#define BENCH_BANK_COEFFS         (STA350BW_BIQUADS_PER_CHANNEL * STA350BW_BIQUAD_COEFFS)
+#define BENCH_RAMP_BLOCKS         16
+/* Bus time of the transactions at the I2C clock of the board */
+#define BENCH_BUS_US(clocks)      ((clocks) * 1e6 / NUCLEO_I2C_EXPBD_SPEED)
+/* One biquad upload: CFADDR, 15 coefficient bytes and the CFUD strobe */
+#define BENCH_BURST_BYTES         (STA350BW_CFUD - STA350BW_CFADDR + 1)
+
+#define CHECK(cond)               do { if(!(cond)) { Bench_Fail(#cond, __LINE__); } } while(0)
+
+/* Private variables ---------------------------------------------------------*/
+static DrvContextTypeDef CODEC_Handle;
+static STA350BW_Data_t CODEC_Data;
+static SOUNDTERMINAL_Drv_t *Drv;
+static STA350BW_ExtDrv_t *ExtDrv;
+
+/* Private functions ---------------------------------------------------------*/
+static void Bench_Fail(const char *cond, int line)
+{
+  fprintf(stderr, "FAIL line %d: %s\n", line, cond);
+  exit(1);
+}
+
+/**
+* @brief  Sets up the context as BSP_AUDIO_OUT_Init does.
+* @param  cached: 1 to give the driver its register shadow
+* @retval None
+*/
+static void Bench_Setup(uint8_t cached)
+{
+  memset(&CODEC_Handle, 0, sizeof(CODEC_Handle));
+  memset(&CODEC_Data, 0, sizeof(CODEC_Data));
+  CODEC_Handle.address    = STA350BW_ADDRESS_1;
+  CODEC_Handle.isCombo    = 1;
+  CODEC_Handle.pData      = cached ? (void *)&CODEC_Data : NULL;
+  CODEC_Handle.pVTable    = (void *)&STA350BW_Drv;
+  CODEC_Handle.pExtVTable = (void *)&STA350BW_ExtDrv;
+  Drv = (SOUNDTERMINAL_Drv_t *)CODEC_Handle.pVTable;
+  ExtDrv = (STA350BW_ExtDrv_t *)CODEC_Handle.pExtVTable;
+  SIM_STA350BW_Reset();
+}
+
+/**
+* @brief  Prints the bus cost of a case and checks it against the expected one.
+* @param  name: case name
+* @param  xfer: expected I2C transactions, reads and writes
+* @param  bytes: expected bytes written
+* @retval None
+*/
+static void Bench_Report(const char *name, uint32_t xfer, uint32_t bytes)
+{
+  SIM_STA350BW_StatsTypeDef s;
+
+  SIM_STA350BW_GetStats(&s);
+  printf("%-34s %5u %5u %5u %6u %6u %8.1f\n", name, (unsigned)s.Transactions,
+         (unsigned)s.Writes, (unsigned)s.Reads, (unsigned)s.BytesWritten, (unsigned)s.BytesRead,
+         BENCH_BUS_US(s.BusClocks));
+  CHECK(s.Errors == 0);
+  CHECK(s.Transactions == xfer);
+  CHECK(s.BytesWritten == bytes);
+  SIM_STA350BW_ClearStats();
+}
+
+/**
+* @brief  Fills a bank of test coefficients, distinct per set and per word.
+* @param  coeffs: BENCH_BANK_COEFFS words
+* @param  seed: pattern seed
+* @retval None
+*/
+static void Bench_Coeffs(uint32_t *coeffs, uint32_t seed)
+{
+  uint32_t i;
+
+  for(i = 0; i < BENCH_BANK_COEFFS; i++)
+  {
+    coeffs[i] = (seed << 16) | (i * 0x0301) | 0x80;
+  }
+}
+
+/**
+* @brief  Checks the coefficient RAM of a channel against a bank of sets.
+* @retval None
+*/
+static void Bench_CheckBank(uint8_t bank, uint8_t firstBiquad, const uint32_t *coeffs)
+{
+  uint8_t i;
+
+  for(i = 0; i < BENCH_BANK_COEFFS; i++)
+  {
+    CHECK(SIM_STA350BW_GetCoef(bank, firstBiquad * STA350BW_BIQUAD_COEFFS + i) == (coeffs[i] & 0xFFFFFF));
+  }
+}
+
+/**
+* @brief  The control path of the demo: init, then the calls of Switch_Demo.
+* @param  cached: 1 to give the driver its register shadow
+* @retval None
+*/
+static void Bench_Run(uint8_t cached)
+{
+  uint32_t coeffs[BENCH_BANK_COEFFS];
+  uint32_t coeffs2[BENCH_BANK_COEFFS];
+  STA350BW_Limiter_t limiter;
+  uint8_t status;
+  uint8_t i;
+
+  Bench_Setup(cached);
+  printf("\n%s register shadow\n", cached ? "With" : "Without");
+  printf("%-34s %5s %5s %5s %6s %6s %8s\n", "BSP call", "xfer", "wr", "rd", "bytes", "read", "bus us");
+
+  /* BSP_AUDIO_OUT_Init */
+  CHECK(Drv->Init(&CODEC_Handle, BENCH_VOLUME, BENCH_FREQ, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == BENCH_VOLUME);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_CONF_REGA) & 0x1F) == STA350BW_MCLK_256_LR_48K);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_CONF_REGF) & 0x80);
+  CHECK(!cached || CODEC_Data.isShadowValid);
+  Bench_Report("BSP_AUDIO_OUT_Init", cached ? 4 : 6, cached ? 2 : 3);
+
+  /* BSP_AUDIO_OUT_SetVolume */
+  CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_1, 0x48, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_C1VOL) == 0x48);
+  Bench_Report("BSP_AUDIO_OUT_SetVolume", 1, 1);
+
+  /* BSP_AUDIO_OUT_SetMute */
+  CHECK(Drv->SetMute(&CODEC_Handle, 0x02, STA350BW_ENABLE, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == (0x10 | 0x02));
+  CHECK(Drv->SetMute(&CODEC_Handle, 0x02, STA350BW_DISABLE, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == 0x10);
+  Bench_Report("BSP_AUDIO_OUT_SetMute (on, off)", cached ? 2 : 4, 2);
+
+  /* BSP_AUDIO_OUT_SetTone */
+  CHECK(Drv->SetTone(&CODEC_Handle, 0x9A, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_TONE) == 0x9A);
+  Bench_Report("BSP_AUDIO_OUT_SetTone", 1, 1);
+
+  /* BSP_AUDIO_OUT_SetDSPOption */
+  CHECK(Drv->SetDSPOption(&CODEC_Handle, STA350BW_DSPB, STA350BW_ENABLE, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_CONF_REGD) & 0x04);
+  Bench_Report("BSP_AUDIO_OUT_SetDSPOption", cached ? 1 : 2, 1);
+
+  /* The same settings again: the shadow already holds them */
+  CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_1, 0x48, NULL) == STA350BW_OK);
+  CHECK(Drv->SetTone(&CODEC_Handle, 0x9A, NULL) == STA350BW_OK);
+  CHECK(Drv->SetMute(&CODEC_Handle, 0x02, STA350BW_DISABLE, NULL) == STA350BW_OK);
+  CHECK(Drv->SetDSPOption(&CODEC_Handle, STA350BW_DSPB, STA350BW_ENABLE, NULL) == STA350BW_OK);
+  Bench_Report("Repeated setters (4 calls)", cached ? 0 : 1 + 1 + 2 + 2, cached ? 0 : 4);
+
+  /* BSP_AUDIO_OUT_SetEq, one biquad */
+  Bench_Coeffs(coeffs, 0x11);
+  CHECK(Drv->SetEq(&CODEC_Handle, STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ2, coeffs, NULL) == STA350BW_OK);
+  for(i = 0; i < STA350BW_BIQUAD_COEFFS; i++)
+  {
+    CHECK(SIM_STA350BW_GetCoef(STA350BW_RAM_BANK_SECOND, STA350BW_CH1_BQ2 * STA350BW_BIQUAD_COEFFS + i) == (coeffs[i] & 0xFFFFFF));
+  }
+  CHECK((SIM_STA350BW_GetReg(STA350BW_EQCFG) & 0x03) == STA350BW_RAM_BANK_SECOND);
+  Bench_Report("BSP_AUDIO_OUT_SetEq (1 biquad)", cached ? 2 : 3, 1 + BENCH_BURST_BYTES);
+
+  /* The same 4 biquads on both channels, one SetEq per biquad */
+  for(i = STA350BW_CH1_BQ1; i <= STA350BW_CH2_BQ4; i++)
+  {
+    CHECK(Drv->SetEq(&CODEC_Handle, STA350BW_RAM_BANK_THIRD, i,
+                     &coeffs[(i % STA350BW_BIQUADS_PER_CHANNEL) * STA350BW_BIQUAD_COEFFS], NULL) == STA350BW_OK);
+  }
+  Bench_CheckBank(STA350BW_RAM_BANK_THIRD, STA350BW_CH1_BQ1, coeffs);
+  Bench_CheckBank(STA350BW_RAM_BANK_THIRD, STA350BW_CH2_BQ1, coeffs);
+  Bench_Report("BSP_AUDIO_OUT_SetEq (8 biquads)", cached ? 1 + 8 : 3 * 8, 
+               (cached ? 1 : 8) + 8 * BENCH_BURST_BYTES);
+
+  /* BSP_AUDIO_OUT_SetEqBank */
+  Bench_Coeffs(coeffs, 0x22);
+  CHECK(ExtDrv->SetEqBank(&CODEC_Handle, STA350BW_RAM_BANK_FIRST, STA350BW_CHANNEL_MASTER, coeffs, NULL) == STA350BW_OK);
+  Bench_CheckBank(STA350BW_RAM_BANK_FIRST, STA350BW_CH1_BQ1, coeffs);
+  Bench_CheckBank(STA350BW_RAM_BANK_FIRST, STA350BW_CH2_BQ1, coeffs);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_EQCFG) & 0x03) == STA350BW_RAM_BANK_FIRST);
+  Bench_Report("BSP_AUDIO_OUT_SetEqBank (master)", cached ? 1 + 8 : 2 + 8, 1 + 8 * BENCH_BURST_BYTES);
+
+  Bench_Coeffs(coeffs2, 0x33);
+  CHECK(ExtDrv->SetEqBank(&CODEC_Handle, STA350BW_RAM_BANK_FIRST, STA350BW_CHANNEL_2, coeffs2, NULL) == STA350BW_OK);
+  Bench_CheckBank(STA350BW_RAM_BANK_FIRST, STA350BW_CH1_BQ1, coeffs);
+  Bench_CheckBank(STA350BW_RAM_BANK_FIRST, STA350BW_CH2_BQ1, coeffs2);
+  Bench_Report("BSP_AUDIO_OUT_SetEqBank (ch 2)", cached ? 4 : 2 + 4, 
+               (cached ? 0 : 1) + 4 * BENCH_BURST_BYTES);
+
+  /* Switch_Demo step: bank, tone and both volumes as one update */
+  CHECK(ExtDrv->BeginUpdate(&CODEC_Handle, NULL) == STA350BW_OK);
+  CHECK(Drv->SetDSPOption(&CODEC_Handle, STA350BW_RAM_BANK_SELECT, STA350BW_RAM_BANK_SECOND, NULL) == STA350BW_OK);
+  CHECK(Drv->SetTone(&CODEC_Handle, 0x77, NULL) == STA350BW_OK);
+  CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_1, 0x50, NULL) == STA350BW_OK);
+  CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_2, 0x50, NULL) == STA350BW_OK);
+  CHECK(ExtDrv->CommitUpdate(&CODEC_Handle, NULL) == STA350BW_OK);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_EQCFG) & 0x03) == STA350BW_RAM_BANK_SECOND);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_TONE) == 0x77);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_C1VOL) == 0x50);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_C2VOL) == 0x50);
+  Bench_Report("BeginUpdate .. CommitUpdate", cached ? 3 : 5, 4);
+
+  /* Volume readback from the shadow, as BSP_AUDIO_OUT_SetVolumeRamp does */
+  CHECK(ExtDrv->GetVolume(&CODEC_Handle, STA350BW_CHANNEL_1, &status, NULL) == STA350BW_OK);
+  CHECK(status == 0x50);
+  SIM_STA350BW_ClearStats();
+
+  /* BSP_AUDIO_OUT_SetLimiterMapping, SetLimiterMode and SetLimiter */
+  limiter.AttackRate = 4500;
+  limiter.ReleaseRate = 150;
+  limiter.AttackThreshold = -1;
+  limiter.ReleaseThreshold = STA350BW_THRESHOLD_OFF;
+  CHECK(ExtDrv->SetLimiterMapping(&CODEC_Handle, STA350BW_CHANNEL_MASTER, STA350BW_LIMITER_1, NULL) == STA350BW_OK);
+  CHECK(ExtDrv->SetLimiterMode(&CODEC_Handle, STA350BW_LIMITER_ANTICLIPPING, NULL) == STA350BW_OK);
+  CHECK(ExtDrv->SetLimiter(&CODEC_Handle, STA350BW_LIMITER_1, &limiter, NULL) == STA350BW_OK);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_C1CFG) & 0x30) == 0x10);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_C2CFG) & 0x30) == 0x10);
+  CHECK((SIM_STA350BW_GetReg(STA350BW_C3CFG) & 0x30) == 0x00);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_L1AR) == 0x6A);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_L1ATR) == 0x50);
+  limiter.AttackThreshold = -20;
+  limiter.ReleaseThreshold = -30;
+  CHECK(ExtDrv->SetLimiterMode(&CODEC_Handle, STA350BW_LIMITER_DRC, NULL) == STA350BW_OK);
+  CHECK(ExtDrv->SetLimiter(&CODEC_Handle, STA350BW_LIMITER_2, &limiter, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_CONF_REGD) & 0x20);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_L2ATR) == 0x55);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_L1ATR) == 0x50);
+  Bench_Report("BSP_AUDIO_OUT_SetLimiter* (5 calls)", cached ? 4 : 12, cached ? 7 : 8);
+
+  /* BSP_AUDIO_OUT_FaultTask on a thermal fault, then once it is over */
+  CHECK(Drv->SetMute(&CODEC_Handle, 0x02, STA350BW_ENABLE, NULL) == STA350BW_OK);
+  SIM_STA350BW_ClearStats();
+  SIM_STA350BW_SetStatus(STA350BW_STATUS_OK & ~STA350BW_STATUS_TFAULT);
+  CHECK(ExtDrv->GetStatus(&CODEC_Handle, &status, NULL) == STA350BW_OK);
+  CHECK(status == (STA350BW_STATUS_OK & ~STA350BW_STATUS_TFAULT));
+  CHECK(ExtDrv->SetProtection(&CODEC_Handle, STA350BW_ENABLE, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == (0x10 | 0x02 | 0x01));
+  CHECK(!(SIM_STA350BW_GetReg(STA350BW_CONF_REGF) & STA350BW_EAPD_ON));
+  Bench_Report("BSP_AUDIO_OUT_FaultTask (fault)", cached ? 2 : 3, 2);
+  SIM_STA350BW_SetStatus(STA350BW_STATUS_OK);
+  CHECK(ExtDrv->GetStatus(&CODEC_Handle, &status, NULL) == STA350BW_OK);
+  CHECK(status == STA350BW_STATUS_OK);
+  CHECK(ExtDrv->SetProtection(&CODEC_Handle, STA350BW_DISABLE, NULL) == STA350BW_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == (0x10 | 0x02));
+  CHECK(SIM_STA350BW_GetReg(STA350BW_CONF_REGF) & STA350BW_EAPD_ON);
+  Bench_Report("BSP_AUDIO_OUT_FaultTask (clear)", cached ? 2 : 3, 2);
+  CHECK(Drv->SetMute(&CODEC_Handle, 0x02, STA350BW_DISABLE, NULL) == STA350BW_OK);
+  SIM_STA350BW_ClearStats();
+
+  /* A failed write must leave the device and the driver in agreement */
+  SIM_STA350BW_InjectErrors(1);
+  CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_MASTER, 0x10, NULL) == STA350BW_ERROR);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == BENCH_VOLUME);
+  CHECK(!cached || CODEC_Data.Shadow[STA350BW_MVOL] == BENCH_VOLUME);
+  SIM_STA350BW_ClearStats();
+  
+  /* A failed commit keeps its registers pending, the next commit writes them */
+  if(cached)
+  {
+    CHECK(ExtDrv->BeginUpdate(&CODEC_Handle, NULL) == STA350BW_OK);
+    CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_MASTER, 0x10, NULL) == STA350BW_OK);
+    CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_1, 0x58, NULL) == STA350BW_OK);
+    SIM_STA350BW_InjectErrors(1);
+    CHECK(ExtDrv->CommitUpdate(&CODEC_Handle, NULL) == STA350BW_ERROR);
+    CHECK(ExtDrv->BeginUpdate(&CODEC_Handle, NULL) == STA350BW_OK);
+    CHECK(ExtDrv->CommitUpdate(&CODEC_Handle, NULL) == STA350BW_OK);
+    CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == 0x10);
+    CHECK(SIM_STA350BW_GetReg(STA350BW_C1VOL) == 0x58);
+    CHECK(Drv->SetVolume(&CODEC_Handle, STA350BW_CHANNEL_MASTER, BENCH_VOLUME, NULL) == STA350BW_OK);
+    SIM_STA350BW_ClearStats();
+  }
+
+  /* BSP_AUDIO_OUT_Resync after a hardware reset of the device */
+  if(cached)
+  {
+    SIM_STA350BW_Reset();
+    CHECK(ExtDrv->Resync(&CODEC_Handle, NULL) == STA350BW_OK);
+    CHECK(CODEC_Data.Shadow[STA350BW_MVOL] == 0xFF);
+    CHECK(CODEC_Data.Shadow[STA350BW_TONE] == 0x77);
+    CHECK(CODEC_Data.Shadow[STA350BW_C1VOL] == 0x60);
+    Bench_Report("BSP_AUDIO_OUT_Resync", 1, 0);
+  }
+}
+
+/**
+* @brief  Volume ramps through the BSP: BSP_AUDIO_OUT_SetVolumeRamp, the 
+*         output half-buffer interrupt and BSP_AUDIO_OUT_VolumeTask, checked
+*         at each step against Start + (Target - Start) * k / N.
+* @param  None
+* @retval None
+*/
+static void Bench_Ramp(void)
+{
+  void *handle = NULL;
+  I2S_HandleTypeDef *hi2s = &hAudioOutI2s[STA350BW_0];
+  SIM_STA350BW_StatsTypeDef s;
+  uint8_t k;
+  uint8_t c1;
+  
+  SIM_STA350BW_Reset();
+  CHECK(BSP_AUDIO_OUT_Init(STA350BW_0, &handle, 1, BENCH_VOLUME, 48000) == COMPONENT_OK);
+  c1 = SIM_STA350BW_GetReg(STA350BW_C1VOL);
+  
+  /* Soft volume, on after reset: the device ramps, the target is one write */
+  CHECK(SIM_STA350BW_GetReg(STA350BW_CONF_REGE) & 0x80);
+  SIM_STA350BW_ClearStats();
+  CHECK(BSP_AUDIO_OUT_SetVolumeRamp(handle, STA350BW_CHANNEL_MASTER, 0x60, BENCH_RAMP_BLOCKS) == COMPONENT_OK);
+  HAL_I2S_TxHalfCpltCallback(hi2s);
+  CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == 0x60);
+  CHECK(!BSP_AUDIO_OUT_IsVolumeRamping(handle));
+  Bench_Report("SetVolumeRamp, soft volume", 1, 1);
+  
+  /* Soft volume off, as in the demo: master and channel 1 step together */
+  CHECK(BSP_AUDIO_OUT_SetDSPOption(handle, STA350BW_SVE, STA350BW_DISABLE) == COMPONENT_OK);
+  CHECK(!(SIM_STA350BW_GetReg(STA350BW_CONF_REGE) & 0x80));
+  SIM_STA350BW_ClearStats();
+  CHECK(BSP_AUDIO_OUT_SetVolumeRamp(handle, STA350BW_CHANNEL_MASTER, BENCH_VOLUME, BENCH_RAMP_BLOCKS) == COMPONENT_OK);
+  CHECK(BSP_AUDIO_OUT_SetVolumeRamp(handle, STA350BW_CHANNEL_1, 0x40, 5) == COMPONENT_OK);
+  CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == 0x60);
+  for(k = 1; k <= BENCH_RAMP_BLOCKS; k++)
+  {
+    HAL_I2S_TxHalfCpltCallback(hi2s);
+    CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+    CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == (uint8_t)(0x60 + (BENCH_VOLUME - 0x60) * k / BENCH_RAMP_BLOCKS));
+    CHECK(SIM_STA350BW_GetReg(STA350BW_C1VOL) == (uint8_t)(c1 + (0x40 - c1) * (k < 5 ? k : 5) / 5));
+    CHECK(BSP_AUDIO_OUT_IsVolumeRamping(handle) == (k < BENCH_RAMP_BLOCKS));
+  }
+  SIM_STA350BW_GetStats(&s);
+  CHECK(s.Writes == BENCH_RAMP_BLOCKS);
+  Bench_Report("SetVolumeRamp, 16 half-buffers", BENCH_RAMP_BLOCKS, BENCH_RAMP_BLOCKS + 5);
+  
+  /* A late VolumeTask applies all the half-buffers elapsed, in one write */
+  CHECK(BSP_AUDIO_OUT_SetVolumeRamp(handle, STA350BW_CHANNEL_MASTER, 0x60, BENCH_RAMP_BLOCKS) == COMPONENT_OK);
+  for(k = 0; k < 3; k++)
+  {
+    HAL_I2S_TxHalfCpltCallback(hi2s);
+  }
+  CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == (uint8_t)(BENCH_VOLUME + (0x60 - BENCH_VOLUME) * 3 / BENCH_RAMP_BLOCKS));
+  SIM_STA350BW_GetStats(&s);
+  CHECK(s.Writes == 1);
+  
+  /* A new target restarts from the value reached, an immediate write stops it */
+  CHECK(BSP_AUDIO_OUT_SetVolumeRamp(handle, STA350BW_CHANNEL_MASTER, 0x10, 2) == COMPONENT_OK);
+  HAL_I2S_TxHalfCpltCallback(hi2s);
+  CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+  k = (uint8_t)(BENCH_VOLUME + (0x60 - BENCH_VOLUME) * 3 / BENCH_RAMP_BLOCKS);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == (uint8_t)(k + (0x10 - k) / 2));
+  CHECK(BSP_AUDIO_OUT_SetVolume(handle, STA350BW_CHANNEL_MASTER, BENCH_VOLUME) == COMPONENT_OK);
+  HAL_I2S_TxHalfCpltCallback(hi2s);
+  CHECK(BSP_AUDIO_OUT_VolumeTask(handle) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MVOL) == BENCH_VOLUME);
+  CHECK(!BSP_AUDIO_OUT_IsVolumeRamping(handle));
+  Bench_Report("SetVolumeRamp restart and stop", 3, 3);
+}
+
+/**
+* @brief  A queued write lost after Sensor_IO_Write returned, as reported by
+*         the I2C queue: the BSP invalidates the shadow and the driver
+*         reloads it at its next read, without BSP_AUDIO_OUT_FaultTask.
+* @param  None
+* @retval None
+*/
+static void Bench_LostWrite(void)
+{
+  void *handle = NULL;
+  STA350BW_Data_t *data;
+  
+  SIM_STA350BW_Reset();
+  CHECK(BSP_AUDIO_OUT_Init(STA350BW_0, &handle, 1, BENCH_VOLUME, 48000) == COMPONENT_OK);
+  data = (STA350BW_Data_t *)((DrvContextTypeDef *)handle)->pData;
+  
+  SIM_STA350BW_LoseWrites(1);
+  CHECK(BSP_AUDIO_OUT_SetTone(handle, 0x9A) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_TONE) != 0x9A);
+  Sensor_IO_WriteCplt_Callback(SIM_STA350BW_ADDRESS, STA350BW_TONE, 1);
+  CHECK(!data->isShadowValid && data->isResyncPending);
+  SIM_STA350BW_ClearStats();
+  
+  /* The read of SetMute reloads the shadow, so the same tone is not skipped */
+  CHECK(BSP_AUDIO_OUT_SetMute(handle, 0x02, STA350BW_ENABLE) == COMPONENT_OK);
+  CHECK(data->isShadowValid && !data->isResyncPending);
+  CHECK(data->Shadow[STA350BW_TONE] == SIM_STA350BW_GetReg(STA350BW_TONE));
+  CHECK(BSP_AUDIO_OUT_SetTone(handle, 0x9A) == COMPONENT_OK);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_TONE) == 0x9A);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == (0x10 | 0x02));
+  Bench_Report("Lost write, reload at next read", 3, 2);
+  
+  /* A failed reload stays pending, the read itself still reaches the device */
+  SIM_STA350BW_LoseWrites(1);
+  CHECK(BSP_AUDIO_OUT_SetTone(handle, 0x77) == COMPONENT_OK);
+  Sensor_IO_WriteCplt_Callback(SIM_STA350BW_ADDRESS, STA350BW_TONE, 1);
+  SIM_STA350BW_InjectErrors(1);
+  CHECK(BSP_AUDIO_OUT_SetMute(handle, 0x02, STA350BW_DISABLE) == COMPONENT_OK);
+  CHECK(!data->isShadowValid && data->isResyncPending);
+  CHECK(SIM_STA350BW_GetReg(STA350BW_MUTE) == 0x10);
+  SIM_STA350BW_ClearStats();
+  CHECK(BSP_AUDIO_OUT_SetMute(handle, 0x02, STA350BW_ENABLE) == COMPONENT_OK);
+  CHECK(data->isShadowValid && !data->isResyncPending);
+  Bench_Report("Lost write, failed reload retried", 2, 1);
+}
+
+int main(void)
+{
+  Bench_Run(0);
+  Bench_Run(1);
+  Bench_Ramp();
+  Bench_LostWrite();
+  printf("\nPASS\n");
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,345 @@
+/**
+******************************************************************************
+* @file    sta350bw_sim.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Register-level model of the STA350BW. It replaces x_nucleo_cca01m1.c
+*          at link time and implements Sensor_IO_Write and Sensor_IO_Read on a
+*          register file holding the reset values of the device, so the
+*          STA350BW driver runs unchanged on the host.
+*
+*          Multi-byte accesses auto-increment the register address. The
+*          coefficient RAM has 3 banks of 64 words of 24 bits: the bank comes
+*          from EQCFG bits 1:0, the word from CFADDR, and the W1/WA (R1/RA)
+*          strobes in CFUD copy the b1 or the 5 coefficient registers to (from)
+*          the RAM, then self-clear as on the device. STATUS is read only and
+*          reports a locked PLL with no fault, unless a fault is simulated.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "component.h"
+#include "sta350bw_sim.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SIM_CFADDR                0x16
+#define SIM_B1CF1                 0x17
+#define SIM_CFUD                  0x26
+#define SIM_STATUS                0x2D
+#define SIM_EQCFG                 0x31
+
+#define SIM_CFUD_W1               0x01
+#define SIM_CFUD_WA               0x02
+#define SIM_CFUD_R1               0x04
+#define SIM_CFUD_RA               0x08
+
+#define SIM_STATUS_OK             0x7F
+#define SIM_COEFFS_PER_SET        5
+
+/* Bus time in SCL periods: a byte and its acknowledge take 9, a start, a
+   repeated start or a stop about 1. A write sends the device and register
+   addresses, a read sends them then the device address again */
+#define SIM_WRITE_CLOCKS(n)       (1 + 9 * (2 + (n)) + 1)
+#define SIM_READ_CLOCKS(n)        (1 + 9 * 2 + 1 + 9 * (1 + (n)) + 1)
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t SIM_ResetValues[SIM_STA350BW_REGISTERS] =
+{
+  /* 0x00 */ 0x63, 0x80, 0x9F, 0x40, 0xC2, 0x5C, 0x10, 0xFF,
+  /* 0x08 */ 0x60, 0x60, 0x60, 0x80, 0x00, 0x00, 0x00, 0x40,
+  /* 0x10 */ 0x80, 0x77, 0x6A, 0x69, 0x6A, 0x69, 0x00, 0x00,
+  /* 0x18 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  /* 0x20 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1A,
+  /* 0x28 */ 0x30, 0xF3, 0x33, 0x00, 0xC0, 0x7F, 0x00, 0x00,
+  /* 0x30 */ 0x00, 0x00, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00,
+  /* 0x38 */ 0x00, 0x01, 0xEE, 0xFF, 0x7E, 0xC0, 0x26, 0x00,
+  /* 0x40 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  /* 0x48 */ 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
+  /* 0x50 */ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+static uint8_t  SIM_Reg[SIM_STA350BW_REGISTERS];
+static uint32_t SIM_Ram[SIM_STA350BW_RAM_BANKS][SIM_STA350BW_RAM_SIZE];
+static SIM_STA350BW_StatsTypeDef SIM_Stats;
+static uint32_t SIM_ErrorsToInject;
+static uint32_t SIM_WritesToLose;
+static uint8_t  SIM_Status;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Runs the strobes written in CFUD on the selected RAM bank.
+* @param  strobes: CFUD value
+* @retval 0 on success, 1 if the bank or the address is out of range
+*/
+static uint8_t SIM_Strobe(uint8_t strobes)
+{
+  uint8_t bank = SIM_Reg[SIM_EQCFG] & 0x03;
+  uint8_t addr = SIM_Reg[SIM_CFADDR] & 0x3F;
+  uint8_t count = 0;
+  uint8_t i;
+
+  if(strobes & (SIM_CFUD_WA | SIM_CFUD_RA))
+  {
+    count = SIM_COEFFS_PER_SET;
+  }
+  else if(strobes & (SIM_CFUD_W1 | SIM_CFUD_R1))
+  {
+    count = 1;
+  }
+  if(count == 0)
+  {
+    return 0;
+  }
+  if(bank >= SIM_STA350BW_RAM_BANKS || addr + count > SIM_STA350BW_RAM_SIZE)
+  {
+    return 1;
+  }
+
+  for(i = 0; i < count; i++)
+  {
+    uint8_t *cf = &SIM_Reg[SIM_B1CF1 + i * 3];
+    if(strobes & (SIM_CFUD_W1 | SIM_CFUD_WA))
+    {
+      SIM_Ram[bank][addr + i] = ((uint32_t)cf[0] << 16) | ((uint32_t)cf[1] << 8) | cf[2];
+      SIM_Stats.RamWrites++;
+    }
+    else
+    {
+      cf[0] = (SIM_Ram[bank][addr + i] >> 16) & 0xFF;
+      cf[1] = (SIM_Ram[bank][addr + i] >> 8) & 0xFF;
+      cf[2] = SIM_Ram[bank][addr + i] & 0xFF;
+    }
+  }
+  return 0;
+}
+
+/**
+* @brief  Common accounting of a transaction.
+* @param  handle: driver context, its address selects the device
+* @retval 0 if the device acknowledges the transaction, 1 otherwise
+*/
+static uint8_t SIM_Start(void *handle)
+{
+  DrvContextTypeDef *ctx = (DrvContextTypeDef *)handle;
+
+  if(ctx == NULL || ctx->address != SIM_STA350BW_ADDRESS)
+  {
+    SIM_Stats.Errors++;
+    return 1;
+  }
+  SIM_Stats.Transactions++;
+  if(SIM_ErrorsToInject != 0)
+  {
+    SIM_ErrorsToInject--;
+    SIM_Stats.Errors++;
+    return 1;
+  }
+  return 0;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+* @brief  Puts the device back to its power on state and clears the counters.
+* @retval None
+*/
+void SIM_STA350BW_Reset(void)
+{
+  uint8_t bank;
+  uint8_t addr;
+
+  memcpy(SIM_Reg, SIM_ResetValues, sizeof(SIM_Reg));
+  /* The RAM powers up with pass through biquads: b0 = 1.0, the rest 0 */
+  for(bank = 0; bank < SIM_STA350BW_RAM_BANKS; bank++)
+  {
+    for(addr = 0; addr < SIM_STA350BW_RAM_SIZE; addr++)
+    {
+      SIM_Ram[bank][addr] = (addr % SIM_COEFFS_PER_SET == 4) ? 0x400000 : 0;
+    }
+  }
+  SIM_ErrorsToInject = 0;
+  SIM_WritesToLose = 0;
+  SIM_Status = SIM_STATUS_OK;
+  SIM_STA350BW_ClearStats();
+}
+
+/**
+* @brief  Gets a register without going through the bus.
+* @param  reg: register address
+* @retval Register value, 0 out of range
+*/
+uint8_t SIM_STA350BW_GetReg(uint8_t reg)
+{
+  return reg < SIM_STA350BW_REGISTERS ? SIM_Reg[reg] : 0;
+}
+
+/**
+* @brief  Gets a coefficient RAM word without going through the bus.
+* @param  bank: RAM bank, 0 to SIM_STA350BW_RAM_BANKS - 1
+* @param  addr: RAM address
+* @retval 24 bit coefficient, 0 out of range
+*/
+uint32_t SIM_STA350BW_GetCoef(uint8_t bank, uint8_t addr)
+{
+  if(bank >= SIM_STA350BW_RAM_BANKS || addr >= SIM_STA350BW_RAM_SIZE)
+  {
+    return 0;
+  }
+  return SIM_Ram[bank][addr];
+}
+
+void SIM_STA350BW_GetStats(SIM_STA350BW_StatsTypeDef *stats)
+{
+  *stats = SIM_Stats;
+}
+
+void SIM_STA350BW_ClearStats(void)
+{
+  memset(&SIM_Stats, 0, sizeof(SIM_Stats));
+}
+
+/**
+* @brief  NACKs the next transactions, to exercise the error paths.
+* @param  count: number of transactions to fail
+* @retval None
+*/
+void SIM_STA350BW_InjectErrors(uint32_t count)
+{
+  SIM_ErrorsToInject = count;
+}
+
+/**
+* @brief  Accepts the next writes without applying them, as queued writes
+*         the bus gives up after Sensor_IO_Write has returned.
+* @param  count: number of writes to lose
+* @retval None
+*/
+void SIM_STA350BW_LoseWrites(uint32_t count)
+{
+  SIM_WritesToLose = count;
+}
+
+/**
+* @brief  Sets the value read from STATUS, to simulate faults.
+* @param  status: STATUS value, 0x7F when there is no fault
+* @retval None
+*/
+void SIM_STA350BW_SetStatus(uint8_t status)
+{
+  SIM_Status = status;
+}
+
+/**
+* @brief  Writes registers of the simulated device.
+* @param  handle: driver context
+* @param  WriteAddr: first register
+* @param  pBuffer: data to write
+* @param  nBytesToWrite: number of bytes, the address auto-increments
+* @retval 0 in case of success, 1 otherwise
+*/
+uint8_t Sensor_IO_Write(void *handle, uint8_t WriteAddr, uint8_t *pBuffer, uint16_t nBytesToWrite)
+{
+  uint16_t i;
+
+  if(SIM_Start(handle) != 0)
+  {
+    return 1;
+  }
+  SIM_Stats.Writes++;
+  if(WriteAddr + nBytesToWrite > SIM_STA350BW_REGISTERS)
+  {
+    SIM_Stats.Errors++;
+    return 1;
+  }
+  SIM_Stats.BytesWritten += nBytesToWrite;
+  SIM_Stats.BusClocks += SIM_WRITE_CLOCKS(nBytesToWrite);
+  if(SIM_WritesToLose != 0)
+  {
+    SIM_WritesToLose--;
+    return 0;
+  }
+
+  for(i = 0; i < nBytesToWrite; i++)
+  {
+    uint8_t reg = WriteAddr + i;
+    if(reg == SIM_STATUS)
+    {
+      continue;
+    }
+    SIM_Reg[reg] = pBuffer[i];
+    if(reg == SIM_CFUD)
+    {
+      if(SIM_Strobe(pBuffer[i]) != 0)
+      {
+        SIM_Stats.Errors++;
+      }
+      SIM_Reg[SIM_CFUD] &= ~(SIM_CFUD_W1 | SIM_CFUD_WA | SIM_CFUD_R1 | SIM_CFUD_RA);
+    }
+  }
+  return 0;
+}
+
+/**
+* @brief  Reads registers of the simulated device.
+* @param  handle: driver context
+* @param  ReadAddr: first register
+* @param  pBuffer: destination
+* @param  nBytesToRead: number of bytes, the address auto-increments
+* @retval 0 in case of success, 1 otherwise
+*/
+uint8_t Sensor_IO_Read(void *handle, uint8_t ReadAddr, uint8_t *pBuffer, uint16_t nBytesToRead)
+{
+  if(SIM_Start(handle) != 0)
+  {
+    return 1;
+  }
+  SIM_Stats.Reads++;
+  if(ReadAddr + nBytesToRead > SIM_STA350BW_REGISTERS)
+  {
+    SIM_Stats.Errors++;
+    return 1;
+  }
+  SIM_Stats.BytesRead += nBytesToRead;
+  SIM_Stats.BusClocks += SIM_READ_CLOCKS(nBytesToRead);
+  SIM_Reg[SIM_STATUS] = SIM_Status;
+  memcpy(pBuffer, &SIM_Reg[ReadAddr], nBytesToRead);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
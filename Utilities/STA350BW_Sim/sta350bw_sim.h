@@ -0,0 +1,84 @@
+/**
+******************************************************************************
+* @file    sta350bw_sim.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Register-level model of the STA350BW behind Sensor_IO_Write and
+*          Sensor_IO_Read, for running the driver on the host.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STA350BW_SIM_H
+#define __STA350BW_SIM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define SIM_STA350BW_ADDRESS        0x38    /* STA350BW_ADDRESS_1 */
+#define SIM_STA350BW_REGISTERS      0x56    /* STA350BW_MAX_REGISTERS */
+#define SIM_STA350BW_RAM_BANKS      3
+#define SIM_STA350BW_RAM_SIZE       64      /* CFADDR bits 5:0 */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t  Transactions;           /*!< I2C transactions addressed to the device */
+  uint32_t  Writes;
+  uint32_t  Reads;
+  uint32_t  BytesWritten;           /*!< Payload bytes, register address excluded */
+  uint32_t  BytesRead;
+  uint32_t  RamWrites;              /*!< Coefficients stored by the W1 and WA strobes */
+  uint32_t  Errors;                 /*!< NACKed or malformed transactions */
+  uint32_t  BusClocks;              /*!< SCL periods on the bus: start, address, data, acknowledges and stop */
+}
+SIM_STA350BW_StatsTypeDef;
+
+/* Exported functions --------------------------------------------------------*/
+void     SIM_STA350BW_Reset(void);
+uint8_t  SIM_STA350BW_GetReg(uint8_t reg);
+uint32_t SIM_STA350BW_GetCoef(uint8_t bank, uint8_t addr);
+void     SIM_STA350BW_GetStats(SIM_STA350BW_StatsTypeDef *stats);
+void     SIM_STA350BW_ClearStats(void);
+void     SIM_STA350BW_InjectErrors(uint32_t count);
+void     SIM_STA350BW_LoseWrites(uint32_t count);
+void     SIM_STA350BW_SetStatus(uint8_t status);
+
+#endif /* __STA350BW_SIM_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
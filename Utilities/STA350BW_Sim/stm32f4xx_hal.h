@@ -0,0 +1,281 @@
+/**
+******************************************************************************
+* @file    stm32f4xx_hal.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host stand-in of the STM32F4 HAL, so that x_nucleo_cca01m1_audio_f4.c
+*          builds in the STA350BW bench. Only what the audio BSP uses is
+*          declared; the calls do nothing and succeed (hal_sim.c), except
+*          the interrupt mask, which is recorded.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef __IO
+#define __IO                            volatile
+#endif
+#ifndef __weak
+#define __weak                          __attribute__((weak))
+#endif
+
+typedef enum
+{
+  HAL_OK = 0,
+  HAL_ERROR,
+  HAL_BUSY,
+  HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  HAL_I2S_STATE_RESET = 0,
+  HAL_I2S_STATE_READY,
+  HAL_I2S_STATE_BUSY
+} HAL_I2S_StateTypeDef;
+
+typedef enum
+{
+  EXTI0_IRQn = 6,
+  EXTI1_IRQn = 7,
+  DMA1_Stream4_IRQn = 15,
+  DMA1_Stream7_IRQn = 47,
+  EXTI15_10_IRQn = 40,
+  I2C1_EV_IRQn = 31,
+  I2C1_ER_IRQn = 32
+} IRQn_Type;
+
+/* Peripherals are only compared by address */
+typedef struct { uint32_t Dummy; } SIM_PeriphTypeDef;
+typedef SIM_PeriphTypeDef SPI_TypeDef;
+typedef SIM_PeriphTypeDef GPIO_TypeDef;
+typedef SIM_PeriphTypeDef DMA_Stream_TypeDef;
+typedef SIM_PeriphTypeDef I2C_TypeDef;
+extern SIM_PeriphTypeDef SIM_Periph[10];
+#define SPI2                            (&SIM_Periph[0])
+#define SPI3                            (&SIM_Periph[1])
+#define GPIOA                           (&SIM_Periph[2])
+#define GPIOB                           (&SIM_Periph[3])
+#define GPIOC                           (&SIM_Periph[4])
+#define DMA1_Stream4                    (&SIM_Periph[5])
+#define DMA1_Stream7                    (&SIM_Periph[6])
+#define I2C1                            (&SIM_Periph[7])
+
+#define GPIO_PIN_0                      ((uint16_t)0x0001)
+#define GPIO_PIN_1                      ((uint16_t)0x0002)
+#define GPIO_PIN_4                      ((uint16_t)0x0010)
+#define GPIO_PIN_6                      ((uint16_t)0x0040)
+#define GPIO_PIN_7                      ((uint16_t)0x0080)
+#define GPIO_PIN_8                      ((uint16_t)0x0100)
+#define GPIO_PIN_9                      ((uint16_t)0x0200)
+#define GPIO_PIN_10                     ((uint16_t)0x0400)
+#define GPIO_PIN_12                     ((uint16_t)0x1000)
+#define GPIO_PIN_13                     ((uint16_t)0x2000)
+#define GPIO_PIN_15                     ((uint16_t)0x8000)
+#define GPIO_MODE_OUTPUT_PP             0x01
+#define GPIO_MODE_AF_PP                 0x02
+#define GPIO_MODE_IT_RISING_FALLING     0x10310000
+#define GPIO_NOPULL                     0x00
+#define GPIO_PULLUP                     0x01
+#define GPIO_PULLDOWN                   0x02
+#define GPIO_SPEED_LOW                  0x00
+#define GPIO_SPEED_FAST                 0x02
+#define GPIO_AF1_I2C1                   0x01
+#define GPIO_AF4_I2C1                   0x04
+#define GPIO_AF5_SPI2                   0x05
+#define GPIO_AF6_SPI3                   0x06
+
+typedef enum
+{
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+#define DMA_CHANNEL_0                   0x00
+#define DMA_MEMORY_TO_PERIPH            0x40
+#define DMA_PINC_DISABLE                0x00
+#define DMA_MINC_ENABLE                 0x400
+#define DMA_PDATAALIGN_HALFWORD         0x800
+#define DMA_MDATAALIGN_HALFWORD         0x2000
+#define DMA_CIRCULAR                    0x100
+#define DMA_PRIORITY_HIGH               0x20000
+#define DMA_FIFOMODE_ENABLE             0x04
+#define DMA_FIFO_THRESHOLD_FULL         0x03
+#define DMA_MBURST_SINGLE               0x00
+#define DMA_PBURST_SINGLE               0x00
+
+#define I2S_MODE_MASTER_TX              0x200
+#define I2S_STANDARD_PHILIPS            0x00
+#define I2S_STANDARD_PHILLIPS           I2S_STANDARD_PHILIPS
+#define I2S_DATAFORMAT_16B              0x00
+#define I2S_MCLKOUTPUT_ENABLE           0x200
+#define I2S_CPOL_LOW                    0x00
+#define I2S_CLOCK_PLL                   0x00
+#define I2S_FULLDUPLEXMODE_DISABLE      0x00
+
+#define RCC_PERIPHCLK_I2S               0x01
+#define RCC_PERIPHCLK_I2S_APB2          0x01
+#define RCC_PERIPHCLK_I2C1              0x02
+#define RCC_I2C1CLKSOURCE_HSI           0x00
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+  uint32_t Channel;
+  uint32_t Direction;
+  uint32_t PeriphInc;
+  uint32_t MemInc;
+  uint32_t PeriphDataAlignment;
+  uint32_t MemDataAlignment;
+  uint32_t Mode;
+  uint32_t Priority;
+  uint32_t FIFOMode;
+  uint32_t FIFOThreshold;
+  uint32_t MemBurst;
+  uint32_t PeriphBurst;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+  DMA_Stream_TypeDef *Instance;
+  DMA_InitTypeDef Init;
+  void *Parent;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t Mode;
+  uint32_t Standard;
+  uint32_t DataFormat;
+  uint32_t MCLKOutput;
+  uint32_t AudioFreq;
+  uint32_t CPOL;
+  uint32_t ClockSource;
+  uint32_t FullDuplexMode;
+} I2S_InitTypeDef;
+
+typedef struct
+{
+  SPI_TypeDef *Instance;
+  I2S_InitTypeDef Init;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+  HAL_I2S_StateTypeDef State;
+} I2S_HandleTypeDef;
+
+typedef struct
+{
+  I2C_TypeDef *Instance;
+} I2C_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t PLLI2SN;
+  uint32_t PLLI2SR;
+  uint32_t PLLI2SQ;
+} RCC_PLLI2SInitTypeDef;
+
+typedef struct
+{
+  uint32_t PeriphClockSelection;
+  RCC_PLLI2SInitTypeDef PLLI2S;
+  uint32_t I2sClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+/* Exported macros -----------------------------------------------------------*/
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+  do { (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__); (__DMA_HANDLE__).Parent = (__HANDLE__); } while(0)
+#define __HAL_I2S_ENABLE(__HANDLE__)    ((void)(__HANDLE__))
+#define __HAL_I2S_DISABLE(__HANDLE__)   ((void)(__HANDLE__))
+#define __GPIOA_CLK_ENABLE()
+#define __GPIOB_CLK_ENABLE()
+#define __GPIOC_CLK_ENABLE()
+#define __DMA1_CLK_ENABLE()
+#define __SPI2_CLK_ENABLE()
+#define __SPI3_CLK_ENABLE()
+#define __SPI2_CLK_DISABLE()
+#define __SPI3_CLK_DISABLE()
+#define __I2C1_CLK_ENABLE()
+#define __I2C1_FORCE_RESET()
+#define __I2C1_RELEASE_RESET()
+
+/* Exported functions --------------------------------------------------------*/
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+void HAL_Delay(uint32_t Delay);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+void HAL_RCCEx_GetPeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+HAL_StatusTypeDef HAL_I2S_Init(I2S_HandleTypeDef *hi2s);
+HAL_I2S_StateTypeDef HAL_I2S_GetState(I2S_HandleTypeDef *hi2s);
+HAL_StatusTypeDef HAL_I2S_Transmit_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2S_DMAPause(I2S_HandleTypeDef *hi2s);
+HAL_StatusTypeDef HAL_I2S_DMAResume(I2S_HandleTypeDef *hi2s);
+HAL_StatusTypeDef HAL_I2S_DMAStop(I2S_HandleTypeDef *hi2s);
+void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s);
+void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+#endif /* __STM32F4xx_HAL_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
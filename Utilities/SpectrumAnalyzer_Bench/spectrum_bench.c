@@ -0,0 +1,317 @@
+/**
+******************************************************************************
+* @file    spectrum_bench.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host check of the spectrum analyzer (SpectrumAnalyzer.c).
+*
+*          Build:  cc -O2 -Wall -DARM_MATH_CM4 -isystem Drivers/CMSIS/Include
+*                    -IMiddlewares/ST/STM32_Audio/Addons/SpectrumAnalyzer
+*                    Utilities/SpectrumAnalyzer_Bench/spectrum_bench.c
+*                    Middlewares/ST/STM32_Audio/Addons/SpectrumAnalyzer/SpectrumAnalyzer.c
+*                    Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_rfft_fast_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_rfft_fast_init_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_cfft_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_cfft_radix8_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_bitreversal2.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_mag_squared_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/ControllerFunctions/arm_sin_cos_f32.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c
+*                    Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_const_structs.c
+*                    -lm -o spectrum_bench
+*          Usage:  spectrum_bench
+*
+*          The signals are fed 1 ms at a time, as BSP_AUDIO_IN_PDMToPCM
+*          delivers them, and each hop is processed right after. A -6 dB
+*          sine at the center of each 1/3 octave band at least 4 bins wide
+*          must read -6 dB in its band, its linear bin and the total, and be
+*          well above the bands two away. White noise must give flat linear
+*          bins at the level of its variance. The bench also checks the
+*          channel selection, the update rate and the overrun count, and
+*          times one hop on the host.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "SpectrumAnalyzer.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SPEC_MS_PER_CALL          1             /* N_MS_PER_INTERRUPT of the capture */
+#define SPEC_MAX_CHANNELS         4
+#define SPEC_SECONDS              2
+#define SPEC_NOISE_SECONDS        4             /* Averaged over all but the first second */
+#define SPEC_MIN_BAND_BINS        4.0           /* Narrower bands are only interpolated */
+#define SPEC_MAX_LEVEL_ERROR      0.3           /* dB, sine in the middle of a band or bin */
+#define SPEC_MAX_NOISE_ERROR      0.5           /* dB, white noise against the expected level */
+#define SPEC_MIN_REJECTION        25.0          /* dB, bands two away from the tone */
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t SpecFs[] = { 16000, 32000, 48000 };
+static SPECTRUM_Handler_t Analyzer;
+static int16_t Pcm[48 * SPEC_MS_PER_CALL * SPEC_MAX_CHANNELS];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+* @brief  Feeds a signal as the capture does, one PDMToPCM buffer per call,
+*         and processes each hop as the main loop would.
+* @param  fs: sampling frequency in Hz
+* @param  channels: interleaved channels
+* @param  amp: amplitude of each channel, full scale 32768
+* @param  freq: sine frequency of each channel in Hz, 0 for white noise
+* @param  seconds: duration
+* @param  snap: last snapshot
+* @retval number of snapshots published
+*/
+static uint32_t Spec_Run(uint32_t fs, uint32_t channels, const double *amp, const double *freq,
+                         uint32_t seconds, SPECTRUM_Snapshot_t *snap)
+{
+  uint32_t perCall = fs / 1000 * SPEC_MS_PER_CALL;
+  uint32_t calls = seconds * 1000 / SPEC_MS_PER_CALL;
+  uint32_t updates = 0;
+  uint64_t t = 0;
+  uint32_t call, i, c;
+
+  for(call = 0; call < calls; call++)
+  {
+    for(i = 0; i < perCall; i++, t++)
+    {
+      for(c = 0; c < channels; c++)
+      {
+        double x;
+
+        if(freq[c] > 0.0)
+        {
+          x = amp[c] * sin(2.0 * M_PI * freq[c] * (double)t / fs);
+        }
+        else
+        {
+          /* Uniform noise, variance amp^2 / 3 */
+          x = amp[c] * (2.0 * rand() / (double)RAND_MAX - 1.0);
+        }
+        Pcm[i * channels + c] = (int16_t)lrint(fmin(fmax(x, -32768.0), 32767.0));
+      }
+    }
+    SPECTRUM_Feed(&Analyzer, Pcm, perCall);
+    if(SPECTRUM_Process(&Analyzer) == SPECTRUM_UPDATED)
+    {
+      updates++;
+    }
+  }
+  SPECTRUM_GetSnapshot(&Analyzer, snap);
+  return updates;
+}
+
+/**
+* @brief  Checks one level against its expected value.
+* @param  name: printed on error
+* @param  got: level in 0.01 dB
+* @param  expected: expected level in dB
+* @param  limit: largest error in dB
+* @param  worst: largest error seen, updated
+* @retval 1 if out of the limit, 0 otherwise
+*/
+static int Spec_Check(const char *name, int16_t got, double expected, double limit, double *worst)
+{
+  double e = fabs(got / 100.0 - expected);
+
+  if(e > *worst)
+  {
+    *worst = e;
+  }
+  if(e > limit)
+  {
+    printf("  %s: %.2f dB, expected %.2f dB\n", name, got / 100.0, expected);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void)
+{
+  SPECTRUM_Snapshot_t snap;
+  double amp[SPEC_MAX_CHANNELS], freq[SPEC_MAX_CHANNELS];
+  double worstTone = 0.0, worstNoise = 0.0, worstRejection = 1000.0;
+  uint32_t tones = 0, errors = 0;
+  uint32_t f, k, updates;
+  clock_t start;
+  double seconds;
+  int fail = 0;
+
+  srand(1);
+  for(f = 0; f < sizeof(SpecFs) / sizeof(SpecFs[0]); f++)
+  {
+    uint32_t fs = SpecFs[f];
+    double binHz = (double)fs / SPECTRUM_FFT_SIZE;
+    double center = 1000.0 * pow(10.0, -1.7);
+
+    /* A -6 dB sine at the center of each band wide enough */
+    for(k = 0; k < SPECTRUM_THIRD_BANDS; k++, center *= pow(10.0, 0.1))
+    {
+      double width = center * (pow(2.0, 1.0 / 6.0) - pow(2.0, -1.0 / 6.0)) / binHz;
+      uint32_t lin;
+      char name[64];
+
+      if(width < SPEC_MIN_BAND_BINS || center * pow(2.0, 1.0 / 6.0) > fs / 2.0 - 4.0 * binHz)
+      {
+        continue;
+      }
+      SPECTRUM_Init(&Analyzer, fs, 1, 0, 100);
+      amp[0] = 16384.0;
+      freq[0] = center;
+      Spec_Run(fs, 1, amp, freq, 1, &snap);
+      tones++;
+
+      snprintf(name, sizeof(name), "%u Hz, %.0f Hz third", (unsigned)fs, center);
+      errors += Spec_Check(name, snap.Third[k], -6.02, SPEC_MAX_LEVEL_ERROR, &worstTone);
+      snprintf(name, sizeof(name), "%u Hz, %.0f Hz total", (unsigned)fs, center);
+      errors += Spec_Check(name, snap.Total, -6.02, SPEC_MAX_LEVEL_ERROR, &worstTone);
+
+      /* Linear bin of the tone, when away from its edges */
+      lin = (uint32_t)(center / (binHz * SPECTRUM_FFT_SIZE / 2 / SPECTRUM_LINEAR_BINS));
+      if(fabs(center / binHz - (lin + 0.5) * (SPECTRUM_FFT_SIZE / 2 / SPECTRUM_LINEAR_BINS)) <
+         (SPECTRUM_FFT_SIZE / 2 / SPECTRUM_LINEAR_BINS) / 2.0 - 3.0)
+      {
+        snprintf(name, sizeof(name), "%u Hz, %.0f Hz linear", (unsigned)fs, center);
+        errors += Spec_Check(name, snap.Linear[lin], -6.02, SPEC_MAX_LEVEL_ERROR, &worstTone);
+      }
+      if(k >= 2)
+      {
+        worstRejection = fmin(worstRejection, (snap.Third[k] - snap.Third[k - 2]) / 100.0);
+      }
+      if(k + 2 < SPECTRUM_THIRD_BANDS && snap.Third[k + 2] != SPECTRUM_FLOOR)
+      {
+        worstRejection = fmin(worstRejection, (snap.Third[k] - snap.Third[k + 2]) / 100.0);
+      }
+    }
+
+    /* White noise: flat linear bins, total at 10 log10(2 var / FS^2) */
+    SPECTRUM_Init(&Analyzer, fs, 1, 0, (SPEC_NOISE_SECONDS - 1) * 1000);
+    amp[0] = 8192.0;
+    freq[0] = 0.0;
+    Spec_Run(fs, 1, amp, freq, SPEC_NOISE_SECONDS, &snap);
+    {
+      double total = 10.0 * log10(2.0 * amp[0] * amp[0] / 3.0 / (32768.0 * 32768.0));
+      double bin = total - 10.0 * log10(SPECTRUM_LINEAR_BINS);
+      char name[64];
+
+      snprintf(name, sizeof(name), "%u Hz, noise total", (unsigned)fs);
+      errors += Spec_Check(name, snap.Total, total, SPEC_MAX_NOISE_ERROR, &worstNoise);
+      /* Bin 0 also has the DC rejection of the window, skip it */
+      for(k = 1; k < SPECTRUM_LINEAR_BINS; k++)
+      {
+        snprintf(name, sizeof(name), "%u Hz, noise linear %u", (unsigned)fs, (unsigned)k);
+        errors += Spec_Check(name, snap.Linear[k], bin, SPEC_MAX_NOISE_ERROR, &worstNoise);
+      }
+    }
+  }
+  printf("%u tones, largest level error %.3f dB, rejection two bands away %.1f dB\n",
+         (unsigned)tones, worstTone, worstRejection);
+  printf("white noise, largest level error %.3f dB\n", worstNoise);
+
+  /* Channel selection and mix of a stereo capture */
+  amp[0] = 0.0;
+  amp[1] = 16384.0;
+  freq[0] = 1000.0;
+  freq[1] = 1000.0;
+  SPECTRUM_Init(&Analyzer, 48000, 2, 1, 100);
+  Spec_Run(48000, 2, amp, freq, 1, &snap);
+  errors += Spec_Check("right channel", snap.Total, -6.02, SPEC_MAX_LEVEL_ERROR, &worstTone);
+  SPECTRUM_Init(&Analyzer, 48000, 2, 0, 100);
+  Spec_Run(48000, 2, amp, freq, 1, &snap);
+  if(snap.Total != SPECTRUM_FLOOR)
+  {
+    printf("  left channel: %.2f dB, expected silence\n", snap.Total / 100.0);
+    errors++;
+  }
+  SPECTRUM_Init(&Analyzer, 48000, 2, SPECTRUM_CHANNEL_MIX, 100);
+  Spec_Run(48000, 2, amp, freq, 1, &snap);
+  errors += Spec_Check("mix", snap.Total, -12.04, SPEC_MAX_LEVEL_ERROR, &worstTone);
+
+  /* Update rate: 100 ms is 9 hops at 48 KHz */
+  SPECTRUM_Init(&Analyzer, 48000, 1, 0, 100);
+  updates = Spec_Run(48000, 1, amp + 1, freq + 1, SPEC_SECONDS, &snap);
+  printf("100 ms updates at 48 KHz: %u in %u s, %u frames each, sequence %u\n", (unsigned)updates,
+         (unsigned)SPEC_SECONDS, (unsigned)snap.Frames, (unsigned)snap.Sequence);
+  if(snap.Frames != 9 || updates != snap.Sequence || updates < SPEC_SECONDS * 48000 / SPECTRUM_HOP_SIZE / 9 - 1)
+  {
+    errors++;
+  }
+
+  /* A main loop late by four hops skips three of them */
+  SPECTRUM_Init(&Analyzer, 48000, 1, 0, 100);
+  memset(Pcm, 0, sizeof(Pcm));
+  for(k = 0; k < 4 * SPECTRUM_HOP_SIZE / 32; k++)
+  {
+    SPECTRUM_Feed(&Analyzer, Pcm, 32);
+  }
+  SPECTRUM_Process(&Analyzer);
+  printf("overruns after 4 hops processed once: %u\n", (unsigned)Analyzer.Overruns);
+  if(Analyzer.Overruns != 3)
+  {
+    errors++;
+  }
+
+  /* Host time of one hop, the firmware runs the same calls on the Cortex-M4F */
+  SPECTRUM_Init(&Analyzer, 48000, 1, 0, 100);
+  amp[0] = 8192.0;
+  freq[0] = 0.0;
+  Spec_Run(48000, 1, amp, freq, 1, &snap);
+  start = clock();
+  for(k = 0; k < 20000; k++)
+  {
+    Analyzer.Hops++;
+    SPECTRUM_Process(&Analyzer);
+  }
+  seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("%.2f us per hop on host, %.3f %% of the time at 48 KHz\n", 1e6 * seconds / k,
+         100.0 * seconds / k * 48000.0 / SPECTRUM_HOP_SIZE);
+
+  if(errors || tones == 0 || worstRejection < SPEC_MIN_REJECTION)
+  {
+    fail = 1;
+  }
+  printf("%s\n", fail ? "FAIL" : "PASS");
+  return fail;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,651 @@
+/**
+******************************************************************************
+* @file    audio_sim.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Host simulator of the USB audio input class. usbd_core.c,
+*          usbd_ctlreq.c, usbd_ioreq.c and usbd_audio_in.c run unchanged on
+*          top of a fake USBD_LL_* layer (usbd_ll_sim.c). The simulator
+*          enumerates the device, plays the host by completing one
+*          isochronous IN transfer per 1 ms frame, and runs a producer
+*          calling USBD_AUDIO_Data_Transfer with its own drifting, jittery
+*          clock, as the microphone DMA callbacks do on target.
+*
+*          Build (from the repository root):
+*            cc -O2 -IUtilities/USB_AudioSim
+*               -IMiddlewares/ST/STM32_USB_Device_Library/Core/Inc
+*               -IMiddlewares/ST/STM32_USB_Device_Library/Class/AUDIO/Inc
+*               Utilities/USB_AudioSim/audio_sim.c Utilities/USB_AudioSim/usbd_ll_sim.c
+*               Middlewares/ST/STM32_USB_Device_Library/Core/Src/usbd_core.c
+*               Middlewares/ST/STM32_USB_Device_Library/Core/Src/usbd_ctlreq.c
+*               Middlewares/ST/STM32_USB_Device_Library/Core/Src/usbd_ioreq.c
+*               Middlewares/ST/STM32_USB_Device_Library/Class/AUDIO/Src/usbd_audio_in.c
+*               -o audio_sim
+*
+*          Usage:  audio_sim [-f freq] [-c channels] [-t ms] [-d ppm]
+*                            [-j us] [-s seed] [-o trace.csv]
+*
+*          The producer writes a sample counter, so every discontinuity
+*          seen by the host in the IN packets is a glitch: a sample lost
+*          or repeated by the ring buffer. The report gives the packet size
+*          distribution, the glitch counts and the class telemetry read back
+*          with AUDIO_REQ_VENDOR_GET_STATS; the optional trace has the ring
+*          fill of every frame. AUDIO_REQ_VENDOR_GET_SPECTRUM is read back
+*          from a pattern of the size of the analyzer snapshot.
+*
+*          Built with -DAUDIO_PDM_BULK_ENABLE=1 the microphones also stream 
+*          raw PDM on the bulk endpoint, through the double buffer handoff of
+*          the CCA02M1 BSP and BSP_AUDIO_IN_PDMBufferBusy. The host skips the
+*          bulk endpoint a few frames out of SIM_PDM_NAK_PERIOD, so that the
+*          next buffer finds it busy: the frame must be dropped, counted in 
+*          pdm_overruns, and the buffer in flight left untouched.
+*
+*          Exits with 1 when a check of the report fails.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_core.h"
+#include "usbd_desc.h"
+#include "usbd_audio_in.h"
+#include "usbd_ll_sim.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SIM_FRAME_NS              1000000LL
+#define SIM_MAX_PCM               (AUDIO_IN_MAX_FREQ / 1000 * AUDIO_IN_MAX_CHANNELS)
+#define SIM_SPECTRUM_SIZE         144           /* sizeof(SPECTRUM_Snapshot_t) */
+#define SIM_PDM_BYTES_PER_MIC     384           /* 1 ms at a 3072 KHz PDM clock */
+#define SIM_PDM_NAK_PERIOD        250           /* Host stops polling the bulk EP ... */
+#define SIM_PDM_NAK_FRAMES        3             /* ... for this many frames */
+
+/* Private variables ---------------------------------------------------------*/
+static USBD_HandleTypeDef hUsbDevice;
+static uint8_t  ProducerRunning;
+static uint32_t RecordCalls;
+static uint32_t StopCalls;
+static uint32_t RandomState = 1;
+static uint32_t PacketSizes[SIM_EP_MAX_DATA + 1];
+#if AUDIO_PDM_BULK_ENABLE
+static uint16_t PdmBuffer[2][SIM_EP_MAX_DATA / 2];
+static uint16_t *PdmData = PdmBuffer[0];
+static uint16_t *PdmAlt = PdmBuffer[1];
+static uint16_t *PdmReady;
+static uint32_t PdmLength;
+static uint32_t PdmSeq;
+static uint32_t PdmDropped;
+static uint32_t PdmOffset;
+static uint32_t PdmExpected;
+static uint32_t PdmReceived;
+static uint32_t PdmGaps;
+static uint32_t PdmCorrupted;
+#endif
+
+static uint8_t SIM_DeviceDesc[USB_LEN_DEV_DESC] =
+{
+  USB_LEN_DEV_DESC, USB_DESC_TYPE_DEVICE, 0x00, 0x02, 0x00, 0x00, 0x00,
+  USB_MAX_EP0_SIZE, 0x83, 0x04, 0x41, 0x57, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01
+};
+static uint8_t SIM_EmptyStrDesc[2] = { 2, USB_DESC_TYPE_STRING };
+
+/* Private functions ---------------------------------------------------------*/
+static uint8_t *SIM_GetDeviceDesc(USBD_SpeedTypeDef speed, uint16_t *length)
+{
+  *length = sizeof(SIM_DeviceDesc);
+  return SIM_DeviceDesc;
+}
+
+static uint8_t *SIM_GetStrDesc(USBD_SpeedTypeDef speed, uint16_t *length)
+{
+  *length = sizeof(SIM_EmptyStrDesc);
+  return SIM_EmptyStrDesc;
+}
+
+USBD_DescriptorsTypeDef SIM_Desc =
+{
+  SIM_GetDeviceDesc,
+  SIM_GetStrDesc,
+  SIM_GetStrDesc,
+  SIM_GetStrDesc,
+  SIM_GetStrDesc,
+  SIM_GetStrDesc,
+  SIM_GetStrDesc,
+};
+
+static int8_t SIM_Itf_Init(uint32_t AudioFreq, uint32_t BitRes, uint32_t ChnlNbr)
+{
+  return 0;
+}
+
+static int8_t SIM_Itf_DeInit(uint32_t options)
+{
+  ProducerRunning = 0;
+  return 0;
+}
+
+static int8_t SIM_Itf_Record(void)
+{
+  RecordCalls++;
+  ProducerRunning = 1;
+  return 0;
+}
+
+static int8_t SIM_Itf_VolumeCtl(int16_t Volume)
+{
+  return 0;
+}
+
+static int8_t SIM_Itf_MuteCtl(uint8_t cmd)
+{
+  return 0;
+}
+
+static int8_t SIM_Itf_Stop(void)
+{
+  StopCalls++;
+  ProducerRunning = 0;
+  return 0;
+}
+
+static int8_t SIM_Itf_Pause(void)
+{
+  return 0;
+}
+
+static int8_t SIM_Itf_Resume(void)
+{
+  return 0;
+}
+
+static int8_t SIM_Itf_CommandMgr(uint8_t cmd)
+{
+  return 0;
+}
+
+/* Stands for the analyzer snapshot: a pattern longer than one EP0 packet */
+static int8_t SIM_Itf_GetSpectrum(uint8_t *pbuf, uint16_t *length)
+{
+  uint16_t i;
+  
+  *length = MIN(*length, SIM_SPECTRUM_SIZE);
+  for(i = 0; i < *length; i++)
+  {
+    pbuf[i] = (uint8_t)(i ^ 0x5A);
+  }
+  return 0;
+}
+
+static USBD_AUDIO_ItfTypeDef SIM_Itf =
+{
+  SIM_Itf_Init,
+  SIM_Itf_DeInit,
+  SIM_Itf_Record,
+  SIM_Itf_VolumeCtl,
+  SIM_Itf_MuteCtl,
+  SIM_Itf_Stop,
+  SIM_Itf_Pause,
+  SIM_Itf_Resume,
+  SIM_Itf_CommandMgr,
+  SIM_Itf_GetSpectrum,
+};
+
+/**
+* @brief  Uniform pseudo random number in [-1, 1], reproducible from the seed.
+*/
+static double SIM_Random(void)
+{
+  RandomState = RandomState * 1664525UL + 1013904223UL;
+  return ((double)(RandomState >> 8) / (double)(1UL << 23)) - 1.0;
+}
+
+/**
+* @brief  Runs a control transfer the way a host would.
+* @param  setup: 8 byte setup packet
+* @param  data: OUT data stage, or buffer receiving the IN data stage
+* @retval Number of bytes of the IN data stage
+*/
+static uint16_t SIM_Control(uint8_t bmRequest, uint8_t bRequest, uint16_t wValue, uint16_t wIndex,
+                            uint16_t wLength, uint8_t *data)
+{
+  uint8_t setup[8];
+  uint16_t received = 0;
+  
+  setup[0] = bmRequest;
+  setup[1] = bRequest;
+  setup[2] = LOBYTE(wValue);
+  setup[3] = HIBYTE(wValue);
+  setup[4] = LOBYTE(wIndex);
+  setup[5] = HIBYTE(wIndex);
+  setup[6] = LOBYTE(wLength);
+  setup[7] = HIBYTE(wLength);
+  SIM_EpIn[0].pending = 0;
+  SIM_EpOut[0].pending = 0;
+  USBD_LL_SetupStage(&hUsbDevice, setup);
+  
+  if(!(bmRequest & 0x80) && wLength && SIM_EpOut[0].pending && SIM_EpOut[0].pbuf != NULL)
+  {
+    /* OUT data stage */
+    memcpy(SIM_EpOut[0].pbuf, data, MIN(wLength, SIM_EpOut[0].len));
+    SIM_EpOut[0].pending = 0;
+    USBD_LL_DataOutStage(&hUsbDevice, 0, SIM_EpOut[0].pbuf);
+  }
+  
+  /* IN data stage, one max packet at a time as the target controller does */
+  while(SIM_EpIn[0].pending && SIM_EpIn[0].len)
+  {
+    uint16_t chunk = MIN(SIM_EpIn[0].len, USB_MAX_EP0_SIZE);
+    uint8_t *next = SIM_EpIn[0].pbuf + chunk;
+    if((data != NULL) && (received + chunk <= wLength))
+    {
+      memcpy(data + received, SIM_EpIn[0].pbuf, chunk);
+    }
+    received += chunk;
+    SIM_EpIn[0].pending = 0;
+    USBD_LL_DataInStage(&hUsbDevice, 0, next);
+  }
+  return received;
+}
+
+#if AUDIO_PDM_BULK_ENABLE
+/**
+* @brief  Application override of the BSP hook, as on target: a PDM buffer
+*         stays out of the demux while it is being sent on the bulk endpoint.
+*/
+uint8_t BSP_AUDIO_IN_PDMBufferBusy(uint16_t *pbuf)
+{
+  return USBD_AUDIO_PDM_IsBusy(&hUsbDevice, (uint8_t *)pbuf);
+}
+
+/**
+* @brief  Microphone side of the raw PDM stream, one call per millisecond of 
+*         capture: the demux of x_nucleo_cca02m1_audio_f4.c in double buffer
+*         mode writes the current buffer, AUDIO_IN_PDM_Handoff moves to the 
+*         other one unless BSP_AUDIO_IN_PDMBufferBusy reports it in flight,
+*         and the half transfer callback sends BSP_AUDIO_IN_GetPDMBuffer().
+*         Each buffer starts with its sequence number, the rest of it is a 
+*         pattern of that number.
+*/
+static void SIM_PDM_Demux(void)
+{
+  uint16_t *filled = PdmData;
+  uint8_t *bytes = (uint8_t *)filled;
+  uint32_t i;
+  
+  memcpy(bytes, &PdmSeq, sizeof(PdmSeq));
+  for(i = sizeof(PdmSeq); i < PdmLength; i++)
+  {
+    bytes[i] = (uint8_t)(PdmSeq + i);
+  }
+  PdmSeq++;
+  
+  PdmReady = filled;
+  if(BSP_AUDIO_IN_PDMBufferBusy(PdmAlt))
+  {
+    PdmReady = NULL;
+    PdmDropped++;
+  }
+  else
+  {
+    PdmData = PdmAlt;
+    PdmAlt = filled;
+  }
+  USBD_AUDIO_PDM_Transfer(&hUsbDevice, (uint8_t *)PdmReady, (uint16_t)PdmLength);
+}
+
+/**
+* @brief  Host side of the raw PDM stream in one USB frame: the bulk endpoint
+*         gets what the isochronous packet leaves of the frame budget, unless
+*         the host is not polling it. A buffer completes once all of it went
+*         on the bus; it must then still hold what was loaded when it was 
+*         queued, and its sequence number tells the frames dropped before it.
+* @param  budget: bulk bytes available in this frame, 0 when not polled
+*/
+static void SIM_PDM_Host(uint32_t budget)
+{
+  SIM_EndpointTypeDef *ep = &SIM_EpIn[AUDIO_PDM_EP & 0x0F];
+  uint32_t seq;
+  
+  if(!ep->pending)
+  {
+    return;
+  }
+  PdmOffset += MIN(budget, ep->len - PdmOffset);
+  if(PdmOffset < ep->len)
+  {
+    return;
+  }
+  if(memcmp(ep->pbuf, ep->data, ep->len) != 0)
+  {
+    PdmCorrupted++;
+  }
+  memcpy(&seq, ep->data, sizeof(seq));
+  PdmGaps += seq - PdmExpected;
+  PdmExpected = seq + 1;
+  PdmReceived++;
+  PdmOffset = 0;
+  ep->pending = 0;
+  USBD_LL_DataInStage(&hUsbDevice, AUDIO_PDM_EP & 0x7F, ep->pbuf);
+}
+#endif
+
+static void Usage(void)
+{
+  fprintf(stderr,
+          "usage: audio_sim [-f freq] [-c channels] [-t ms] [-d ppm] [-j us] [-s seed] [-o trace.csv]\n"
+          "  -f  sampling frequency in Hz (default 48000)\n"
+          "  -c  channels (default 2)\n"
+          "  -t  simulated time in ms (default 10000)\n"
+          "  -d  producer period error against the USB SOF in ppm, positive is slower (default 0)\n"
+          "  -j  producer jitter, uniform +/- us around each 1 ms period (default 0)\n"
+          "  -s  random seed (default 1)\n"
+          "  -o  per frame trace: ms, ring fill in bytes, IN packet bytes\n");
+}
+
+int main(int argc, char *argv[])
+{
+  uint32_t freq = 48000;
+  uint32_t channels = 2;
+  uint32_t duration = 10000;
+  double ppm = 0.0;
+  double jitter_us = 0.0;
+  FILE *trace = NULL;
+  int arg;
+  
+  uint16_t pcm_per_call;
+  int16_t pcm[SIM_MAX_PCM];
+  uint16_t counter = 1;
+  uint16_t expected = 0;
+  int synced = 0;
+  int64_t now = 0;
+  int64_t next_frame = SIM_FRAME_NS;
+  int64_t next_call;
+  uint64_t calls = 0;
+  double period_ns;
+  uint32_t frames = 0;
+  uint32_t glitches = 0;
+  uint32_t silent_frames = 0;
+  uint32_t busy_calls = 0;
+  uint16_t cfg_len;
+  uint8_t cfg[512];
+  USBD_AUDIO_StatsTypeDef stats;
+  uint8_t spectrum[AUDIO_IN_SPECTRUM_MAX_SIZE];
+  uint16_t spectrum_len;
+  uint8_t status_ok;
+  uint8_t stall_ok;
+  uint8_t spectrum_ok;
+  uint8_t pdm_ok = 1;
+  uint32_t i;
+#if AUDIO_PDM_BULK_ENABLE
+  uint8_t pdm_ep = 0;
+  uint32_t isoc_len;
+#endif
+  
+  for(arg = 1; arg < argc; arg++)
+  {
+    if(arg + 1 >= argc || argv[arg][0] != '-')
+    {
+      Usage();
+      return 1;
+    }
+    switch(argv[arg][1])
+    {
+    case 'f': freq = (uint32_t)atoi(argv[++arg]); break;
+    case 'c': channels = (uint32_t)atoi(argv[++arg]); break;
+    case 't': duration = (uint32_t)atoi(argv[++arg]); break;
+    case 'd': ppm = atof(argv[++arg]); break;
+    case 'j': jitter_us = atof(argv[++arg]); break;
+    case 's': RandomState = (uint32_t)atoi(argv[++arg]); break;
+    case 'o':
+      trace = fopen(argv[++arg], "w");
+      if(trace == NULL)
+      {
+        perror(argv[arg]);
+        return 1;
+      }
+      fprintf(trace, "ms,fill,packet\n");
+      break;
+    default:
+      Usage();
+      return 1;
+    }
+  }
+  
+  /* Device side, as the application does at start up */
+  USBD_Init(&hUsbDevice, &SIM_Desc, 0);
+  USBD_RegisterClass(&hUsbDevice, &USBD_AUDIO);
+  USBD_AUDIO_RegisterInterface(&hUsbDevice, &SIM_Itf);
+  if(USBD_AUDIO_Init_Microphone_Descriptor(&hUsbDevice, freq, (uint8_t)channels) != USBD_OK)
+  {
+    fprintf(stderr, "%u Hz x %u channels rejected by the bandwidth planner\n", (unsigned)freq, (unsigned)channels);
+    return 1;
+  }
+  USBD_Start(&hUsbDevice);
+  
+  /* Host side enumeration */
+  USBD_LL_Reset(&hUsbDevice);
+  USBD_LL_SetSpeed(&hUsbDevice, USBD_SPEED_FULL);
+  SIM_Control(0x00, USB_REQ_SET_ADDRESS, 1, 0, 0, NULL);
+  cfg_len = SIM_Control(0x80, USB_REQ_GET_DESCRIPTOR, USB_DESC_TYPE_CONFIGURATION << 8, 0, sizeof(cfg), cfg);
+  SIM_Control(0x00, USB_REQ_SET_CONFIGURATION, 1, 0, 0, NULL);
+  SIM_Control(0x01, USB_REQ_SET_INTERFACE, 1, 1, 0, NULL);
+  if(hUsbDevice.dev_state != USBD_STATE_CONFIGURED)
+  {
+    fprintf(stderr, "enumeration failed\n");
+    return 1;
+  }
+  printf("configuration descriptor: %u bytes (wTotalLength %u)\n", cfg_len, cfg[2] | (cfg[3] << 8));
+#if AUDIO_PDM_BULK_ENABLE
+  for(i = 0; i + 7 <= cfg_len && cfg[i] != 0; i += cfg[i])
+  {
+    if(cfg[i + 1] == USB_DESC_TYPE_ENDPOINT && cfg[i + 2] == AUDIO_PDM_EP &&
+       cfg[i + 3] == USBD_EP_TYPE_BULK && (cfg[i + 4] | (cfg[i + 5] << 8)) == AUDIO_PDM_BULK_PACKET)
+    {
+      pdm_ep = 1;
+    }
+  }
+  PdmLength = channels * SIM_PDM_BYTES_PER_MIC;
+  if(PdmLength > SIM_EP_MAX_DATA || USBD_AUDIO_PDM_CheckBandwidth(PdmLength) != USBD_OK)
+  {
+    printf("raw PDM: %u bytes per ms rejected by the bandwidth check, not streamed\n", (unsigned)PdmLength);
+    PdmLength = 0;
+  }
+  printf("raw PDM bulk endpoint 0x%02X in the descriptor: %s\n", AUDIO_PDM_EP, pdm_ep ? "yes" : "MISSING");
+#endif
+  
+  pcm_per_call = (uint16_t)(freq / 1000 * channels);
+  period_ns = 1e6 * (1.0 + ppm * 1e-6);
+  next_call = (int64_t)period_ns;
+  
+  while(frames < duration)
+  {
+    if(ProducerRunning && next_call < next_frame)
+    {
+      /* Producer: one millisecond of PCM per call, from its own clock */
+      now = next_call;
+      for(i = 0; i < pcm_per_call; i += channels)
+      {
+        uint32_t ch;
+        for(ch = 0; ch < channels; ch++)
+        {
+          pcm[i + ch] = (int16_t)counter;
+        }
+        counter = (counter == 0xFFFF) ? 1 : counter + 1;
+      }
+      if(USBD_AUDIO_Data_Transfer(&hUsbDevice, pcm, pcm_per_call) != USBD_OK)
+      {
+        busy_calls++;
+      }
+#if AUDIO_PDM_BULK_ENABLE
+      if(PdmLength)
+      {
+        SIM_PDM_Demux();
+      }
+#endif
+      calls++;
+      next_call = (int64_t)(period_ns * (calls + 1) + jitter_us * 1000.0 * SIM_Random());
+      continue;
+    }
+    
+    /* USB frame: SOF, then the packet queued in the previous frame goes on
+       the bus and its completion queues the next one */
+    now = next_frame;
+    next_frame += SIM_FRAME_NS;
+    if(!ProducerRunning && next_call < now)
+    {
+      /* Producer restarts aligned on its own clock */
+      calls = (uint64_t)(now / period_ns);
+      next_call = (int64_t)(period_ns * (calls + 1));
+    }
+    frames++;
+    USBD_LL_SOF(&hUsbDevice);
+#if AUDIO_PDM_BULK_ENABLE
+    isoc_len = SIM_EpIn[AUDIO_IN_EP & 0x0F].pending ? SIM_EpIn[AUDIO_IN_EP & 0x0F].len : 0;
+    SIM_PDM_Host((frames % SIM_PDM_NAK_PERIOD) < SIM_PDM_NAK_FRAMES ? 0 : AUDIO_PDM_FRAME_BUDGET - isoc_len);
+#endif
+    if(SIM_EpIn[AUDIO_IN_EP & 0x0F].pending)
+    {
+      SIM_EndpointTypeDef *ep = &SIM_EpIn[AUDIO_IN_EP & 0x0F];
+      USBD_AUDIO_HandleTypeDef *haudio = (USBD_AUDIO_HandleTypeDef *)hUsbDevice.pClassData;
+      uint16_t len = ep->len;
+      int16_t *samples = (int16_t *)ep->data;
+      uint16_t n = len / 2;
+      
+      PacketSizes[MIN(len, SIM_EP_MAX_DATA)]++;
+      if(n && samples[0] == 0)
+      {
+        if(synced)
+        {
+          silent_frames++;
+        }
+      }
+      else
+      {
+        for(i = 0; i < n; i += channels)
+        {
+          uint16_t v = (uint16_t)samples[i];
+          if(synced && v != expected)
+          {
+            glitches++;
+          }
+          synced = 1;
+          expected = (v == 0xFFFF) ? 1 : v + 1;
+        }
+      }
+      if(trace != NULL)
+      {
+        uint32_t fill = 0;
+        if(haudio->state == STATE_USB_BUFFER_WRITE_STARTED && haudio->buffer_length)
+        {
+          fill = (haudio->wr_ptr + haudio->buffer_length - (haudio->rd_ptr % haudio->buffer_length)) % haudio->buffer_length;
+        }
+        fprintf(trace, "%u,%u,%u\n", (unsigned)frames, (unsigned)fill, (unsigned)len);
+      }
+      ep->pending = 0;
+      USBD_LL_DataInStage(&hUsbDevice, AUDIO_IN_EP & 0x7F, ep->pbuf);
+    }
+  }
+  (void)now;
+#if AUDIO_PDM_BULK_ENABLE
+  /* The host drains the buffer still in flight */
+  SIM_PDM_Host(AUDIO_PDM_FRAME_BUDGET);
+#endif
+  
+  printf("simulated %u frames, %u Hz x %u channels, drift %+.1f ppm, jitter +/-%.0f us\n",
+         (unsigned)frames, (unsigned)freq, (unsigned)channels, ppm, jitter_us);
+  printf("producer calls %llu (%u refused), Record %u, Stop %u\n",
+         (unsigned long long)calls, (unsigned)busy_calls, (unsigned)RecordCalls, (unsigned)StopCalls);
+  printf("glitches %u, silent frames while streaming %u\n", (unsigned)glitches, (unsigned)silent_frames);
+  printf("packet size distribution (bytes: count):\n");
+  for(i = 0; i <= SIM_EP_MAX_DATA; i++)
+  {
+    if(PacketSizes[i])
+    {
+      printf("  %4u: %u\n", (unsigned)i, (unsigned)PacketSizes[i]);
+    }
+  }
+  
+  memset(&stats, 0, sizeof(stats));
+  SIM_Control(0xC1, AUDIO_REQ_VENDOR_GET_STATS, 0, 1, sizeof(stats), (uint8_t *)&stats);
+  printf("class telemetry: packets %u silent %u short %u long %u resets %u timeouts %u\n",
+         (unsigned)stats.packets, (unsigned)stats.silent_packets, (unsigned)stats.short_packets,
+         (unsigned)stats.long_packets, (unsigned)stats.resets, (unsigned)stats.timeouts);
+  printf("ring fill min %u max %u bytes, histogram (%u bytes per bin):",
+         (unsigned)stats.fill_min, (unsigned)stats.fill_max, 1u << stats.fill_bin_shift);
+  for(i = 0; i < AUDIO_IN_FILL_HIST_BINS; i++)
+  {
+    printf(" %u", (unsigned)stats.fill_histogram[i]);
+  }
+  printf("\n");
+#if AUDIO_PDM_BULK_ENABLE
+  printf("raw PDM: %u buffers of %u bytes sent, %u dropped by the demux, telemetry frames %u overruns %u\n",
+         (unsigned)PdmReceived, (unsigned)PdmLength, (unsigned)PdmDropped,
+         (unsigned)stats.pdm_frames, (unsigned)stats.pdm_overruns);
+  pdm_ok = (PdmGaps + (PdmSeq - PdmExpected) == PdmDropped) && 
+           (stats.pdm_overruns == PdmDropped) && (stats.pdm_frames == PdmReceived);
+  printf("raw PDM: in-flight buffers %s, sequence %s\n",
+         PdmCorrupted ? "OVERWRITTEN" : "intact", pdm_ok ? "consistent" : "INCONSISTENT");
+  pdm_ok = pdm_ok && pdm_ep && !PdmCorrupted;
+#endif
+  
+  spectrum_len = SIM_Control(0xC1, AUDIO_REQ_VENDOR_GET_SPECTRUM, 0, 1, sizeof(spectrum), spectrum);
+  for(i = 0; i < spectrum_len && spectrum[i] == (uint8_t)(i ^ 0x5A); i++)
+  {
+  }
+  spectrum_ok = (spectrum_len == SIM_SPECTRUM_SIZE) && (i == spectrum_len);
+  printf("spectrum request: %u bytes, %s\n", (unsigned)spectrum_len, spectrum_ok ? "intact" : "CORRUPTED");
+  
+  /* Requests without data stage: a status stage, or a stall and nothing else */
+  SIM_EpIn[0].stalled = 0;
+  SIM_Control(0x41, AUDIO_REQ_VENDOR_CLEAR_STATS, 0, 1, 0, NULL);
+  status_ok = !SIM_EpIn[0].stalled && SIM_EpIn[0].pending && (SIM_EpIn[0].len == 0);
+  SIM_EpIn[0].stalled = 0;
+  SIM_Control(0xC1, AUDIO_REQ_VENDOR_GET_STATS, 0, 1, 0, NULL);
+  stall_ok = SIM_EpIn[0].stalled && !SIM_EpIn[0].pending;
+  SIM_EpIn[0].stalled = 0;
+  SIM_Control(0xC1, AUDIO_REQ_VENDOR_GET_SPECTRUM, 0, 1, 0, NULL);
+  stall_ok = stall_ok && SIM_EpIn[0].stalled && !SIM_EpIn[0].pending;
+  printf("CLEAR_STATS: %s, GET_STATS and GET_SPECTRUM with wLength 0: %s\n",
+         status_ok ? "status stage" : "WRONG HANDSHAKE",
+         stall_ok ? "stalled" : "WRONG HANDSHAKE");
+  
+  if(trace != NULL)
+  {
+    fclose(trace);
+  }
+  return (spectrum_ok && status_ok && stall_ok && pdm_ok) ? 0 : 1;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
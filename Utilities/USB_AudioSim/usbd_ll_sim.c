@@ -0,0 +1,167 @@
+/**
+******************************************************************************
+* @file    usbd_ll_sim.c
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Fake USBD_LL_* layer of the USB audio class simulator.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_ll_sim.h"
+
+/* Exported variables --------------------------------------------------------*/
+SIM_EndpointTypeDef SIM_EpIn[SIM_EP_NUM];
+SIM_EndpointTypeDef SIM_EpOut[SIM_EP_NUM];
+
+/* Private functions ---------------------------------------------------------*/
+static SIM_EndpointTypeDef *SIM_GetEP(uint8_t ep_addr)
+{
+  if(ep_addr & 0x80)
+  {
+    return &SIM_EpIn[ep_addr & 0x0F];
+  }
+  return &SIM_EpOut[ep_addr & 0x0F];
+}
+
+/* Exported functions --------------------------------------------------------*/
+USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
+{
+  memset(SIM_EpIn, 0, sizeof(SIM_EpIn));
+  memset(SIM_EpOut, 0, sizeof(SIM_EpOut));
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_DeInit(USBD_HandleTypeDef *pdev)
+{
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Start(USBD_HandleTypeDef *pdev)
+{
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Stop(USBD_HandleTypeDef *pdev)
+{
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps)
+{
+  SIM_EndpointTypeDef *ep = SIM_GetEP(ep_addr);
+  
+  ep->opened = 1;
+  ep->type = ep_type;
+  ep->mps = ep_mps;
+  ep->pending = 0;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  SIM_EndpointTypeDef *ep = SIM_GetEP(ep_addr);
+  
+  ep->opened = 0;
+  ep->pending = 0;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  SIM_GetEP(ep_addr)->pending = 0;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_StallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  SIM_GetEP(ep_addr)->stalled = 1;
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_ClearStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  SIM_GetEP(ep_addr)->stalled = 0;
+  return USBD_OK;
+}
+
+uint8_t USBD_LL_IsStallEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return SIM_GetEP(ep_addr)->stalled;
+}
+
+USBD_StatusTypeDef USBD_LL_SetUSBAddress(USBD_HandleTypeDef *pdev, uint8_t dev_addr)
+{
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  SIM_EndpointTypeDef *ep = &SIM_EpIn[ep_addr & 0x0F];
+  
+  ep->pbuf = pbuf;
+  ep->len = size;
+  ep->pending = 1;
+  /* The FIFO is loaded when the transfer is queued: later writes to the 
+     buffer by the stack do not change what goes on the bus */
+  if((pbuf != NULL) && (size <= SIM_EP_MAX_DATA))
+  {
+    memcpy(ep->data, pbuf, size);
+  }
+  return USBD_OK;
+}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size)
+{
+  SIM_EndpointTypeDef *ep = &SIM_EpOut[ep_addr & 0x0F];
+  
+  ep->pbuf = pbuf;
+  ep->len = size;
+  ep->pending = 1;
+  return USBD_OK;
+}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
+{
+  return SIM_EpOut[ep_addr & 0x0F].len;
+}
+
+void USBD_LL_Delay(uint32_t Delay)
+{
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,76 @@
+/**
+******************************************************************************
+* @file    usbd_ll_sim.h
+* @author  Central Labs
+* @version V1.0.0
+* @date    19-October-2026
+* @brief   Fake USBD_LL_* layer of the USB audio class simulator: endpoints
+*          only record what the stack queues, the simulator plays the host.
+*******************************************************************************
+* @attention
+*
+* <h2><center>&copy; COPYRIGHT(c) 2014 STMicroelectronics</center></h2>
+*
+* Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
+* You may not use this file except in compliance with the License.
+* You may obtain a copy of the License at:
+*
+*        http://www.st.com/software_license_agreement_liberty_v2
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*   1. Redistributions of source code must retain the above copyright notice,
+*      this list of conditions and the following disclaimer.
+*   2. Redistributions in binary form must reproduce the above copyright notice,
+*      this list of conditions and the following disclaimer in the documentation
+*      and/or other materials provided with the distribution.
+*   3. Neither the name of STMicroelectronics nor the names of its contributors
+*      may be used to endorse or promote products derived from this software
+*      without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+********************************************************************************
+*/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_LL_SIM_H
+#define __USBD_LL_SIM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_core.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SIM_EP_NUM                16
+#define SIM_EP_MAX_DATA           1024
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint8_t   opened;
+  uint8_t   type;
+  uint16_t  mps;
+  uint8_t   stalled;
+  uint8_t   pending;                 /*!< A transfer is queued on the endpoint */
+  uint8_t  *pbuf;                    /*!< Buffer passed by the stack */
+  uint16_t  len;                     /*!< Length passed by the stack */
+  uint8_t   data[SIM_EP_MAX_DATA];   /*!< IN data as loaded in the FIFO at queue time */
+}
+SIM_EndpointTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern SIM_EndpointTypeDef SIM_EpIn[SIM_EP_NUM];
+extern SIM_EndpointTypeDef SIM_EpOut[SIM_EP_NUM];
+
+#endif /* __USBD_LL_SIM_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/